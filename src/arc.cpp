@@ -12,36 +12,53 @@ using namespace std;
 #include <vector>
 #include <stdlib.h> // May 26 2013
 #include "global.h"
+#include "node.h"
 #include "arc.h"
+#include "network.h"
+#include "model.h"
 #include <math.h>
-#include <algorithm>    // std::sort Feedstock Cost curve - Mar 04 2014
 
 // Contructors and destructor for the Arc class
 Arc::Arc() :
-	Properties(ArcDefault),
-	Energy2Trans(false),
-	Trans2Energy(0) {}
+	Codes(ArcSchema.DefaultCodes()),
+	Values(ArcSchema.DefaultValues()),
+	Trans2Energy(-1),
+	Trans2EnergyScale(1),
+	CurveWidth(0),
+	CurveCost(0),
+	CostCurve(false),
+	Energy2Trans(false) {}
 
 Arc::Arc(const Arc& rhs) :
-	Properties(rhs.GetVecStr("Properties")),
-	Energy2Trans(rhs.GetBool("Energy2Trans")),
-	Trans2Energy(rhs.GetVecStr("Trans2Energy")) {}
+	Codes(rhs.Codes),
+	Values(rhs.Values),
+	Trans2Energy(rhs.Trans2Energy),
+	Trans2EnergyScale(rhs.Trans2EnergyScale),
+	CurveWidth(rhs.CurveWidth),
+	CurveCost(rhs.CurveCost),
+	CostCurve(rhs.CostCurve),
+	Energy2Trans(rhs.Energy2Trans) {}
 
 // This constructor creates an arc going in the opposite direction
 Arc::Arc(const Arc& rhs, const bool reverse) :
-	Properties(rhs.GetVecStr("Properties")),
-	Energy2Trans(rhs.GetBool("Energy2Trans")),
-	Trans2Energy(rhs.GetVecStr("Trans2Energy")) {
+	Codes(rhs.Codes),
+	Values(rhs.Values),
+	Trans2Energy(rhs.Trans2Energy),
+	Trans2EnergyScale(rhs.Trans2EnergyScale),
+	CurveWidth(rhs.CurveWidth),
+	CurveCost(rhs.CurveCost),
+	CostCurve(rhs.CostCurve),
+	Energy2Trans(rhs.Energy2Trans) {
 		if (reverse) {
 			if (!isTransport()) {
-				string temp = Get("To");
-				Set("To", Get("From"));
-				Set("From", temp);
+				string temp = Get(ASlot.To);
+				Set(ASlot.To, Get(ASlot.From));
+				Set(ASlot.From, temp);
 			} else {
-				string temp = Get("From");
-				Set("From", temp.substr(0,2) + temp.substr(4,2) + temp.substr(2,2));
-				temp = Get("To");
-				Set("To", temp.substr(0,2) + temp.substr(4,2) + temp.substr(2,2));
+				string temp = Get(ASlot.From);
+				Set(ASlot.From, temp.substr(0,2) + temp.substr(4,2) + temp.substr(2,2));
+				temp = Get(ASlot.To);
+				Set(ASlot.To, temp.substr(0,2) + temp.substr(4,2) + temp.substr(2,2));
 			}
 		}
 	}
@@ -49,36 +66,85 @@ Arc::Arc(const Arc& rhs, const bool reverse) :
 Arc::~Arc() {}
 
 Arc& Arc::operator=(const Arc& rhs) {
-	Properties = rhs.GetVecStr("Properties");
-	Energy2Trans = rhs.GetBool("Energy2Trans");
-	Trans2Energy = rhs.GetVecStr("Trans2Energy");
+	Codes = rhs.Codes;
+	Values = rhs.Values;
+	Trans2Energy = rhs.Trans2Energy;
+	Trans2EnergyScale = rhs.Trans2EnergyScale;
+	CurveWidth = rhs.CurveWidth;
+	CurveCost = rhs.CurveCost;
+	CostCurve = rhs.CostCurve;
+	Energy2Trans = rhs.Energy2Trans;
 	return *this;
 }
 
+// Read a string code
+const string& Arc::Get(const int slot) const {
+	return Codes[slot];
+}
+
+// Read a numeric value as stored (NaN if it's missing)
+double Arc::GetValue(const int slot) const {
+	return Values[slot];
+}
+
+// Read a numeric value (zero if it's missing)
+double Arc::GetDouble(const int slot) const {
+	return (Values[slot] == Values[slot]) ? Values[slot] : 0;
+}
+
+// Read a numeric value in string format
+string Arc::GetText(const int slot) const {
+	return Num2Str(Values[slot]);
+}
+
+// Is the numeric value given? (i.e., not 'X')
+bool Arc::Has(const int slot) const {
+	return Values[slot] == Values[slot];
+}
+
+// Modify a string code
+void Arc::Set(const int slot, const string& input) {
+	Codes[slot] = input;
+}
+
+// Modify a numeric value
+void Arc::SetDouble(const int slot, const double input) {
+	Values[slot] = input;
+}
+
+// Multiply a stored value by 'value'
+void Arc::Multiply(const int slot, const double value) {
+	if ((Values[slot] == Values[slot]) && (Values[slot] != 0))
+		Values[slot] = Values[slot] * value;
+}
+
 // Read a property in string format
 string Arc::Get(const string& selector) const {
 	string temp_output;
-	int index = FindArcSelector(selector);
-	if (index >= 0) temp_output = Properties[index];
-	else {
+	int index = ArcSchema.Find(selector);
+	if (index >= 0) {
+		if (ArcSchema.isNumeric(index))
+			temp_output = GetText(ArcSchema.Slot(index));
+		else
+			temp_output = Codes[ArcSchema.Slot(index)];
+	} else {
 		temp_output = "ERROR";
 		printError("arcread", selector);
 	}
 	return temp_output;
 }
 
-// Read the year from the step
-string Arc::GetYear() const {
-	int temp = Str2Step(Get("FromStep"))[0];
-	return SName.substr(0,1) + ToString<int>(temp);
-}
-
-// Read a property and convert to double
-double Arc::GetDouble(const string& selector) const {
-	double output;
-	output = (Get(selector) != "X") ? atof(Get(selector).c_str()) : 0;
-	return output;
-}
+// Modify a propery
+void Arc::Set(const string& selector, const string& input){
+	int index = ArcSchema.Find(selector);
+	if (index >= 0) {
+		if (ArcSchema.isNumeric(index))
+			Values[ArcSchema.Slot(index)] = Str2Num(input);
+		else
+			Codes[ArcSchema.Slot(index)] = input;
+	} else
+		printError("arcwrite", selector);
+};
 
 // Read a boolean property
 bool Arc::GetBool(const string& selector) const {
@@ -89,27 +155,6 @@ bool Arc::GetBool(const string& selector) const {
 	return temp_output;
 };
 
-// Read an entire vector of string properties
-vector<string> Arc::GetVecStr(const string& selector) const {
-	vector<string> temp_output;
-	if (selector == "Properties")
-		temp_output = Properties;
-	else if (selector == "Trans2Energy")
-		temp_output = Trans2Energy;
-	else
-		printError("arcread", selector);
-	return temp_output;
-};
-
-// Modify a propery
-void Arc::Set(const string& selector, const string& input){
-	int index = FindArcSelector(selector);
-	if (index >= 0)
-		Properties[index] = input;
-	else
-		printError("arcwrite", selector);
-};
-
 // Modify a boolean property
 void Arc::Set(const string& selector, const bool input){
 	if (selector == "Energy2Trans")
@@ -118,104 +163,253 @@ void Arc::Set(const string& selector, const bool input){
 		printError("arcwrite", selector);
 };
 
-// Add a new line to the Trans2Energy vector, where the consumption of energy
-// for a transportation link is stored
-void Arc::Add(const string& selector, const string& input) {
-	if (selector == "Trans2Energy") Trans2Energy.push_back(input);
-	else printError("arcwrite", selector);
-};
+// Energy consumed by a transportation link (see 'ArcTable')
+void Arc::SetTrans2Energy(const int coupling) {
+	Trans2Energy = coupling;
+}
+
+int Arc::GetTrans2Energy() const {
+	return Trans2Energy;
+}
 
-// Multiply a value or a vector by a given value
+double Arc::GetTrans2EnergyScale() const {
+	return Trans2EnergyScale;
+}
+
+// Segments of the cost curve in the step of the arc (see 'CostCurveData')
+void Arc::SetCostCurve(const vector<double>& width, const vector<double>& cost) {
+	CurveWidth = width;
+	CurveCost = cost;
+	CostCurve = true;
+}
+
+const vector<double>& Arc::GetCurveWidth() const {
+	return CurveWidth;
+}
+
+const vector<double>& Arc::GetCurveCost() const {
+	return CurveCost;
+}
+
+// Multiply a vector by a given value
 void Arc::Multiply(const string& selector, const double value) {
-	int index = FindArcSelector(selector);
 	if (selector == "Trans2Energy") {
 		// Adjust values
-		for (unsigned int i = 1; i < Trans2Energy.size(); i += 2) {
-			Trans2Energy[i] = ToString<double>(value * atof(Trans2Energy[i].c_str()));
-		}
-	} else if (index >= 0) {
-		double actual = GetDouble(selector);
-		if (actual != 0) {
-			Set(selector, ToString<double>(actual * value));
-		}
-	} else printError("arcwrite", selector);
+		Trans2EnergyScale = Trans2EnergyScale * value;
+	} else {
+		int index = ArcSchema.Find(selector);
+		if ((index >= 0) && ArcSchema.isNumeric(index))
+			Multiply(ArcSchema.Slot(index), value);
+		else
+			printError("arcwrite", selector);
+	}
 };
 
 
-// ****** MPS output functions ******
-string Arc::ArcUbNames() const {
-	string temp_output = "";
+// Get what time the arc belongs to (i.e., year)
+int Arc::Time() const {
+	return Str2Step(Get(ASlot.FromStep))[0];
+}
+
+
+// ****** Boolean functions ******
+
+// Is it the first arc in a year?
+bool Arc::isFirstinYear() const {
+	bool output = true;
+	Step step1, step2, stepguide;
+	step1 = Str2Step(Get(ASlot.FromStep));
+	step2 = Str2Step(Get(ASlot.ToStep));
+	stepguide = ((step1 > step2) || isStorage()) ? step1 : step2;
+	for (unsigned int k = Get(ASlot.InvStep).size(); k < SName.size(); k++) {
+		output = output && ((stepguide[k]==0) || (stepguide[k]==1));
+	}
+	return output;
+}
+
+// Is investment allowed for current arc?
+bool Arc::InvArc() const {
+	// Inv. cost is declared and it's the first arc in each investment period
+	bool output = Has(ASlot.InvCost) && isFirstinYear() && (GetValue(ASlot.InvMax) != 0);
+	// It's the first if the arc is bidirectional
+	output = output && ((!isTransport() && (!isBidirect() || isFirstBidirect())) || isFirstTransport());
+	// Technology is available
+	output = output && (Str2Step(Get(ASlot.FromStep)) >= Str2Step(Get(ASlot.InvStart)));
+	return output;
+}
+
+// Is efficiency inverted? (Used with electrical generators)
+bool Arc::InvertEff() const {
+	return ((Get(ASlot.InvertEff) == "Y") || (Get(ASlot.InvertEff) == "y"));
+}
+
+// Is the arc part of DC flow constraints?
+bool Arc::isDCflow() const {
+	bool output = (Get(ASlot.From).substr(0,2) == DCCode) && (Get(ASlot.To).substr(0,2) == DCCode);
+	return output && useDCflow;
+}
+
+// Does the arc have a cost curve? Mar 04 2014
+bool Arc::isCostCurve() const {
+	return CostCurve;
+}
+
+// Is it a storage arc?
+bool Arc::isStorage() const {
+	return (Get(ASlot.From).substr(1,1) == StorageCode) && (Get(ASlot.From) == Get(ASlot.To));
+}
+
+// Is the arc bidirectional? (excludes storage nodes)
+bool Arc::isBidirect() const {
+	bool output = Get(ASlot.From).substr(0,2) == Get(ASlot.To).substr(0,2);
+//	output = output && !isDCflow() && !isStorage();
+	output = output && !isStorage();// Feb 21 2013-DCPF
+	return output;
+}
+
+// Is the arc bidirectional and and the first alphabetically?
+bool Arc::isFirstBidirect() const {
+	return isBidirect() && (Get(ASlot.From) < Get(ASlot.To));
+}
+
+// Is is a transportation arc?
+bool Arc::isTransport() const {
+	return (Get(ASlot.From).size() > 4) && (Get(ASlot.To).size() > 4);
+}
+
+// Is it a transportation arc and the first alphabetically?
+bool Arc::isFirstTransport() const {
+	return isTransport() && (Get(ASlot.From).substr(2,2) < Get(ASlot.From).substr(4,2));
+}
+
+
+// Contructor for the ArcRow class
+ArcRow::ArcRow(const ArcTable& mytable, const int myrow) :
+	table(&mytable),
+	row(myrow) {}
+
+// Read a string code
+const string& ArcRow::Get(const int slot) const {
+	return table->pool[table->codes[slot][row]];
+}
+
+// Read a numeric value as stored (NaN if it's missing)
+double ArcRow::GetValue(const int slot) const {
+	return table->values[slot][row];
+}
+
+// Read a numeric value (zero if it's missing)
+double ArcRow::GetDouble(const int slot) const {
+	double value = table->values[slot][row];
+	return (value == value) ? value : 0;
+}
+
+// Read a numeric value in string format
+string ArcRow::GetText(const int slot) const {
+	return Num2Str(table->values[slot][row]);
+}
+
+// Is the numeric value given? (i.e., not 'X')
+bool ArcRow::Has(const int slot) const {
+	double value = table->values[slot][row];
+	return value == value;
+}
+
+// Read a property in string format
+string ArcRow::Get(const string& selector) const {
+	string temp_output;
+	int index = ArcSchema.Find(selector);
+	if (index >= 0) {
+		if (ArcSchema.isNumeric(index))
+			temp_output = GetText(ArcSchema.Slot(index));
+		else
+			temp_output = Get(ArcSchema.Slot(index));
+	} else {
+		temp_output = "ERROR";
+		printError("arcread", selector);
+	}
+	return temp_output;
+}
+
+// Read the year from the step
+string ArcRow::GetYear() const {
+	return SName.substr(0,1) + ToString<int>(table->year[row]);
+}
+
+// Get what time the arc belongs to (i.e., year)
+int ArcRow::Time() const {
+	return table->year[row];
+}
+
+
+// ****** Model output functions ******
+void ArcRow::ArcUbNames(ModelBuilder& model) const {
 	// Create upper bound constraint
-	if (isTransport()  && Get("TransInfr") == "") {
+	if (isTransport()  && Get(ASlot.TransInfr) == "") {
 		// Transportation arc
-		if (Get("OpMax") != "Inf") {
-			temp_output += " L ub" + Get("Code") + "\n";
+		if (!isinf(GetValue(ASlot.OpMax))) {
+			model.AddRow(Time(), 'L', "ub" + Get(ASlot.Code));
 		} else {
-			temp_output += " N ub" + Get("Code") + "\n";
+			model.AddRow(Time(), 'N', "ub" + Get(ASlot.Code));
 		}
 	} else if (!isTransport()) {
 		// Energy arc
-		if (Get("OpMax") != "Inf") {
-			temp_output += " L ub" + Get("Code") + "\n";
+		if (!isinf(GetValue(ASlot.OpMax))) {
+			model.AddRow(Time(), 'L', "ub" + Get(ASlot.Code));
 		}
 
 		// Cost Curve March 04 2014 - Venkat
-		if (Get("OpMaxc1") != "Inf") { 
-			temp_output += " E cc" + Get("Code") + "\n";
+		if (isCostCurve()) { 
+			model.AddRow(Time(), 'E', "cc" + Get(ASlot.Code));
 		}
 	}
-	return temp_output;
 }
 
-string Arc::ArcCapNames() const {
-	string temp_output = "";
+void ArcRow::ArcCapNames(ModelBuilder& model) const {
 	// Create capacity-investment constraint for arcs with valid investment
-	if (isFirstinYear() && isTransport()  && Get("TransInfr") == "") {
+	if (isFirstinYear() && isTransport()  && Get(ASlot.TransInfr) == "") {
 		// Transportation arc
-		if (Get("OpMax") != "Inf") {
-			temp_output += " E inv2cap" + Get("Code") + "\n";
+		if (!isinf(GetValue(ASlot.OpMax))) {
+			model.AddRow(0, 'E', "inv2cap" + Get(ASlot.Code));
 		}
 	} else if (isFirstinYear() && !isTransport()) {
 		// Energy arc
-		if (Get("OpMax") != "Inf") {
-			temp_output += " E inv2cap" + Get("Code") + "\n";
+		if (!isinf(GetValue(ASlot.OpMax))) {
+			model.AddRow(0, 'E', "inv2cap" + Get(ASlot.Code));
 		}
 	}
-	return temp_output;
 }
 
-string Arc::ArcDcNames() const {
-	string temp_output = "";
+void ArcRow::ArcDcNames(ModelBuilder& model) const {
 	// Create a constraint for DC power flow branches
-	if (isDCflow() && (Get("From") < Get("To"))) {
-		temp_output += " E dcpf" + Get("Code") + "\n";
+	if (isDCflow() && (Get(ASlot.From) < Get(ASlot.To))) {
+		model.AddRow(Time(), 'E', "dcpf" + Get(ASlot.Code));
 	}
-	return temp_output;
 }
 
-string Arc::ArcColumns() const {
-	string temp_output = "";
+void ArcRow::ArcColumns(ModelBuilder& model) const {
+	int col = model.ColumnId(Get(ASlot.Code)), block = Time();
 	string temp_code;
-	if (!isTransport() || (Get("TransInfr") != "")) {	
+	if (!isTransport() || (Get(ASlot.TransInfr) != "")) {	
 		if (!isTransport()) {
 		// Cost objective function
-		if (Get("OpCost") != "0"){
-			temp_output += "    " + Get("Code") + " obj " + Get("OpCost") + "\n";
+		if (GetValue(ASlot.OpCost) != 0){
+			model.AddEntry(block, col, "obj", GetValue(ASlot.OpCost));
 			if (Time()<=Sobjeval)
-				temp_output += "    " + Get("Code") + " HTobj " + Get("OpCost") + "\n";
+				model.AddEntry(block, col, "HTobj", GetValue(ASlot.OpCost));
 		}
 		} else {
 			// Cost of Transportation June 26 2012 + VoTT - venkat
-			if (Get("To")[0] != 'X') {
-				if (Get("OpCost") != "0"){
+			if (Get(ASlot.To)[0] != 'X') {
+				if (GetValue(ASlot.OpCost) != 0){
 					// Feb 28 2012 - Investment needed in 'ee' infra 'pp' - compute total average flow and give a $ for inv. needed - Transportation
-					/*string fleetcode = Get("From");
+					/*string fleetcode = Get(ASlot.From);
 					if ((fleetcode.compare(1,1,"e") == 0) && (fleetcode[1]==fleetcode[0]))  // ee train 
-						temp_output += "    " + Get("Code") + " obj " + ToString<double>(GetDouble("OpCost")+GetDouble("VoTT")+((25*GetDouble("Distance"))/(15*8640*39))) + "\n"; // 15 trips per hour in 1 track*8640 (trips per year) * 40 years - 25M$
+						model.AddEntry(block, col, "obj", GetDouble(ASlot.OpCost)+GetDouble(ASlot.VoTT)+((25*GetDouble(ASlot.Distance))/(15*8640*39))); // 15 trips per hour in 1 track*8640 (trips per year) * 40 years - 25M$
 					 else*/
-						 temp_output += "    " + Get("Code") + " obj " + ToString<double>(GetDouble("OpCost")+GetDouble("VoTT")) + "\n";
+						 model.AddEntry(block, col, "obj", GetDouble(ASlot.OpCost)+GetDouble(ASlot.VoTT));
 			 			if (Time()<=Sobjeval)
-							temp_output += "    " + Get("Code") + " HTobj " + ToString<double>(GetDouble("OpCost")+GetDouble("VoTT")) + "\n";
+							model.AddEntry(block, col, "HTobj", GetDouble(ASlot.OpCost)+GetDouble(ASlot.VoTT));
 
 				}
 			}
@@ -223,120 +417,116 @@ string Arc::ArcColumns() const {
 
 		// Sustainability metrics
 		for (int j = 0; j < SustMet.size(); ++j)
-			if (Get("Op" + SustMet[j]) != "0")
-				temp_output += "    " + Get("Code") + " " + SustMet[j] + GetYear() + " " + Get("Op" + SustMet[j]) + "\n";
+			if (GetValue(ASlot.Sust[j]) != 0)
+				model.AddEntry(block, col, SustMet[j] + GetYear(), GetValue(ASlot.Sust[j]));
 	} 	
 
 
 	if (!isTransport()) {
 		// Put arc in the constraint of the origin node
-		if (Get("From")[0] != 'X') {
-			temp_output += "    " + Get("Code") + " " + Get("From") + Get("FromStep") + " -1\n";
+		if (Get(ASlot.From)[0] != 'X') {
+			model.AddEntry(block, col, Get(ASlot.From) + Get(ASlot.FromStep), -1);
 		}
 		// Put arc in the constraint of the destination node
-		if (Get("To")[0] != 'X') {
+		if (Get(ASlot.To)[0] != 'X') {
 			if (InvertEff()) {
-				temp_output += "    " + Get("Code") + " " + Get("To") + Get("ToStep") + " 1\n";
+				model.AddEntry(block, col, Get(ASlot.To) + Get(ASlot.ToStep), 1);
 			} else {
-				temp_output += "    " + Get("Code") + " " + Get("To") + Get("ToStep") + " " + Get("Eff") + "\n";
+				model.AddEntry(block, col, Get(ASlot.To) + Get(ASlot.ToStep), GetValue(ASlot.Eff));
 			}
 		}
 		// Upper limit for flows
-		if (Get("OpMax") != "Inf") {
-			temp_output += "    " + Get("Code") + " ub" + Get("Code") + " 1\n";
+		if (!isinf(GetValue(ASlot.OpMax))) {
+			model.AddEntry(block, col, "ub" + Get(ASlot.Code), 1);
 		}
-	} else if (Get("TransInfr") != "") {
+	} else if (Get(ASlot.TransInfr) != "") {
 		// Put arc in the constraint of the destination node
-		if (Get("To")[0] != 'X') {
-//			temp_output += "    " + Get("Code") + " " + Get("To") + Get("ToStep") + " 1\n";
-			temp_output += "    " + Get("Code") + " " + Get("To") + Get("ToStep") + " " + Get("Eff") + "\n"; // Nov 29 2011 - Transportation Occupancy factor - Venkat
+		if (Get(ASlot.To)[0] != 'X') {
+//			model.AddEntry(block, col, Get(ASlot.To) + Get(ASlot.ToStep), 1);
+			model.AddEntry(block, col, Get(ASlot.To) + Get(ASlot.ToStep), GetValue(ASlot.Eff)); // Nov 29 2011 - Transportation Occupancy factor - Venkat
 		}
 		// Upper limit due to fleet
-		if (Get("OpMax") != "Inf") {
-			string fleetcode = Get("From") + Get("FromStep");
+		if (!isinf(GetValue(ASlot.OpMax))) {
+			string fleetcode = Get(ASlot.From) + Get(ASlot.FromStep);
 			fleetcode[1] = fleetcode[0];
-			temp_output += "    " + Get("Code") + " ub" + fleetcode + " 1\n";
+			model.AddEntry(block, col, "ub" + fleetcode, 1);
 		}
 		// Upper limit due to infrastructure
-		if (Get("OpMax") != "Inf") {
-			string infcode = Get("From") + Get("FromStep");
+		if (!isinf(GetValue(ASlot.OpMax))) {
+			string infcode = Get(ASlot.From) + Get(ASlot.FromStep);
 			string fleetcode = infcode;
-			infcode[0] = Get("TransInfr")[0];
-			infcode[1] = Get("TransInfr")[0];
+			infcode[0] = Get(ASlot.TransInfr)[0];
+			infcode[1] = Get(ASlot.TransInfr)[0];
 			// April 27 2012 - Bound on infratsructure - freight truck and car infra sharing... Venkat - Transportation
 			if ((fleetcode.compare(1,1,"k") == 0) && fleetcode[1]==fleetcode[0]) // Diesel Trucks
-				temp_output += "    " + Get("Code") + " ub" + infcode + " 2.5\n";
+				model.AddEntry(block, col, "ub" + infcode, 2.5);
 			else
-				temp_output += "    " + Get("Code") + " ub" + infcode + " 1\n";
+				model.AddEntry(block, col, "ub" + infcode, 1);
 		}
 
 	}
-	if (!isTransport() || (Get("TransInfr") != "")) {
-		temp_output += WriteEnergy2Trans();
-		temp_output += WriteTrans2Energy();
+	if (!isTransport() || (Get(ASlot.TransInfr) != "")) {
+		WriteEnergy2Trans(model, col);
+		WriteTrans2Energy(model, col);
 	}
 	// Put arc in DC power flow constraint if appropriate
 	if (isDCflow()) {
-		if (Get("From") < Get("To")) {
-			temp_output += "    " + Get("Code") + " dcpf" + Get("Code") + " -1\n";
+		if (Get(ASlot.From) < Get(ASlot.To)) {
+			model.AddEntry(block, col, "dcpf" + Get(ASlot.Code), -1);
 		} else {
-			temp_code = Get("To") + Get("ToStep") + "_" + Get("From") + Get("FromStep");
-			temp_output += "    " + Get("Code") + " dcpf" + temp_code + " 1\n";
+			temp_code = Get(ASlot.To) + Get(ASlot.ToStep) + "_" + Get(ASlot.From) + Get(ASlot.FromStep);
+			model.AddEntry(block, col, "dcpf" + temp_code, 1);
 		}
 	}
 	
 	// March 04 2014 - Cost curve - Venkat
-	if (Get("OpMaxc1") != "Inf")
-		temp_output += "    " + Get("Code") + " cc" + Get("Code") + " -1\n";
+	if (isCostCurve())
+		model.AddEntry(block, col, "cc" + Get(ASlot.Code), -1);
 
 	// March 04 2014 - Co-fire - Venkat
-	if (Get("To").substr(0,2) == "EC") {
-		if ((Get("From").substr(0,2) == "7T") || (Get("From").substr(0,2) == "8T") || (Get("From").substr(0,2) == "9T")) // Biomass feedstoc Mar 04 2014
-			temp_output += "    " + Get("Code") + " co" + Get("To") + Get("ToStep") + " 1\n";
+	if (Get(ASlot.To).substr(0,2) == "EC") {
+		if ((Get(ASlot.From).substr(0,2) == "7T") || (Get(ASlot.From).substr(0,2) == "8T") || (Get(ASlot.From).substr(0,2) == "9T")) // Biomass feedstoc Mar 04 2014
+			model.AddEntry(block, col, "co" + Get(ASlot.To) + Get(ASlot.ToStep), 1);
 		else
-			temp_output += "    " + Get("Code") + " co" + Get("To") + Get("ToStep") + " -" +ToString<double>(cofire) +"\n";
+			model.AddEntry(block, col, "co" + Get(ASlot.To) + Get(ASlot.ToStep), -cofire);
 	}
-	
-	return temp_output;
 }
 
 
 // Cost curves Mar 04 2014 - Venkat
-string Arc::ArcCC() const {
-	string temp_output = "";
-	// Cost curve - Mar 04 2014 Venkat
-	if (Get("OpMaxc1") != "Inf") {
-		for (int i=1; i!=segmnt+1; ++i){
-			//string temp_s = "OpCostc" + ToString<int>(i);
-			temp_output += " c" + ToString<int>(i) + Get("Code") + " obj " + Get("OpCostc" + ToString<int>(i)) + "\n";
+void ArcRow::ArcCC(ModelBuilder& model) const {
+	// One column per segment of the curve, in order of quantity
+	if (isCostCurve()) {
+		for (int k = table->cc_start[row]; k < table->cc_start[row+1]; ++k) {
+			int col = model.ColumnId("c" + ToString<int>(k - table->cc_start[row] + 1) + Get(ASlot.Code));
+			model.AddEntry(Time(), col, "obj", table->cc_cost[k]);
 			if (Time()<=Sobjeval)
-				temp_output += " c" + ToString<int>(i) + Get("Code") +" HTobj " + Get("OpCostc" + ToString<int>(i)) + "\n";
-			temp_output += " c" + ToString<int>(i) + Get("Code") + " cc" + Get("Code") + " 1\n";
+				model.AddEntry(Time(), col, "HTobj", table->cc_cost[k]);
+			model.AddEntry(Time(), col, "cc" + Get(ASlot.Code), 1);
 		}
 	}
-	return temp_output;
 }
 
 
 
-string Arc::InvArcColumns() const {
-	string temp_output = "";
-	string temp_code;
+void ArcRow::InvArcColumns(ModelBuilder& model) const {
 	// If investment allowed
-	if (InvArc() && Get("TransInfr") == "") {
+	if (InvArc() && Get(ASlot.TransInfr) == "") {
 		// Cost of investment
-		temp_output += "    inv" + Get("Code") + " obj " + Get("InvCost") + "\n";
+		int inv = model.ColumnId("inv" + Get(ASlot.Code)), caprow;
+		model.AddEntry(0, inv, "obj", GetValue(ASlot.InvCost));
+		model.KeepColumn(0, inv); // Minimum investments of NSGA-II
 		
 		if (Time()<=Sobjeval)
-			temp_output += "    inv" + Get("Code") + " HTobj " + Get("InvCost") + "\n";
+			model.AddEntry(0, inv, "HTobj", GetValue(ASlot.InvCost));
 		
 
 		// Investment added to the next upper bound contraints
 		Step step1, step2, stepguide, maxstep;
-		step1 = Str2Step(Get("FromStep"));
-		step2 = Str2Step(Get("ToStep"));
-		if (Get("LifeSpan") != "X") {
-			maxstep = StepSum(step1, Str2Step(Get("LifeSpan")));
+		step1 = Str2Step(Get(ASlot.FromStep));
+		step2 = Str2Step(Get(ASlot.ToStep));
+		if (Get(ASlot.LifeSpan) != "X") {
+			maxstep = StepSum(step1, Str2Step(Get(ASlot.LifeSpan)));
 			maxstep = (maxstep > SLength) ? SLength : maxstep;
 		} else {
 			maxstep = SLength;
@@ -344,353 +534,278 @@ string Arc::InvArcColumns() const {
 		
 		stepguide = (step1 > step2) ? step1 : step2;
 		while (stepguide <= maxstep) {
-			temp_output += "    inv" + Get("Code") + " inv2cap";
-			temp_output += Get("From") + Step2Str(step1);
+			string capcode = "inv2cap" + Get(ASlot.From) + Step2Str(step1);
 			if (!isTransport())
-				temp_output += "_" + Get("To") + Step2Str(step2);
+				capcode += "_" + Get(ASlot.To) + Step2Str(step2);
+			caprow = model.RowId(capcode);
 
 			// Feb 21 2012 - fleet investment to flow capacity (no. of trips/year) - Venkat - Transportation
 			if (isTransport()) {// only for fleet investments - if infra investment, better check logic?
-				string fleetcode = Get("From");
+				string fleetcode = Get(ASlot.From);
 
 				if (((fleetcode.compare(1,1,"c") == 0) && fleetcode[1]==fleetcode[0]) || ((fleetcode.compare(1,1,"g") == 0) && fleetcode[1]==fleetcode[0])) { // Cars
-					if (GetDouble("Distance")<150)
-						temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/24)+"\n";//1/24*stephours -- time to one trip (1 day)
-					else if (GetDouble("Distance")>500)
-						temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/(6*30*24))+"\n";//1/24*stephours -- time to one trip (6 months)
-					else temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/(30*24))+"\n";//1/24*stephours -- time to one trip (1 month)
+					if (GetDouble(ASlot.Distance)<150)
+						model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/24));//1/24*stephours -- time to one trip (1 day)
+					else if (GetDouble(ASlot.Distance)>500)
+						model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/(6*30*24)));//1/24*stephours -- time to one trip (6 months)
+					else model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/(30*24)));//1/24*stephours -- time to one trip (1 month)
 				}
 				
 				if ((fleetcode.compare(1,1,"f") == 0) && fleetcode[1]==fleetcode[0]) { // Planes
-					if (GetDouble("Distance")<500)
-						temp_output += " -"+ ToString<double>(3*atof(Step2Hours(stepguide).c_str())/24)+"\n";//1/24*stephours -- time to one trip (3 per day)
-					else if (GetDouble("Distance")>1000)
-						temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/24)+"\n";//1/24*stephours -- time to one trip (1 per day)
-					else	temp_output += " -"+ ToString<double>(2*atof(Step2Hours(stepguide).c_str())/24)+"\n";//1/24*stephours -- time to one trip (2 per day)  
+					if (GetDouble(ASlot.Distance)<500)
+						model.AddEntry(0, inv, caprow, -(3*atof(Step2Hours(stepguide).c_str())/24));//1/24*stephours -- time to one trip (3 per day)
+					else if (GetDouble(ASlot.Distance)>1000)
+						model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/24));//1/24*stephours -- time to one trip (1 per day)
+					else	model.AddEntry(0, inv, caprow, -(2*atof(Step2Hours(stepguide).c_str())/24));//1/24*stephours -- time to one trip (2 per day)  
 				}
 		
 				if ((fleetcode.compare(1,1,"k") == 0) && fleetcode[1]==fleetcode[0]) { // Diesel Trucks
-					if (GetDouble("Distance")<250)
-						temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/24)+"\n";//1/24*stephours -- time to one trip (1 per day)
-					else if (GetDouble("Distance")>500)
-						temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/(3*24))+"\n";//1/24*stephours -- time to one trip (1 in 3 days)
-					else	temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/(2*24))+"\n";//1/24*stephours -- time to one trip (1 in 2 days) 
+					if (GetDouble(ASlot.Distance)<250)
+						model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/24));//1/24*stephours -- time to one trip (1 per day)
+					else if (GetDouble(ASlot.Distance)>500)
+						model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/(3*24)));//1/24*stephours -- time to one trip (1 in 3 days)
+					else	model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/(2*24)));//1/24*stephours -- time to one trip (1 in 2 days) 
 				}
 
 				if ((fleetcode.compare(1,1,"t") == 0) && fleetcode[1]==fleetcode[0]) // Diesel train
-					temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/(24))+"\n";//1/24*stephours -- time to one trip (1 day)
+					model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/(24)));//1/24*stephours -- time to one trip (1 day)
 					
 				if ((fleetcode.compare(1,1,"e") == 0) && fleetcode[1]==fleetcode[0]) { // Electric Train (HSR=150 mph)
-					if (GetDouble("Distance")<200)
-						temp_output += " -"+ ToString<double>(3*atof(Step2Hours(stepguide).c_str())/(24))+"\n";//1/24*stephours -- time to one trip (3 per day)
-					else if (GetDouble("Distance")>600)
-						temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/(24))+"\n";//1/24*stephours -- time to one trip (1 per day)
-					else	temp_output += " -"+ ToString<double>(2*atof(Step2Hours(stepguide).c_str())/(24))+"\n";//1/24*stephours -- time to one trip (2 per day) 
+					if (GetDouble(ASlot.Distance)<200)
+						model.AddEntry(0, inv, caprow, -(3*atof(Step2Hours(stepguide).c_str())/(24)));//1/24*stephours -- time to one trip (3 per day)
+					else if (GetDouble(ASlot.Distance)>600)
+						model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/(24)));//1/24*stephours -- time to one trip (1 per day)
+					else	model.AddEntry(0, inv, caprow, -(2*atof(Step2Hours(stepguide).c_str())/(24)));//1/24*stephours -- time to one trip (2 per day) 
 				}
 
 				// July 3 2012 - HSR infra investment - Venkat
-				string Infcode = Get("From");
+				string Infcode = Get(ASlot.From);
 			   if (((Infcode.compare(1,1,"p") == 0) && Infcode[1]==Infcode[0])) { // HSR tracks investments
-					//if (GetDouble("Distance")<150)
-					//	temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/24)+"\n";//1/24*stephours -- time to one trip (1 day)
-					//else if (GetDouble("Distance")>500)
-					//	temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/(6*30*24))+"\n";//1/24*stephours -- time to one trip (6 months)
+					//if (GetDouble(ASlot.Distance)<150)
+					//	model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/24));//1/24*stephours -- time to one trip (1 day)
+					//else if (GetDouble(ASlot.Distance)>500)
+					//	model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/(6*30*24)));//1/24*stephours -- time to one trip (6 months)
 					//else 
-						temp_output += " -"+ ToString<double>(10*atof(Step2Hours(stepguide).c_str()))+"\n";// 15 trains per hour
+						model.AddEntry(0, inv, caprow, -(10*atof(Step2Hours(stepguide).c_str())));// 15 trains per hour
 				}
 
-			} else temp_output += " -1\n";
+			} else model.AddEntry(0, inv, caprow, -1);
 
 			if (isFirstBidirect() || isFirstTransport()) {
-				Arc Arc2(*this, true);
-				temp_output += "    inv" + Get("Code") + " inv2cap";
-				temp_output += Arc2.Get("From") + Step2Str(step1);
+				// Same constraint for the arc in the opposite direction
+				string from2 = Get(ASlot.To), to2 = Get(ASlot.From);
+				if (isTransport())
+					from2 = to2.substr(0,2) + to2.substr(4,2) + to2.substr(2,2);
+				capcode = "inv2cap" + from2 + Step2Str(step1);
 				if (!isTransport()) {
-					temp_output += "_" + Arc2.Get("To") + Step2Str(step2);
+					capcode += "_" + to2 + Step2Str(step2);
 				}
+				caprow = model.RowId(capcode);
 				
 			// Feb 21 2012 - fleet investment to flow capacity (no. of trips/year) - Venkat - Transportation
 			if (isTransport()) {
-				string fleetcode = Get("From");
+				string fleetcode = Get(ASlot.From);
 
 				if (((fleetcode.compare(1,1,"c") == 0) && fleetcode[1]==fleetcode[0]) || ((fleetcode.compare(1,1,"g") == 0) && fleetcode[1]==fleetcode[0])) { // Cars
-					if (GetDouble("Distance")<150)
-						temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/24)+"\n";//1/24*stephours -- time to one trip (1 day)
-					else if (GetDouble("Distance")>500)
-						temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/(6*30*24))+"\n";//1/24*stephours -- time to one trip (6 months)
-					else temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/(30*24))+"\n";//1/24*stephours -- time to one trip (1 month)
+					if (GetDouble(ASlot.Distance)<150)
+						model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/24));//1/24*stephours -- time to one trip (1 day)
+					else if (GetDouble(ASlot.Distance)>500)
+						model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/(6*30*24)));//1/24*stephours -- time to one trip (6 months)
+					else model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/(30*24)));//1/24*stephours -- time to one trip (1 month)
 				}
 				
 				if ((fleetcode.compare(1,1,"f") == 0) && fleetcode[1]==fleetcode[0]) { // Planes
-					if (GetDouble("Distance")<500)
-						temp_output += " -"+ ToString<double>(3*atof(Step2Hours(stepguide).c_str())/24)+"\n";//1/24*stephours -- time to one trip (3 per day)
-					else if (GetDouble("Distance")>1000)
-						temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/24)+"\n";//1/24*stephours -- time to one trip (1 per day)
-					else	temp_output += " -"+ ToString<double>(2*atof(Step2Hours(stepguide).c_str())/24)+"\n";//1/24*stephours -- time to one trip (2 per day)  
+					if (GetDouble(ASlot.Distance)<500)
+						model.AddEntry(0, inv, caprow, -(3*atof(Step2Hours(stepguide).c_str())/24));//1/24*stephours -- time to one trip (3 per day)
+					else if (GetDouble(ASlot.Distance)>1000)
+						model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/24));//1/24*stephours -- time to one trip (1 per day)
+					else	model.AddEntry(0, inv, caprow, -(2*atof(Step2Hours(stepguide).c_str())/24));//1/24*stephours -- time to one trip (2 per day)  
 				}
 		
 				if ((fleetcode.compare(1,1,"k") == 0) && fleetcode[1]==fleetcode[0]) { // Diesel Trucks
-					if (GetDouble("Distance")<250)
-						temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/24)+"\n";//1/24*stephours -- time to one trip (1 per day)
-					else if (GetDouble("Distance")>500)
-						temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/(3*24))+"\n";//1/24*stephours -- time to one trip (1 in 3 days)
-					else	temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/(2*24))+"\n";//1/24*stephours -- time to one trip (1 in 2 days) 
+					if (GetDouble(ASlot.Distance)<250)
+						model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/24));//1/24*stephours -- time to one trip (1 per day)
+					else if (GetDouble(ASlot.Distance)>500)
+						model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/(3*24)));//1/24*stephours -- time to one trip (1 in 3 days)
+					else	model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/(2*24)));//1/24*stephours -- time to one trip (1 in 2 days) 
 				}
 
 				if ((fleetcode.compare(1,1,"t") == 0) && fleetcode[1]==fleetcode[0]) // Diesel train
-					temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/(24))+"\n";//1/24*stephours -- time to one trip (1 day)
+					model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/(24)));//1/24*stephours -- time to one trip (1 day)
 					
 				if ((fleetcode.compare(1,1,"e") == 0) && fleetcode[1]==fleetcode[0]) { // Electric Train (HSR=150 mph)
-					if (GetDouble("Distance")<200)
-						temp_output += " -"+ ToString<double>(3*atof(Step2Hours(stepguide).c_str())/(24))+"\n";//1/24*stephours -- time to one trip (3 per day)
-					else if (GetDouble("Distance")>600)
-						temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/(24))+"\n";//1/24*stephours -- time to one trip (1 per day)
-					else	temp_output += " -"+ ToString<double>(2*atof(Step2Hours(stepguide).c_str())/(24))+"\n";//1/24*stephours -- time to one trip (2 per day) 
+					if (GetDouble(ASlot.Distance)<200)
+						model.AddEntry(0, inv, caprow, -(3*atof(Step2Hours(stepguide).c_str())/(24)));//1/24*stephours -- time to one trip (3 per day)
+					else if (GetDouble(ASlot.Distance)>600)
+						model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/(24)));//1/24*stephours -- time to one trip (1 per day)
+					else	model.AddEntry(0, inv, caprow, -(2*atof(Step2Hours(stepguide).c_str())/(24)));//1/24*stephours -- time to one trip (2 per day) 
 				}
 
 				// July 3 2012 - HSR infra investment - Venkat
-				string Infcode = Get("From");
+				string Infcode = Get(ASlot.From);
 			   if (((Infcode.compare(1,1,"p") == 0) && Infcode[1]==Infcode[0])) { // HSR tracks investments
-					//if (GetDouble("Distance")<150)
-					//	temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/24)+"\n";//1/24*stephours -- time to one trip (1 day)
-					//else if (GetDouble("Distance")>500)
-					//	temp_output += " -"+ ToString<double>(atof(Step2Hours(stepguide).c_str())/(6*30*24))+"\n";//1/24*stephours -- time to one trip (6 months)
+					//if (GetDouble(ASlot.Distance)<150)
+					//	model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/24));//1/24*stephours -- time to one trip (1 day)
+					//else if (GetDouble(ASlot.Distance)>500)
+					//	model.AddEntry(0, inv, caprow, -(atof(Step2Hours(stepguide).c_str())/(6*30*24)));//1/24*stephours -- time to one trip (6 months)
 					//else 
-						temp_output += " -"+ ToString<double>(10*atof(Step2Hours(stepguide).c_str()))+"\n";// 15 trains per hour
+						model.AddEntry(0, inv, caprow, -(10*atof(Step2Hours(stepguide).c_str())));// 15 trains per hour
 				}
 
-			} else temp_output += " -1\n";
+			} else model.AddEntry(0, inv, caprow, -1);
 			}
 
 			// Move to the next year
 			++stepguide[0]; ++step1[0]; ++step2[0];
 		}
 	}
-	return temp_output;
 }
 
-string Arc::CapArcColumns(int selector) const {
-	string temp_output = "";
-	
+void ArcRow::CapArcColumns(ModelBuilder& model) const {
 	// If investment is allowed,
-	if (isFirstinYear() && Get("OpMax") != "Inf" && Get("TransInfr") == "") {
-		if (selector != 1) {
-			// Add capacity as an upper bound for flows withing that year
-			Step step1, step2, stepguide, maxstep;
-			step1 = Str2Step(Get("FromStep"));
-			step2 = Str2Step(Get("ToStep"));
-			stepguide = (step1 > step2) ? step1 : step2;
-			maxstep = (isStorage()) ? step1 : stepguide;
-			++maxstep[0];
+	if (isFirstinYear() && !isinf(GetValue(ASlot.OpMax)) && Get(ASlot.TransInfr) == "") {
+		int cap = model.ColumnId("cap" + Get(ASlot.Code));
+		model.KeepColumn(Time(), cap, MODEL_BENDERS); // Bounded by the master problem
+		
+		// Add capacity as an upper bound for flows withing that year (subproblem)
+		Step step1, step2, stepguide, maxstep;
+		step1 = Str2Step(Get(ASlot.FromStep));
+		step2 = Str2Step(Get(ASlot.ToStep));
+		stepguide = (step1 > step2) ? step1 : step2;
+		maxstep = (isStorage()) ? step1 : stepguide;
+		++maxstep[0];
+		
+		while (stepguide < maxstep) {
+			string ubcode = "ub" + Get(ASlot.From) + Step2Str(step1);
+			if (!isTransport())
+				ubcode += "_" + Get(ASlot.To) + Step2Str(step2);
 			
-			string common = "    cap" + Get("Code") + " ub";
-			while (stepguide < maxstep) {
-				temp_output += common;
-				temp_output += Get("From") + Step2Str(step1);
-				if (!isTransport())
-					temp_output += "_" + Get("To") + Step2Str(step2);
-				
-				if (InvertEff()) {
-					string reduced_cap = ToString<double>(GetDouble("Eff") * atof(Step2Hours(stepguide).c_str()));
-					temp_output += " -" + reduced_cap + "\n";
-				} else if (Get("InvertEff") == "1") {
-					temp_output += " -1\n";
-				} else {
-					temp_output += " -" + Step2Hours(stepguide) + "\n";
-				}
-				
-				// Move to the next year
-				stepguide = NextStep(stepguide);
-				if (NextStep(step1) <= stepguide)
-					step1 = NextStep(step1);
-				if (NextStep(step2) <= stepguide)
-					step2 = NextStep(step2);
+			if (InvertEff()) {
+				model.AddEntry(Time(), cap, ubcode, -(GetDouble(ASlot.Eff) * atof(Step2Hours(stepguide).c_str())));
+			} else if (Get(ASlot.InvertEff) == "1") {
+				model.AddEntry(Time(), cap, ubcode, -1);
+			} else {
+				model.AddEntry(Time(), cap, ubcode, -atof(Step2Hours(stepguide).c_str()));
 			}
-		}
-		if (selector != 2) {
-			// Add current investment to the capacity of the arc
-			temp_output += "    cap" + Get("Code") + " inv2cap" + Get("Code") + " 1\n";
 			
-			// Contribution to peak load
-			if (Get("CapacityFactor") != "0") {
-				temp_output += "    cap" + Get("Code");
-				temp_output += " pk" + Get("To") + Get("ToStep") + " " + Get("CapacityFactor") + "\n";
-			}
+			// Move to the next year
+			stepguide = NextStep(stepguide);
+			if (NextStep(step1) <= stepguide)
+				step1 = NextStep(step1);
+			if (NextStep(step2) <= stepguide)
+				step2 = NextStep(step2);
 		}
+		
+		// Add current investment to the capacity of the arc (master problem)
+		model.AddEntry(0, cap, "inv2cap" + Get(ASlot.Code), 1);
+		
+		// Contribution to peak load
+		if (GetValue(ASlot.CapacityFactor) != 0)
+			model.AddEntry(0, cap, "pk" + Get(ASlot.To) + Get(ASlot.ToStep), GetValue(ASlot.CapacityFactor));
 	}
-	return temp_output;
 }
 
-vector<string> Arc::Events() const {
+vector<string> ArcRow::Events() const {
 	vector<string> temp_output(0);
 	
 	// If investment is allowed,
-	if (isFirstinYear() && (Get("OpMax") != "Inf") && (Get("TransInfr") == "")) {
+	if (isFirstinYear() && !isinf(GetValue(ASlot.OpMax)) && (Get(ASlot.TransInfr) == "")) {
 		// Base case
 		temp_output.push_back("1");
 		for (int event = 1; event <= Nevents; ++event) {
 			// For events
-			string property = "CapacityLoss" + ToString<int>(event);
-			temp_output.push_back(Get(property));
+			temp_output.push_back(GetText(ASlot.Events[event-1]));
 		}
 	}
 	return temp_output;
 }
 
-string Arc::ArcRhs() const {
-	string temp_output = "";
+void ArcRow::ArcRhs(ModelBuilder& model) const {
 	// RHS in the upper bound constraints, for the capacity existing at t=0
-	if (isFirstinYear() && (Get("OpMax") != "Inf")  && (Get("TransInfr") == ""))
-		temp_output += " rhs inv2cap" + Get("Code") + " " + Get("OpMax") + "\n";
-	
-	return temp_output;
+	if (isFirstinYear() && !isinf(GetValue(ASlot.OpMax))  && (Get(ASlot.TransInfr) == ""))
+		model.AddRhs(0, "inv2cap" + Get(ASlot.Code), GetValue(ASlot.OpMax));
 }
 
-string Arc::ArcBounds() const {
-	string temp_output = "";
+void ArcRow::ArcBounds(ModelBuilder& model) const {
 	// Write minimum for operational flow
-	if ((Get("OpMin") != "0") && (Get("TransInfr") == ""))
-		temp_output += " LO bnd " + Get("Code") + " " + Get("OpMin") + "\n";
-	
-	return temp_output;
+	if ((GetValue(ASlot.OpMin) != 0) && (Get(ASlot.TransInfr) == ""))
+		model.AddBound(Time(), 'L', model.ColumnId(Get(ASlot.Code)), GetValue(ASlot.OpMin));
 }
 
-string Arc::ArcInvBounds() const {
-	string temp_output = "";
-	if (InvArc() && (Get("TransInfr") == "")) {
+void ArcRow::ArcInvBounds(ModelBuilder& model) const {
+	if (InvArc() && (Get(ASlot.TransInfr) == "")) {
 		// Investment min and maximum when investment is allowed
-		if (Get("InvMin") != "0")
-			temp_output += " LO bnd inv" + Get("Code") + " " + Get("InvMin") + "\n";
-		if (Get("InvMax") != "Inf")
-			temp_output += " UP bnd inv" + Get("Code") + " " + Get("InvMax") + "\n";
+		if (GetValue(ASlot.InvMin) != 0)
+			model.AddBound(0, 'L', model.ColumnId("inv" + Get(ASlot.Code)), GetValue(ASlot.InvMin));
+		if (!isinf(GetValue(ASlot.InvMax)))
+			model.AddBound(0, 'U', model.ColumnId("inv" + Get(ASlot.Code)), GetValue(ASlot.InvMax));
 	}
-	return temp_output;
 }
 
 // Cost curve - Mar 04 2014 Venkat
-string Arc::ArcCCBounds() const {
-	string temp_output = "";
-	if (Get("OpMaxc1") != "Inf") {
-		// sort algorithm 
-		//string temp_q = "OpMaxc";
-		vector<double> vecq, svecq, pvec;
-		for (int i=1; i!=segmnt+1; ++i){
-			vecq.push_back(GetDouble("OpMaxc"+ ToString<int>(i)));
-			pvec.push_back(0);
-		}
-		svecq= vecq;
-		sort( svecq.begin(), svecq.end() );
-		double b=0;
-		for (int it=1; it!=segmnt+1; ++it) {
-			for (int i=1; i!=segmnt+1; ++i) {
-				if (vecq[i-1]==svecq[it-1] && pvec[i-1]!=1) { // the data may be jumbled, and so this makes the curve appear in ascending order of feedstock quantity
-					temp_output += " UP bnd c" + ToString<int>(i) + Get("Code") + " " + ToString<double>((svecq[it-1]-b)*8640) + "\n";
-					pvec[i-1]=1;
-					break;
-				}				
-			}
-			b=svecq[it-1];
-		}
+void ArcRow::ArcCCBounds(ModelBuilder& model) const {
+	if (isCostCurve()) {
+		for (int k = table->cc_start[row]; k < table->cc_start[row+1]; ++k)
+			model.AddBound(Time(), 'U', model.ColumnId("c" + ToString<int>(k - table->cc_start[row] + 1) + Get(ASlot.Code)), table->cc_width[k]*8640);
 	}
-	return temp_output;
 }
 
-string Arc::WriteEnergy2Trans() const {
-	string temp_output = "";
+void ArcRow::WriteEnergy2Trans(ModelBuilder& model, const int col) const {
 	// Load on the transportation side created by a coal/energy arc
-	if (Energy2Trans)
-		temp_output += "    " + Get("Code") + " " + Get("From") + Get("To").substr(2,2) + Get("ToStep") + " -1\n";
-	
-	return temp_output;
+	if (isEnergy2Trans())
+		model.AddEntry(Time(), col, Get(ASlot.From) + Get(ASlot.To).substr(2,2) + Get(ASlot.ToStep), -1);
 }
 
-string Arc::WriteTrans2Energy() const {
-	string temp_output = "";
+void ArcRow::WriteTrans2Energy(ModelBuilder& model, const int col) const {
 	// Energy demand for a transportation node that requires it
-	for (int k=0; k+1 < Trans2Energy.size(); k+=2)
-		temp_output += "    " + Get("Code") + " " + Trans2Energy[k] + " -" + Trans2Energy[k+1] + "\n";
-	
-	return temp_output;
+	int c = table->t2e[row];
+	if (c < 0) return;
+	double scale = table->t2e_scale[row];
+	for (int k = table->couple_start[c]; k < table->couple_start[c+1]; ++k)
+		model.AddEntry(Time(), col, table->pool[table->couple_node[k]], -(table->couple_value[k] * scale));
 }
 
-// Get what time the arc belongs to (i.e., year)
-int Arc::Time() const {
-	return Str2Step(Get("FromStep"))[0];
+// ****** Boolean functions (evaluated when the arc was stored) ******
+bool ArcRow::isFirstinYear() const {
+	return (table->flags[row] & AF_FIRSTINYEAR) != 0;
 }
 
-
-// ****** Boolean functions ******
-
-// Is it the first arc in a year?
-bool Arc::isFirstinYear() const {
-	bool output = true;
-	Step step1, step2, stepguide;
-	step1 = Str2Step(Get("FromStep"));
-	step2 = Str2Step(Get("ToStep"));
-	stepguide = ((step1 > step2) || isStorage()) ? step1 : step2;
-	for (unsigned int k = Get("InvStep").size(); k < SName.size(); k++) {
-		output = output && ((stepguide[k]==0) || (stepguide[k]==1));
-	}
-	return output;
+bool ArcRow::InvArc() const {
+	return (table->flags[row] & AF_INVARC) != 0;
 }
 
-// Is investment allowed for current arc?
-bool Arc::InvArc() const {
-	// Inv. cost is declared and it's the first arc in each investment period
-	bool output = (Get("InvCost") != "X") && isFirstinYear() && (Get("InvMax") != "0");
-	// It's the first if the arc is bidirectional
-	output = output && (!isTransport() && (!isBidirect() || isFirstBidirect()) || isFirstTransport() );
-	// Technology is available
-	output = output && (Str2Step(Get("FromStep")) >= Str2Step(Get("InvStart")));
-	return output;
+bool ArcRow::InvertEff() const {
+	return (table->flags[row] & AF_INVERTEFF) != 0;
 }
 
-// Is efficiency inverted? (Used with electrical generators)
-bool Arc::InvertEff() const {
-	return ((Get("InvertEff") == "Y") || (Get("InvertEff") == "y"));
+bool ArcRow::isDCflow() const {
+	return (table->flags[row] & AF_DCFLOW) != 0;
 }
 
-// Is the arc part of DC flow constraints?
-bool Arc::isDCflow() const {
-	bool output = (Get("From").substr(0,2) == DCCode) && (Get("To").substr(0,2) == DCCode);
-	return output && useDCflow;
+bool ArcRow::isCostCurve() const {
+	return (table->flags[row] & AF_COSTCURVE) != 0;
 }
 
-// Is it a storage arc?
-bool Arc::isStorage() const {
-	return (Get("From").substr(1,1) == StorageCode) && (Get("From") == Get("To"));
+bool ArcRow::isStorage() const {
+	return (table->flags[row] & AF_STORAGE) != 0;
 }
 
-// Is the arc bidirectional? (excludes storage nodes)
-bool Arc::isBidirect() const {
-	bool output = Get("From").substr(0,2) == Get("To").substr(0,2);
-//	output = output && !isDCflow() && !isStorage();
-	output = output && !isStorage();// Feb 21 2013-DCPF
-	return output;
+bool ArcRow::isBidirect() const {
+	return (table->flags[row] & AF_BIDIRECT) != 0;
 }
 
-// Is the arc bidirectional and and the first alphabetically?
-bool Arc::isFirstBidirect() const {
-	return isBidirect() && (Get("From") < Get("To"));
+bool ArcRow::isFirstBidirect() const {
+	return (table->flags[row] & AF_FIRSTBIDIRECT) != 0;
 }
 
-// Is is a transportation arc?
-bool Arc::isTransport() const {
-	return (Get("From").size() > 4) && (Get("To").size() > 4);
+bool ArcRow::isTransport() const {
+	return (table->flags[row] & AF_TRANSPORT) != 0;
 }
 
-// Is it a transportation arc and the first alphabetically?
-bool Arc::isFirstTransport() const {
-	return isTransport() && (Get("From").substr(2,2) < Get("From").substr(4,2));
+bool ArcRow::isFirstTransport() const {
+	return (table->flags[row] & AF_FIRSTTRANSPORT) != 0;
 }
 
-
-// ****** Other functions ******
-// Find the index for a arc property selector
-int FindArcSelector(const string& selector) {
-	int index = -1;
-	for (unsigned int k = 0; k < ArcProp.size(); ++k) {
-		if (selector == ArcProp[k]) index = k;
-	}
-	return index;
+bool ArcRow::isEnergy2Trans() const {
+	return (table->flags[row] & AF_ENERGY2TRANS) != 0;
 }
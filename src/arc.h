@@ -8,6 +8,17 @@
 #ifndef _ARC_H_
 #define _ARC_H_
 
+// Storage slots for arc properties (resolved by ReadParameters)
+struct ArcSlots {
+	// String codes
+	int Code, From, To, FromStep, ToStep, InvStep, TransInfr, InvStart, LifeSpan, InvertEff, Leadtime;
+	// Numeric values
+	int StepLength, OpCost, InvCost, DiscountRate, InflationRate, Distance, OpMin, OpMax, InvMin, InvMax, Eff, Suscep, CapacityFactor, VoTT;
+	// Sustainability metrics and resiliency events
+	vector<int> Sust, Events;
+};
+extern ArcSlots ASlot;
+
 // Declare class to store arc information
 class Arc {
 	public:
@@ -17,37 +28,43 @@ class Arc {
 		~Arc();
 		Arc& operator=(const Arc& rhs);
 		
+		// Access by slot (string codes and numeric values)
+		const string& Get(const int slot) const;
+		double GetValue(const int slot) const;
+		double GetDouble(const int slot) const;
+		string GetText(const int slot) const;
+		bool Has(const int slot) const;
+		void Set(const int slot, const string& input);
+		void SetDouble(const int slot, const double input);
+		void Multiply(const int slot, const double value);
+		
+		// Access by property name (slower, used when reading data)
 		string Get(const string& selector) const;
-		string GetYear() const;
-		double GetDouble(const string& selector) const;
-		bool GetBool(const string& selector) const;
-		vector<string> GetVecStr(const string& selector) const;
 		void Set(const string& selector, const string& input);
+		
+		bool GetBool(const string& selector) const;
 		void Set(const string& selector, const bool input);
-		void Add(const string& selector, const string& input);
 		void Multiply(const string& selector, const double value);
 		int Time() const;
 		
-		string WriteEnergy2Trans() const;
-		string WriteTrans2Energy() const;
+		// Energy consumed by the arc: a coupling of the 'ArcTable' it's added
+		// to (-1 if none), multiplied by a scale (such as the distance)
+		void SetTrans2Energy(const int coupling);
+		int GetTrans2Energy() const;
+		double GetTrans2EnergyScale() const;
 		
-		string ArcUbNames() const;
-		string ArcCapNames() const;
-		string ArcDcNames() const;
-		string ArcColumns() const;
-		string InvArcColumns() const;
-		string CapArcColumns(int selector) const;
-		vector<string> Events() const;
-		string ArcRhs() const;
-		string ArcBounds() const;
-		string ArcInvBounds() const;
-		string ArcCC() const; // Mar 04 2014 Feedstock Cost curve
-		string ArcCCBounds() const; // Mar 04 2014 Feedstock Cost curve
+		// Cost curve in the step of the arc: width (quantity per hour) and
+		// cost of each segment. An arc with a curve but no segments can't
+		// carry any flow.
+		void SetCostCurve(const vector<double>& width, const vector<double>& cost);
+		const vector<double>& GetCurveWidth() const;
+		const vector<double>& GetCurveCost() const;
 		
 		bool isFirstinYear() const;
 		bool InvArc() const;
 		bool InvertEff() const;
 		bool isDCflow() const;
+		bool isCostCurve() const;
 		bool isStorage() const;
 		bool isBidirect() const;
 		bool isFirstBidirect() const;
@@ -55,11 +72,67 @@ class Arc {
 		bool isFirstTransport() const;
 	
 	private:
-		vector<string> Properties, Trans2Energy;
+		vector<string> Codes;
+		vector<double> Values;
+		int Trans2Energy;
+		double Trans2EnergyScale;
+		vector<double> CurveWidth, CurveCost;
+		bool CostCurve;
 		bool Energy2Trans;
 };
 
-// Find the index for a arc property selector
-int FindArcSelector(const string& selector);
+class ArcTable;
+class ModelBuilder;
+
+// Declare class type to read an arc stored in an 'ArcTable' (used to build the model)
+class ArcRow {
+	public:
+		ArcRow(const ArcTable& table, const int row);
+		
+		// Access by slot (string codes and numeric values)
+		const string& Get(const int slot) const;
+		double GetValue(const int slot) const;
+		double GetDouble(const int slot) const;
+		string GetText(const int slot) const;
+		bool Has(const int slot) const;
+		
+		// Access by property name
+		string Get(const string& selector) const;
+		string GetYear() const;
+		int Time() const;
+		
+		// Add the rows, columns, right-hand sides and bounds of the arc to the model
+		void WriteEnergy2Trans(ModelBuilder& model, const int col) const;
+		void WriteTrans2Energy(ModelBuilder& model, const int col) const;
+		
+		void ArcUbNames(ModelBuilder& model) const;
+		void ArcCapNames(ModelBuilder& model) const;
+		void ArcDcNames(ModelBuilder& model) const;
+		void ArcColumns(ModelBuilder& model) const;
+		void InvArcColumns(ModelBuilder& model) const;
+		void CapArcColumns(ModelBuilder& model) const;
+		vector<string> Events() const;
+		void ArcRhs(ModelBuilder& model) const;
+		void ArcBounds(ModelBuilder& model) const;
+		void ArcInvBounds(ModelBuilder& model) const;
+		void ArcCC(ModelBuilder& model) const; // Mar 04 2014 Feedstock Cost curve
+		void ArcCCBounds(ModelBuilder& model) const; // Mar 04 2014 Feedstock Cost curve
+		
+		bool isFirstinYear() const;
+		bool InvArc() const;
+		bool InvertEff() const;
+		bool isDCflow() const;
+		bool isCostCurve() const;
+		bool isStorage() const;
+		bool isBidirect() const;
+		bool isFirstBidirect() const;
+		bool isTransport() const;
+		bool isFirstTransport() const;
+		bool isEnergy2Trans() const;
+	
+	private:
+		const ArcTable* table;
+		int row;
+};
 
 #endif  // _NODE_H_
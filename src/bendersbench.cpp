@@ -0,0 +1,90 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    bendersbench.cpp -- Benchmark of the Benders cut modes
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+// Preprocesses the data in data/ once and solves it with Benders
+// decomposition with each way of building the optimality cuts (single,
+// group and year, without and with Pareto-optimal cuts), recording the
+// iterations, the cuts and the time in bench/benders.csv. The rest of the
+// Benders parameters are the ones in data/parameters.csv.
+
+using namespace std;
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include "netscore.h"
+#include "curve.h"
+#include "pipeline.h"
+#include "solver.h"
+#include <sys/stat.h>
+#include <ilcplex/ilocplex.h>
+ILOSTLBEGIN
+
+// Cut modes compared
+static const char* CutModes[] = { "single", "group", "year" };
+
+int main () {
+	printHeader("run");
+
+	cout << "- Reading global parameters...\n";
+	ReadParameters("data/parameters.csv");
+	useBenders = true;
+	useIncrementalPrep = false;
+	CutPoolSize = 0;
+	outputLevel = 2;
+
+	PrepData Data;
+	ReadInputs(Data);
+	ExpandNetwork(Data);
+
+	cout << endl << "- Building model..." << endl;
+	ModelBuilder model(SLength[0]+1);
+	BuildModel(Data, model);
+	IndexStarts();
+
+	vector<double> events((SLength[0] + IdxCap.size) * (Nevents+1), 0);
+	PrepEvents(Data.Net, &events[0]);
+	Data.Net = ExpandedNetwork();
+
+	mkdir("bench", 0777);
+	ofstream file("bench/benders.csv");
+	if (!file.is_open()) {
+		printError("write", "bench/benders.csv");
+		return 1;
+	}
+	file << "cuts,group,pareto,iterations,master_cuts,wall,cost\n";
+	printf("\ncuts    group  pareto  iterations  master cuts   wall (s)          cost\n");
+
+	for (unsigned int m = 0; m < sizeof(CutModes) / sizeof(CutModes[0]); ++m) {
+		for (int pareto = 0; pareto <= 1; ++pareto) {
+			BendersCuts = CutModes[m];
+			useParetoCuts = (pareto == 1);
+
+			// Each mode starts from a new copy of the problem
+			CPLEX netplan;
+			netplan.LoadProblem(&model);
+
+			double objective[Nobj];
+			double wall = WallTime();
+			netplan.SolveIndividual(objective, &events[0]);
+			wall = WallTime() - wall;
+
+			int group = (BendersCuts == "group") ? BendersCutGroup : ((BendersCuts == "single") ? SLength[0] : 1);
+			file << BendersCuts << "," << group << "," << pareto << "," << netplan.BendersIterations << ","
+				<< netplan.MasterCuts.getSize() << "," << wall << "," << objective[0] << "\n";
+			printf("%-7s %6d %7s %11d %12d %10.2f %13.6g\n", BendersCuts.c_str(), group, pareto ? "yes" : "no",
+				netplan.BendersIterations, (int) netplan.MasterCuts.getSize(), wall, objective[0]);
+			fflush(stdout);
+		}
+	}
+	file.close();
+	cout << "- Results written to 'bench/benders.csv'\n";
+
+	printHeader("completed");
+	return 0;
+}
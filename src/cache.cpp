@@ -0,0 +1,380 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    cache.cpp -- Implementation of the incremental preprocessing cache
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+using namespace std;
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "global.h"
+#include "node.h"
+#include "arc.h"
+#include "network.h"
+#include "model.h"
+#include "index.h"
+#include "csv.h"
+#include "cache.h"
+
+// Contructor for the Hasher class
+Hasher::Hasher() :
+	value(14695981039346656037ULL) {}
+
+// Add some data to the hash
+void Hasher::Add(const void* data, const size_t length) {
+	const unsigned char* bytes = (const unsigned char*) data;
+	for (size_t i = 0; i < length; ++i) {
+		value ^= bytes[i];
+		value *= 1099511628211ULL;
+	}
+}
+
+// Strings are added with their length, so consecutive strings can't be confused
+void Hasher::Add(const string& text) {
+	Add((int) text.size());
+	Add(text.data(), text.size());
+}
+
+void Hasher::Add(const int number) {
+	Add(&number, sizeof(number));
+}
+
+void Hasher::Add(const double number) {
+	Add(&number, sizeof(number));
+}
+
+void Hasher::Add(const unsigned long long number) {
+	Add(&number, sizeof(number));
+}
+
+// Hash of the contents of a file (0 if it can't be read)
+unsigned long long HashFile(const char* fileinput) {
+	int fd = open(fileinput, O_RDONLY);
+	if (fd < 0) return 0;
+	Hasher output;
+	vector<char> buffer(1 << 20);
+	ssize_t length;
+	while ((length = read(fd, &buffer[0], buffer.size())) > 0)
+		output.Add(&buffer[0], length);
+	close(fd);
+	return output.value;
+}
+
+// Hash of the problem written for a Benders block. Rows and columns are
+// hashed by name, since ids depend on the order in which names were found.
+unsigned long long HashBlock(const ModelBuilder& model, const int block) {
+	Hasher output;
+	const ModelBlock& mb = model.blocks[block];
+	output.Add((int) mb.row.size());
+	for (unsigned int r = 0; r < mb.row.size(); ++r) {
+		output.Add(&mb.rowtype[r], 1);
+		output.Add(model.rownames[mb.row[r]]);
+	}
+	output.Add((int) mb.col.size());
+	for (unsigned int c = 0; c < mb.col.size(); ++c) {
+		output.Add(model.colnames[mb.col[c]]);
+		output.Add(mb.start[c+1] - mb.start[c]);
+		for (int e = mb.start[c]; e < mb.start[c+1]; ++e) {
+			output.Add(model.rownames[mb.entryrow[e]]);
+			output.Add(mb.entryvalue[e]);
+		}
+	}
+	output.Add((int) mb.rhsrow.size());
+	for (unsigned int r = 0; r < mb.rhsrow.size(); ++r) {
+		output.Add(model.rownames[mb.rhsrow[r]]);
+		output.Add(mb.rhsvalue[r]);
+	}
+	output.Add((int) mb.boundcol.size());
+	for (unsigned int b = 0; b < mb.boundcol.size(); ++b) {
+		output.Add(&mb.boundtype[b], 1);
+		output.Add(model.colnames[mb.boundcol[b]]);
+		output.Add(mb.boundvalue[b]);
+	}
+	output.Add((int) mb.keeprow.size());
+	for (unsigned int r = 0; r < mb.keeprow.size(); ++r)
+		output.Add(model.rownames[mb.keeprow[r]]);
+	output.Add((int) mb.keepcol.size());
+	for (unsigned int c = 0; c < mb.keepcol.size(); ++c)
+		output.Add(model.colnames[mb.keepcol[c]]);
+	return output.value;
+}
+
+// Hashes of the problems written for each block, and of the full model (last),
+// which takes the elements of all blocks in the stored order
+vector<unsigned long long> HashModel(const ModelBuilder& model) {
+	vector<unsigned long long> output(model.blocks.size() + 1);
+	Hasher full;
+	for (unsigned int b = 0; b < model.blocks.size(); ++b) {
+		output[b] = HashBlock(model, b);
+		full.Add(output[b]);
+	}
+	const vector< pair<int, int> >* order[4] = { &model.fullrows, &model.fullcols, &model.fullrhs, &model.fullbounds };
+	for (int k = 0; k < 4; ++k) {
+		full.Add((int) order[k]->size());
+		for (unsigned int i = 0; i < order[k]->size(); ++i) {
+			full.Add((*order[k])[i].first);
+			full.Add((*order[k])[i].second);
+		}
+	}
+	output.back() = full.value;
+	return output;
+}
+
+// Hash of the contents of an index
+unsigned long long HashIndex(const Index& myindex) {
+	Hasher output;
+	output.Add(myindex.size);
+	for (int i = 0; i < myindex.size; ++i) {
+		output.Add(myindex.position[i]);
+		output.Add(myindex.column[i]);
+		output.Add(myindex.year[i]);
+		output.Add(myindex.name[i]);
+	}
+	return output.value;
+}
+
+// Hashes of the codes ('num_fields' first columns) and of each whole row of a
+// properties file. Numeric properties are only kept in 'numbers'.
+void HashProperties(const MatrixStr& text, const MatrixNum* numbers, const int num_fields,
+	vector<unsigned long long>& keys, vector<unsigned long long>& rows) {
+	keys.resize(text.size());
+	rows.resize(text.size());
+	for (unsigned int r = 0; r < text.size(); ++r) {
+		Hasher key;
+		for (unsigned int k = 0; (k < (unsigned int) num_fields) && (k < text[r].size()); ++k)
+			key.Add(text[r][k]);
+		keys[r] = key.value;
+
+		Hasher row = key;
+		for (unsigned int k = num_fields; k < text[r].size(); ++k)
+			row.Add(text[r][k]);
+		if ((numbers != NULL) && (r < numbers->size()))
+			for (unsigned int k = 0; k < (*numbers)[r].size(); ++k)
+				row.Add((*numbers)[r][k]);
+		rows[r] = row.value;
+	}
+}
+
+
+// Read the manifest of a previous run (false if it doesn't exist)
+bool PrepManifest::Read(const char* fileinput) {
+	inputs.clear();
+	outputs.clear();
+	CsvReader file;
+	if (!file.Open(fileinput)) return false;
+	while (file.NextLine()) {
+		if ((file.First() == '%') || (file.size() < 3)) continue;
+		unsigned long long hash = strtoull(file.Get(2).c_str(), NULL, 16);
+		if (file.Get(0) == "input") inputs[file.Get(1)] = hash;
+		else if (file.Get(0) == "output") outputs[file.Get(1)] = hash;
+	}
+	return true;
+}
+
+// Write the manifest
+void PrepManifest::Write(const char* fileinput) const {
+	FILE* file = fopen(fileinput, "w");
+	if (file == NULL) {
+		printError("error", fileinput);
+		return;
+	}
+	fprintf(file, "%% Files read and written by the preprocessor (kind,file,hash)\n");
+	for (map<string, unsigned long long>::const_iterator it = inputs.begin(); it != inputs.end(); ++it)
+		fprintf(file, "input,%s,%016llx\n", it->first.c_str(), it->second);
+	for (map<string, unsigned long long>::const_iterator it = outputs.begin(); it != outputs.end(); ++it)
+		fprintf(file, "output,%s,%016llx\n", it->first.c_str(), it->second);
+	fclose(file);
+}
+
+
+// Binary storage of vectors, strings and tables (each vector starts with its size)
+template <class T>
+static void SaveVector(FILE* file, const vector<T>& input) {
+	int length = input.size();
+	fwrite(&length, sizeof(int), 1, file);
+	if (length > 0) fwrite(&input[0], sizeof(T), length, file);
+}
+
+template <class T>
+static bool LoadVector(FILE* file, vector<T>& output) {
+	int length;
+	if ((fread(&length, sizeof(int), 1, file) != 1) || (length < 0)) return false;
+	output.resize(length);
+	return (length == 0) || (fread(&output[0], sizeof(T), length, file) == (size_t) length);
+}
+
+static void SaveString(FILE* file, const string& input) {
+	int length = input.size();
+	fwrite(&length, sizeof(int), 1, file);
+	fwrite(input.data(), 1, length, file);
+}
+
+static bool LoadString(FILE* file, string& output, vector<char>& buffer) {
+	int length;
+	if ((fread(&length, sizeof(int), 1, file) != 1) || (length < 0)) return false;
+	buffer.resize(length + 1);
+	if (fread(&buffer[0], 1, length, file) != (size_t) length) return false;
+	output.assign(&buffer[0], length);
+	return true;
+}
+
+static void SavePool(FILE* file, const StringPool& pool) {
+	int length = pool.size();
+	fwrite(&length, sizeof(int), 1, file);
+	for (int i = 0; i < length; ++i) SaveString(file, pool[i]);
+}
+
+// Strings are added in the same order, so they keep their ids
+static bool LoadPool(FILE* file, StringPool& pool, vector<char>& buffer) {
+	int length;
+	if ((fread(&length, sizeof(int), 1, file) != 1) || (length < 0)) return false;
+	string text;
+	for (int i = 0; i < length; ++i) {
+		if (!LoadString(file, text, buffer)) return false;
+		pool.Add(text);
+	}
+	return true;
+}
+
+// Columns of a node or arc table (they must have the same properties)
+template <class T>
+static void SaveColumns(FILE* file, const vector< vector<T> >& input) {
+	int length = input.size();
+	fwrite(&length, sizeof(int), 1, file);
+	for (int s = 0; s < length; ++s) SaveVector(file, input[s]);
+}
+
+template <class T>
+static bool LoadColumns(FILE* file, vector< vector<T> >& output) {
+	int length;
+	if ((fread(&length, sizeof(int), 1, file) != 1) || (length < 0) || ((size_t) length != output.size())) return false;
+	for (int s = 0; s < length; ++s)
+		if (!LoadVector(file, output[s])) return false;
+	return true;
+}
+
+static void SaveIndex(FILE* file, const Index& myindex) {
+	SaveVector(file, myindex.position);
+	SaveVector(file, myindex.column);
+	SaveVector(file, myindex.year);
+	for (int i = 0; i < myindex.size; ++i) SaveString(file, myindex.name[i]);
+}
+
+static bool LoadIndex(FILE* file, Index& myindex, vector<char>& buffer) {
+	myindex = Index();
+	if (!LoadVector(file, myindex.position) || !LoadVector(file, myindex.column) || !LoadVector(file, myindex.year))
+		return false;
+	myindex.size = myindex.position.size();
+	myindex.name.resize(myindex.size);
+	for (int i = 0; i < myindex.size; ++i)
+		if (!LoadString(file, myindex.name[i], buffer)) return false;
+	return true;
+}
+
+
+// Read the cache of a previous run, with its network and indices (false if
+// it doesn't exist or it's not valid)
+bool PrepCache::Load(const char* fileinput, ExpandedNetwork& net, Index* idx[]) {
+	Clear();
+	FILE* file = fopen(fileinput, "rb");
+	if (file == NULL) return false;
+
+	char magic[8];
+	int version = 0, nfiles = 0;
+	bool output = (fread(magic, 1, 8, file) == 8) && (memcmp(magic, PREP_CACHE_MAGIC, 8) == 0);
+	output = output && (fread(&version, sizeof(int), 1, file) == 1) && (version == PREP_CACHE_VERSION);
+	output = output && (fread(&nfiles, sizeof(int), 1, file) == 1) && (nfiles >= 0);
+	if (output) {
+		keys.resize(nfiles);
+		rows.resize(nfiles);
+	}
+	for (int f = 0; output && (f < nfiles); ++f)
+		output = LoadVector(file, keys[f]) && LoadVector(file, rows[f]);
+	output = output && LoadVector(file, ends) && LoadVector(file, usestart);
+	output = output && LoadVector(file, usefile) && LoadVector(file, userow);
+
+	vector<char> buffer;
+	net = ExpandedNetwork();
+	output = output && LoadPool(file, net.nodes.pool, buffer) && LoadColumns(file, net.nodes.codes);
+	output = output && LoadColumns(file, net.nodes.values) && LoadVector(file, net.nodes.year) && LoadVector(file, net.nodes.flags);
+	output = output && LoadPool(file, net.arcs.pool, buffer) && LoadColumns(file, net.arcs.codes);
+	output = output && LoadColumns(file, net.arcs.values) && LoadVector(file, net.arcs.year) && LoadVector(file, net.arcs.flags);
+	output = output && LoadVector(file, net.arcs.t2e) && LoadVector(file, net.arcs.t2e_scale) && LoadVector(file, net.arcs.couple_key);
+	output = output && LoadVector(file, net.arcs.couple_start) && LoadVector(file, net.arcs.couple_node) && LoadVector(file, net.arcs.couple_value);
+	output = output && LoadVector(file, net.arcs.cc_start) && LoadVector(file, net.arcs.cc_width) && LoadVector(file, net.arcs.cc_cost);
+	if (output) net.arcs.IndexCouplings();
+	for (int t = 0; output && (t < PREP_TABLES - 2); ++t)
+		output = LoadIndex(file, *idx[t], buffer);
+	fclose(file);
+
+	if (output) {
+		net.FindDC();
+	} else {
+		Clear();
+		net = ExpandedNetwork();
+		for (int t = 0; t < PREP_TABLES - 2; ++t) *idx[t] = Index();
+	}
+	return output;
+}
+
+// Write the cache, with the network and indices
+void PrepCache::Save(const char* fileinput, const ExpandedNetwork& net, Index* idx[]) const {
+	FILE* file = fopen(fileinput, "wb");
+	if (file == NULL) {
+		printError("error", fileinput);
+		return;
+	}
+
+	int version = PREP_CACHE_VERSION, nfiles = keys.size();
+	fwrite(PREP_CACHE_MAGIC, 1, 8, file);
+	fwrite(&version, sizeof(int), 1, file);
+	fwrite(&nfiles, sizeof(int), 1, file);
+	for (int f = 0; f < nfiles; ++f) {
+		SaveVector(file, keys[f]);
+		SaveVector(file, rows[f]);
+	}
+	SaveVector(file, ends);
+	SaveVector(file, usestart);
+	SaveVector(file, usefile);
+	SaveVector(file, userow);
+
+	SavePool(file, net.nodes.pool);
+	SaveColumns(file, net.nodes.codes);
+	SaveColumns(file, net.nodes.values);
+	SaveVector(file, net.nodes.year);
+	SaveVector(file, net.nodes.flags);
+	SavePool(file, net.arcs.pool);
+	SaveColumns(file, net.arcs.codes);
+	SaveColumns(file, net.arcs.values);
+	SaveVector(file, net.arcs.year);
+	SaveVector(file, net.arcs.flags);
+	SaveVector(file, net.arcs.t2e);
+	SaveVector(file, net.arcs.t2e_scale);
+	SaveVector(file, net.arcs.couple_key);
+	SaveVector(file, net.arcs.couple_start);
+	SaveVector(file, net.arcs.couple_node);
+	SaveVector(file, net.arcs.couple_value);
+	SaveVector(file, net.arcs.cc_start);
+	SaveVector(file, net.arcs.cc_width);
+	SaveVector(file, net.arcs.cc_cost);
+	for (int t = 0; t < PREP_TABLES - 2; ++t)
+		SaveIndex(file, *idx[t]);
+	fclose(file);
+}
+
+void PrepCache::Clear() {
+	keys.clear();
+	rows.clear();
+	ends.clear();
+	usestart.clear();
+	usefile.clear();
+	userow.clear();
+}
@@ -0,0 +1,74 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    cache.h -- Definition of the incremental preprocessing cache
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+#ifndef _CACHE_H_
+#define _CACHE_H_
+
+// Tables filled by the expansion of the lists: nodes, arcs and the indices
+// IdxNode, IdxUd, IdxRm, IdxDc, IdxArc, IdxInv, IdxNsga, IdxUb and IdxCap
+#define PREP_TABLES 11
+
+#define PREP_CACHE_MAGIC "NETSCPRE"
+#define PREP_CACHE_VERSION 3
+
+// Declare class type to compute a 64-bit hash (FNV-1a) of some data
+class Hasher {
+	public:
+		Hasher();
+		void Add(const void* data, const size_t length);
+		void Add(const string& text);
+		void Add(const int number);
+		void Add(const double number);
+		void Add(const unsigned long long number);
+
+		unsigned long long value;
+};
+
+// Hash of the contents of a file (0 if it can't be read)
+unsigned long long HashFile(const char* fileinput);
+
+// Hashes of the problems written for a Benders block, and for each of them
+// and the full model (last)
+unsigned long long HashBlock(const ModelBuilder& model, const int block);
+vector<unsigned long long> HashModel(const ModelBuilder& model);
+
+// Hash of the contents of an index
+unsigned long long HashIndex(const Index& myindex);
+
+// Hashes of the codes and of each row of a properties file
+void HashProperties(const MatrixStr& text, const MatrixNum* numbers, const int num_fields,
+	vector<unsigned long long>& keys, vector<unsigned long long>& rows);
+
+// Declare class type to store the hashes of the files read and written by the
+// preprocessor (prepdata/manifest.csv, with lines 'input,file,hash' or 'output,file,hash')
+class PrepManifest {
+	public:
+		bool Read(const char* fileinput);
+		void Write(const char* fileinput) const;
+
+		map<string, unsigned long long> inputs, outputs;
+};
+
+// Declare class type to store the expansion of the previous run
+// (prepdata/prep_cache.bin), so only the list entities whose property rows
+// changed have to be expanded again.
+class PrepCache {
+	public:
+		bool Load(const char* fileinput, ExpandedNetwork& net, Index* idx[]);
+		void Save(const char* fileinput, const ExpandedNetwork& net, Index* idx[]) const;
+		void Clear();
+
+		// Hashes of the codes and of the whole row, for each row of each properties file
+		vector< vector<unsigned long long> > keys, rows;
+
+		// For each list entity (nodes first, then arcs): where its rows end in
+		// each table (PREP_TABLES numbers per entity), and the rows of properties
+		// files it used (file and row, from usestart[e] to usestart[e+1]-1)
+		vector<int> ends, usestart, usefile, userow;
+};
+
+#endif  // _CACHE_H_
@@ -0,0 +1,125 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    csv.cpp -- Implementation of the CSV file reader
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+using namespace std;
+#include <iostream>
+#include <string>
+#include <vector>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "csv.h"
+
+// First position from 'begin' to 'end' with any of the characters 'a', 'b'
+// or 'c' ('end' if there isn't any). With SSE2, 16 characters are compared
+// at a time.
+static const char* FindAny(const char* begin, const char* end, const char a, const char b, const char c) {
+#ifdef __SSE2__
+	__m128i va = _mm_set1_epi8(a), vb = _mm_set1_epi8(b), vc = _mm_set1_epi8(c);
+	while (end - begin >= 16) {
+		__m128i block = _mm_loadu_si128((const __m128i*) begin);
+		__m128i found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, va), _mm_cmpeq_epi8(block, vb)), _mm_cmpeq_epi8(block, vc));
+		int mask = _mm_movemask_epi8(found);
+		if (mask != 0) return begin + __builtin_ctz(mask);
+		begin += 16;
+	}
+#endif
+	while ((begin < end) && (*begin != a) && (*begin != b) && (*begin != c)) ++begin;
+	return begin;
+}
+
+// Contructor and destructor for the CsvReader class
+CsvReader::CsvReader() :
+	data(NULL), next(NULL), end(NULL), line(NULL), lineend(NULL), length(0) {}
+
+CsvReader::~CsvReader() {
+	Close();
+}
+
+// Map a file in memory (false if it can't be opened)
+bool CsvReader::Open(const char* fileinput) {
+	Close();
+	int fd = open(fileinput, O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat info;
+	bool output = (fstat(fd, &info) == 0);
+	if (output && (info.st_size > 0)) {
+		length = info.st_size;
+		void* map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map == MAP_FAILED) {
+			length = 0;
+			output = false;
+		} else {
+			data = (const char*) map;
+			madvise(map, length, MADV_SEQUENTIAL);
+		}
+	}
+	close(fd);
+	next = data;
+	end = data + length;
+	return output;
+}
+
+// Release the memory map
+void CsvReader::Close() {
+	if (data != NULL) munmap((void*) data, length);
+	data = next = end = line = lineend = NULL;
+	length = 0;
+	fieldstart.clear();
+	fieldend.clear();
+}
+
+// Move to the next line, remove its comments and split it in fields
+bool CsvReader::NextLine() {
+	if (next >= end) return false;
+	line = next;
+	const char* newline = (const char*) memchr(next, '\n', end - next);
+	lineend = (newline != NULL) ? newline : end;
+	next = (newline != NULL) ? newline + 1 : end;
+
+	// The line ends at the first space, '%' or '\r' after its beginning
+	const char* clean = line;
+	while ((clean < lineend) && ((*clean == ' ') || (*clean == '%'))) ++clean;
+	lineend = FindAny(clean, lineend, ' ', '%', '\r');
+
+	fieldstart.clear();
+	fieldend.clear();
+	const char* start = line;
+	while (start < lineend) {
+		const char* comma = FindAny(start, lineend, ',', ',', ',');
+		fieldstart.push_back(start);
+		fieldend.push_back(comma);
+		start = (comma < lineend) ? comma + 1 : comma;
+	}
+	return true;
+}
+
+char CsvReader::First() const {
+	return (line < lineend) ? *line : '\0';
+}
+
+int CsvReader::size() const {
+	return fieldstart.size();
+}
+
+const char* CsvReader::Field(const int k) const {
+	return fieldstart[k];
+}
+
+int CsvReader::Length(const int k) const {
+	return fieldend[k] - fieldstart[k];
+}
+
+string CsvReader::Get(const int k) const {
+	return string(fieldstart[k], fieldend[k]);
+}
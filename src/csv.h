@@ -0,0 +1,50 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    csv.h -- Definition of the CSV file reader
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+#ifndef _CSV_H_
+#define _CSV_H_
+
+// Declare class type to read the lines and fields of a CSV file. The file
+// is mapped in memory, so lines can be of any length and fields point to
+// the file instead of being copied. Each line is cleaned like 'CleanLine'
+// does: it ends at the first space or '%' after its beginning, so comments
+// are removed (lines that start with '%' are kept for the callers to skip).
+// Fields are split like 'strcspn' does: empty fields are kept, but a comma
+// at the end of the line doesn't start a new one.
+class CsvReader {
+	public:
+		CsvReader();
+		~CsvReader();
+
+		bool Open(const char* fileinput);
+		void Close();
+
+		// Move to the next line (false at the end of the file)
+		bool NextLine();
+
+		// First character of the line ('\0' if it's empty)
+		char First() const;
+
+		// Fields of the line
+		int size() const;
+		const char* Field(const int k) const;
+		int Length(const int k) const;
+		string Get(const int k) const;
+
+	private:
+		CsvReader(const CsvReader& rhs);
+		CsvReader& operator=(const CsvReader& rhs);
+
+		const char *data, *next, *end;
+		const char *line, *lineend;
+		size_t length;
+
+		// Beginning and end of each field in the line
+		vector<const char*> fieldstart, fieldend;
+};
+
+#endif  // _CSV_H_
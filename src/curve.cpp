@@ -0,0 +1,143 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    curve.cpp -- Implementation of the cost curves of the arcs
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+using namespace std;
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include "global.h"
+#include "read.h"
+#include "csv.h"
+#include "matcher.h"
+#include "curve.h"
+
+bool CostCurveData::Read(const char* fileinput) {
+	CsvReader file;
+	if (!file.Open(fileinput)) return false;
+	files.push_back(fileinput);
+	int num_values = Step2Pos(SLength) + 1;
+
+	bool header = true;
+	while (file.NextLine()) {
+		if ((file.First() == '%') || (file.First() == '\0')) continue;
+		if (header) {
+			header = false;
+			continue;
+		}
+		if ((file.size() < 4) || (file.Length(0) == 0) || (file.Length(3) == 0)) continue;
+
+		vector<int> positions = StepPositions(file.Get(2), 0, num_values);
+		if (positions.empty()) {
+			printError("curvestep", file.Get(2));
+			continue;
+		}
+		int k = Key(file.Get(0), file.Get(1));
+		int s = Segment(k, atoi(file.Get(3).c_str()));
+		if ((file.size() > 4) && (file.Length(4) != 0)) {
+			double value = Str2Num(file.Get(4));
+			for (unsigned int m = 0; m < positions.size(); ++m) breakpoint[k][s][positions[m]] = value;
+		}
+		if ((file.size() > 5) && (file.Length(5) != 0)) {
+			double value = Str2Num(file.Get(5));
+			for (unsigned int m = 0; m < positions.size(); ++m) cost[k][s][positions[m]] = value;
+		}
+	}
+	matcher.Build(keys, 2);
+	return true;
+}
+
+void CostCurveData::ReadSegmentFiles(const vector<string>& breakpoints, const vector<string>& costs) {
+	int n = breakpoints.size();
+	vector<MatrixStr> BText(n), CText(n);
+	vector<MatrixNum> BNum(n), CNum(n);
+	vector<CodeMatcher> BMatch(n), CMatch(n);
+	for (int j = 0; j < n; ++j) {
+		BText[j] = ReadProperties(breakpoints[j].c_str(), "Inf", 2, &BMatch[j], &BNum[j]);
+		CText[j] = ReadProperties(costs[j].c_str(), "0", 2, &CMatch[j], &CNum[j]);
+		files.push_back(breakpoints[j]);
+		files.push_back(costs[j]);
+	}
+	if (n == 0) return;
+
+	// Segments without a row are unbounded and free, as the properties were
+	int num_values = Step2Pos(SLength) + 1;
+	for (unsigned int r = 0; r < BText[0].size(); ++r) {
+		const string& strfrom = BText[0][r][0];
+		const string& strto = BText[0][r][1];
+		int k = Key(strfrom, strto);
+		for (int j = 0; j < n; ++j) {
+			int s = Segment(k, j + 1);
+			int rb = BMatch[j].Find(strfrom, strto);
+			int rc = CMatch[j].Find(strfrom, strto);
+			for (int m = 0; m < num_values; ++m) {
+				breakpoint[k][s][m] = (rb >= 0) ? BNum[j][rb][m+2] : INFINITY;
+				cost[k][s][m] = (rc >= 0) ? CNum[j][rc][m+2] : 0;
+			}
+		}
+	}
+	matcher.Build(keys, 2);
+}
+
+void CostCurveData::Segments(const int k, const int pos, vector<double>& width, vector<double>& cost) const {
+	width.clear();
+	cost.clear();
+
+	// Breakpoints in order (segments with the same one keep their order)
+	vector< pair<double, int> > order(0);
+	for (unsigned int s = 0; s < segment[k].size(); ++s)
+		if (!isnan(breakpoint[k][s][pos])) order.push_back(make_pair(breakpoint[k][s][pos], s));
+	sort(order.begin(), order.end());
+
+	double previous = 0;
+	for (unsigned int i = 0; i < order.size(); ++i) {
+		double mywidth = order[i].first - previous;
+		double mycost = this->cost[k][order[i].second][pos];
+		previous = order[i].first;
+		if ((mywidth == 0) || isnan(mywidth)) continue;
+		if (!cost.empty() && (cost.back() == mycost))
+			width.back() += mywidth;
+		else {
+			width.push_back(mywidth);
+			cost.push_back(mycost);
+		}
+	}
+}
+
+// Curve with some codes (a new one if there's none)
+int CostCurveData::Key(const string& strfrom, const string& strto) {
+	pair<string, string> mykey(strfrom, strto);
+	map< pair<string, string>, int >::iterator it = lookup.find(mykey);
+	if (it != lookup.end()) return it->second;
+
+	int k = keys.size();
+	VectorStr codes(2);
+	codes[0] = strfrom;
+	codes[1] = strto;
+	keys.push_back(codes);
+	segment.push_back(vector<int>(0));
+	breakpoint.push_back(vector< vector<double> >(0));
+	cost.push_back(vector< vector<double> >(0));
+	lookup[mykey] = k;
+	return k;
+}
+
+// Segment of a curve with some id (a new one, without breakpoints, if there's none)
+int CostCurveData::Segment(const int k, const int id) {
+	vector<int>::iterator it = lower_bound(segment[k].begin(), segment[k].end(), id);
+	int s = it - segment[k].begin();
+	if ((it != segment[k].end()) && (*it == id)) return s;
+
+	int num_values = Step2Pos(SLength) + 1;
+	segment[k].insert(it, id);
+	breakpoint[k].insert(breakpoint[k].begin() + s, vector<double>(num_values, NAN));
+	cost[k].insert(cost[k].begin() + s, vector<double>(num_values, 0));
+	return s;
+}
@@ -0,0 +1,49 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    curve.h -- Definition of the cost curves of the arcs
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+#ifndef _CURVE_H_
+#define _CURVE_H_
+
+// Declare class type to store the piecewise-linear cost curves of the arcs
+// (such as biomass feedstock). Each curve belongs to the arcs that match its
+// codes (like a row of a properties file) and has any number of segments,
+// each with a breakpoint (quantity per hour at its end, cumulative) and a
+// cost for every step position.
+class CostCurveData {
+	public:
+		// Read a file with lines 'from,to,step,segment,breakpoint,cost'. The
+		// step can be 'const' or any step of a properties file header, and
+		// later lines overwrite earlier ones (false if it can't be opened).
+		bool Read(const char* fileinput);
+
+		// Read the files with one breakpoint and one cost per segment
+		// (arcs_OpMaxc#.csv and arcs_OpCostc#.csv), with the curves given
+		// by the rows of the first breakpoints file
+		void ReadSegmentFiles(const vector<string>& breakpoints, const vector<string>& costs);
+
+		// Segments of curve 'k' in a step position, sorted by breakpoint.
+		// Empty segments are dropped and the ones next to each other with the
+		// same cost are merged, so each one gives a column of the model.
+		void Segments(const int k, const int pos, vector<double>& width, vector<double>& cost) const;
+
+		// Codes of the curves (from, to) and files read
+		MatrixStr keys;
+		CodeMatcher matcher;
+		vector<string> files;
+
+	private:
+		int Key(const string& strfrom, const string& strto);
+		int Segment(const int k, const int id);
+
+		// For each curve, its segments (in order of id) and, for each
+		// segment, its breakpoint (NaN if not given) and cost in each position
+		vector< vector<int> > segment;
+		vector< vector< vector<double> > > breakpoint, cost;
+		map< pair<string, string>, int > lookup;
+};
+
+#endif  // _CURVE_H_
@@ -0,0 +1,57 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    factor.cpp -- Implementation of the yearly factor tables
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+using namespace std;
+#include <string>
+#include <vector>
+#include <map>
+#include <math.h>
+#include "global.h"
+#include "factor.h"
+
+FactorTable::FactorTable() :
+	lastfactor(1), last(NULL) {}
+
+// Powers of a factor, multiplied year after year (as the factors were
+// compounded step by step, so results don't change)
+const double* FactorTable::Compound(const double factor) {
+	if ((last != NULL) && (factor == lastfactor)) return last;
+
+	vector<double>* output = &invalid;
+	if (!isnan(factor)) output = &compound[factor];
+	if (output->empty()) {
+		output->assign(SLength[0] + 1, 1);
+		for (int y = 2; y <= SLength[0]; ++y)
+			(*output)[y] = (*output)[y-1] * factor;
+	}
+	lastfactor = factor;
+	last = &(*output)[0];
+	return last;
+}
+
+const double* FactorTable::Growth(const double rate) {
+	return Compound(1 + rate);
+}
+
+const double* FactorTable::Dollar(const double inflation, const double discount) {
+	return Compound((1 + inflation) / (1 + discount));
+}
+
+const double* FactorTable::Salvage(const string& life) {
+	if (life == "X") return NULL;
+
+	vector<double>& output = salvage[life];
+	if (output.empty()) {
+		int life_inv = Str2Step(life)[0];
+		output.assign(SLength[0] + 1, 1);
+		for (int y = 1; y <= SLength[0]; ++y) {
+			int years_left = (SLength[0] + 1) - y;
+			if (years_left < life_inv) output[y] = (double) years_left / life_inv;
+		}
+	}
+	return &output[0];
+}
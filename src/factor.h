@@ -0,0 +1,42 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    factor.h -- Definition of the yearly factor tables
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+#ifndef _FACTOR_H_
+#define _FACTOR_H_
+
+// Declare class type to store the factors that only depend on the year of a
+// step, as arrays indexed by year (1 to SLength[0]). Each array is computed
+// the first time it's asked for and then shared by all the nodes and arcs
+// with the same rates. Tables aren't shared between threads.
+class FactorTable {
+	public:
+		FactorTable();
+
+		// Growth of a yearly rate: (1 + rate)^(year-1)
+		const double* Growth(const double rate);
+
+		// Value of money: ((1 + inflation) / (1 + discount))^(year-1)
+		const double* Dollar(const double inflation, const double discount);
+
+		// Part of an investment with a life span of 'life' years that is used
+		// by the end of the simulation period (1 if the life span is shorter
+		// than the years left), or NULL if there's no life span ('X')
+		const double* Salvage(const string& life);
+
+	private:
+		const double* Compound(const double factor);
+
+		map<double, vector<double> > compound;
+		map<string, vector<double> > salvage;
+		vector<double> invalid;
+
+		// Last array returned by 'Compound', which is usually asked for again
+		double lastfactor;
+		const double* last;
+};
+
+#endif  // _FACTOR_H_
@@ -9,16 +9,24 @@ using namespace std;
 #include <iostream>
 #include <fstream>
 #include <string.h>// May 26 2013
+#include <stdio.h>
+#include <stdlib.h>
 #include <time.h>
+#include <sys/time.h>
 #include <math.h>
 extern int outputLevel;
 time_t startTime, endTime;
+struct timeval startWall; // Elapsed time with sub-second resolution
 
 // Print error messages
 void printError(const string& selector, const char* fileinput) {
 	if (selector == "warning") {
 		if (outputLevel < 3)
 			cout << "\tWarning: File '" << fileinput << "' not found!\n";
+	} else if (selector == "modelfile") {
+		cout << "\tERROR: File '" << fileinput << "' is not a valid binary model!\n";
+	} else if (selector == "write") {
+		cout << "\tERROR: File '" << fileinput << "' can't be written!\n";
 	} else
 		cout << "\tERROR: File '" << fileinput << "' not found!\n";
 }
@@ -31,6 +39,7 @@ void printError(const string& selector, const string& field) {
 	else if (selector == "nodestep")  cout << "\tERROR: Node '" << field << "' without defined step\n";
 	else if (selector == "arcstep")   cout << "\tERROR: Arc '" << field << "' without defined step\n";
 	else if (selector == "parameter") cout << "\tERROR: General parameter '" << field << "' caused a problem\n";
+	else if (selector == "curvestep") cout << "\tERROR: Invalid step '" << field << "' in a cost curve\n";
 	else                              cout << "\tERROR and error code '" << selector << "' not defined\n";
 }
 
@@ -63,6 +72,13 @@ void printHeader(const string& selector) {
 		cout << "|     NSGA-II post-processing module     |" << endl;
 		cout << "==========================================" << endl;
 		printHeader("time");
+	} else if (selector == "run") {
+		cout << endl;
+		cout << "==========================================" << endl;
+		cout << "|  NETSCORE-21 Long-term planning model  |" << endl;
+		cout << "|      Preprocessing and solver run      |" << endl;
+		cout << "==========================================" << endl;
+		printHeader("time");
 	} else if (selector == "benders") {
 		cout << endl;
 		cout << "==========================================" << endl;
@@ -90,10 +106,13 @@ void printHeader(const string& selector) {
 		cout << "===========  Process completed  ==========" << endl << endl;
 	} else if (selector == "time") {
 		time(&startTime);
+		gettimeofday(&startWall, NULL);
 		cout << "  Current time: " << ctime(&startTime) << endl;
 	} else if (selector == "elapsed") {
 		time(&endTime);
-		double difTime = difftime (endTime,startTime);
+		struct timeval endWall;
+		gettimeofday(&endWall, NULL);
+		double difTime = (endWall.tv_sec - startWall.tv_sec) + (endWall.tv_usec - startWall.tv_usec) * 1e-6;
 		double hours = floor(difTime/3600), mins = floor(difTime/60) - hours * 60;
 		difTime -= hours * 3600 + mins * 60;
 		cout << "  Current time: " << ctime(&endTime);
@@ -112,3 +131,43 @@ void CleanLine(char* line) {
 	char *nlptr2 = strchr(line, '\r');
 	if (nlptr2) *nlptr2 = '\0';
 }
+
+// Convert a property value to a number. Missing values ('X') are stored as NaN
+// and 'Inf' as an infinite value, so the original meaning is kept.
+double Str2Num(const string& input) {
+	if (input == "X") return NAN;
+	return atof(input.c_str());
+}
+
+// Convert a property value back to text, with enough digits to recover the number.
+// 'output' must have room for 32 characters; the length of the text is returned.
+int Num2Chars(char* output, const double input) {
+	if (input != input) return sprintf(output, "X");
+	if (isinf(input)) return sprintf(output, (input > 0) ? "Inf" : "-Inf");
+	
+	// Whole numbers (most coefficients of the model) are written directly
+	if ((input == floor(input)) && (fabs(input) < 1e15)) {
+		char digits[20];
+		long long value = (long long) fabs(input);
+		int n = 0, length = 0;
+		do {
+			digits[n++] = '0' + (value % 10);
+			value /= 10;
+		} while (value > 0);
+		if (input < 0) output[length++] = '-';
+		while (n > 0) output[length++] = digits[--n];
+		output[length] = '\0';
+		return length;
+	}
+	
+	int length = snprintf(output, 32, "%.15g", input);
+	if (strtod(output, NULL) != input)
+		length = snprintf(output, 32, "%.17g", input);
+	return length;
+}
+
+string Num2Str(const double input) {
+	char buffer[32];
+	int length = Num2Chars(buffer, input);
+	return string(buffer, length);
+}
@@ -12,21 +12,35 @@
 #include <sstream>
 #include "step.h"
 #include "index.h"
+#include "schema.h"
+#include "profile.h"
 
 // Type definitions
 typedef vector<string> VectorStr;
 typedef vector<VectorStr> MatrixStr;
+typedef vector<double> VectorNum;
+typedef vector<VectorNum> MatrixNum;
 
 // Global variables
 extern string SName;
 extern Step SLength, steplife;
-extern bool useDCflow, useBenders, useEndSalvg, useEndPrimE, useEndDualE, useEndFixed;// Venkat End effect Apr 12 2013
+extern bool useDCflow, useBenders, useCompressMPS, useEndSalvg, useEndPrimE, useEndDualE, useEndFixed, useIncrementalPrep, useModelReduction, usePruneFleets;// Venkat End effect Apr 12 2013
 extern string DefStep, StorageCode, DCCode, TransStep, TransDummy, TransCoal;
 extern int Npopsize, Nngen, Nobj, Nevents;
 extern string Npcross_real, Npmut_real, Neta_c, Neta_m, Npcross_bin, Npmut_bin, Nstages;
 extern double Np_start, Loadgrowth, CapRed, Sobjeval, cofire;
-extern vector<string> ArcProp, ArcDefault, NodeProp, NodeDefault, TransInfra, TransComm, StepHours, SustObj, SustMet;
+extern vector<string> TransInfra, TransComm, StepHours, SustObj, SustMet;
+// Property names, defaults and storage slots for nodes and arcs
+extern Schema NodeSchema, ArcSchema;
 extern int NodePropOffset, ArcPropOffset, outputLevel, SLengthend, life_more, segmnt; // April 17 2013 End effect
+extern int PrepThreads, SolverThreads, SubproblemWorkers;
+extern int CutPoolSize, CutPoolAge, BendersCutGroup, BasisStore;
+extern bool useParetoCuts;
+extern string BendersMode, BendersCore, BendersCuts;
+extern double BendersGap, BendersTrustRadius, BendersLevel, BendersInOutWeight;
+extern string ScenarioFile;
+// Phases measured by the preprocessor
+extern PhaseProfiler Profile;
 // Store indices to recover data after optimization
 extern Index IdxNode, IdxUd, IdxRm, IdxArc, IdxInv, IdxCap, IdxUb, IdxEm, IdxDc, IdxNsga, IdxHo;// end effects
 
@@ -40,6 +54,11 @@ void printHeader(const string& selector);
 // Remove comments and end of line characters
 void CleanLine(char* line);
 
+// Convert a property value to a number ('X' is stored as NaN) and back
+double Str2Num(const string& input);
+string Num2Str(const double input);
+int Num2Chars(char* output, const double input);
+
 // Convert a value to a string
 template <class T>
 string ToString(T t) {
@@ -49,6 +49,25 @@ void Index::Add(const int newpos, const Step& newcol, const string& newname) {
 	Add(newpos, Step2Col(newcol), newcol[0], newname);
 }
 
+// Add all the elements of another index at the end
+void Index::Append(const Index& rhs) {
+	position.insert(position.end(), rhs.position.begin(), rhs.position.end());
+	column.insert(column.end(), rhs.column.begin(), rhs.column.end());
+	year.insert(year.end(), rhs.year.begin(), rhs.year.end());
+	name.insert(name.end(), rhs.name.begin(), rhs.name.end());
+	size += rhs.size;
+}
+
+// Overwrite the elements from 'first' on with the elements of another index
+void Index::Replace(const int first, const Index& rhs) {
+	for (int i = 0; i < rhs.size; ++i) {
+		position[first + i] = rhs.position[i];
+		column[first + i] = rhs.column[i];
+		year[first + i] = rhs.year[i];
+		name[first + i] = rhs.name[i];
+	}
+}
+
 // Write a file
 void Index::WriteFile(const char* fileinput) const {
 	ofstream myfile;
@@ -104,7 +123,11 @@ void ImportIndices() {
 	IdxEm   = ReadFile("prepdata/idx_em.csv");
 	IdxDc   = ReadFile("prepdata/idx_dc.csv");
 	IdxHo   = ReadFile("prepdata/idx_ho.csv");// end effects
-	
+	IndexStarts();
+}
+
+// Position of the variables of each index in the solution vector
+void IndexStarts() {
 	IdxCap.start = 0;
 	IdxInv.start = IdxCap.start + IdxCap.size;
 	IdxEm.start  = IdxInv.start + IdxInv.size;
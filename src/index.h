@@ -18,6 +18,8 @@ class Index {
 		
 		void Add(const int newpos, const int newcol, const int newyear, const string& newname);
 		void Add(const int newpos, const Step& newcol, const string& newname);
+		void Append(const Index& rhs);
+		void Replace(const int first, const Index& rhs);
 		void WriteFile(const char* fileinput) const;
 		
 		// Variables
@@ -30,5 +32,6 @@ class Index {
 
 Index ReadFile(const char* fileinput);
 void ImportIndices();
+void IndexStarts();
 
 #endif  // _INDEX_H_
@@ -0,0 +1,104 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    matcher.cpp -- Implementation of the code matcher
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+using namespace std;
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include "global.h"
+#include "matcher.h"
+
+// Kind of match for each combination of 'from' and 'to' keys. The keys are
+// tried in the same order as 'FindCode': the whole code, two letters, one
+// letter and empty for 'from'; the whole code, one letter, two letters and
+// empty for 'to'. The categories are sorted by precedence (higher is better).
+enum { M_NONE, M_ZERO_ONE, M_ZERO_TWO, M_ZERO_ALL, M_ONE_ONE, M_ONE_TWO, M_ONE_ALL, M_TWO_TWO, M_TWO_ALL, M_EXACT };
+
+static const int MatchKind[4][4] = {
+	{ M_EXACT,    M_ONE_ALL,  M_TWO_ALL,  M_ZERO_ALL },
+	{ M_TWO_ALL,  M_ONE_TWO,  M_TWO_TWO,  M_ZERO_TWO },
+	{ M_ONE_ALL,  M_ONE_ONE,  M_ONE_TWO,  M_ZERO_ONE },
+	{ M_ZERO_ALL, M_ZERO_ONE, M_ZERO_TWO, M_NONE }
+};
+
+// Contructors for the CodeMatcher class
+CodeMatcher::CodeMatcher() {}
+
+CodeMatcher::CodeMatcher(const MatrixStr& mymatrix, const int num_fields) {
+	Build(mymatrix, num_fields);
+}
+
+// Group the rows of a matrix by key ('num_fields' is 1 for nodes and 2 for arcs)
+void CodeMatcher::Build(const MatrixStr& mymatrix, const int num_fields) {
+	single.clear();
+	pairs.clear();
+	for (unsigned int k = 0; k < mymatrix.size(); ++k) {
+		if (mymatrix[k].size() == 0) continue;
+
+		KeyMap::iterator it = single.find(mymatrix[k][0]);
+		if (it == single.end()) single[mymatrix[k][0]] = RowRange(k, k);
+		else it->second.second = k;
+
+		if ((num_fields > 1) && (mymatrix[k].size() > 1)) {
+			KeyMap& inner = pairs[mymatrix[k][0]];
+			it = inner.find(mymatrix[k][1]);
+			if (it == inner.end()) inner[mymatrix[k][1]] = RowRange(k, k);
+			else it->second.second = k;
+		}
+	}
+}
+
+// Find the row for a code: the first exact match, otherwise the last row
+// matching two letters, otherwise the last one matching one letter
+int CodeMatcher::Find(const string& mystr) const {
+	KeyMap::const_iterator it = single.find(mystr);
+	if (it != single.end()) return it->second.first;
+
+	int output = -1;
+	it = single.find(mystr.substr(0,2));
+	if (it != single.end()) output = it->second.second;
+	if (output == -1) {
+		it = single.find(mystr.substr(0,1));
+		if (it != single.end()) output = it->second.second;
+	}
+	return output;
+}
+
+// Find the row for an arc code (same precedence as 'FindCode')
+int CodeMatcher::Find(const string& strfrom, const string& strto) const {
+	string fromkey[4] = { strfrom, strfrom.substr(0,2), strfrom.substr(0,1), "" };
+	string tokey[4] = { strto, strto.substr(0,1), strto.substr(0,2), "" };
+	vector<int> best(M_EXACT + 1, -1);
+
+	for (int i = 0; i < 4; ++i) {
+		// A key that is equal to a previous one was already classified
+		bool repeated = false;
+		for (int m = 0; m < i; ++m) repeated = repeated || (fromkey[m] == fromkey[i]);
+		if (repeated) continue;
+
+		map<string, KeyMap>::const_iterator outer = pairs.find(fromkey[i]);
+		if (outer == pairs.end()) continue;
+
+		for (int j = 0; j < 4; ++j) {
+			repeated = false;
+			for (int m = 0; m < j; ++m) repeated = repeated || (tokey[m] == tokey[j]);
+			if (repeated || (MatchKind[i][j] == M_NONE)) continue;
+
+			KeyMap::const_iterator it = outer->second.find(tokey[j]);
+			if (it == outer->second.end()) continue;
+
+			int kind = MatchKind[i][j];
+			if (kind == M_EXACT) return it->second.first;
+			if (it->second.second > best[kind]) best[kind] = it->second.second;
+		}
+	}
+
+	for (int kind = M_EXACT - 1; kind > M_NONE; --kind)
+		if (best[kind] != -1) return best[kind];
+	return -1;
+}
@@ -0,0 +1,34 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    matcher.h -- Definition of the code matcher
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+#ifndef _MATCHER_H_
+#define _MATCHER_H_
+
+// Declare class type to find the row of a property matrix that fits best to
+// a code, without scanning the whole matrix. It gives the same answer as
+// the 'FindCode' functions: rows are grouped by their first column (and by
+// the first two columns for arcs), keeping the first and last row of each
+// key, so only the few keys that can match a code have to be checked.
+class CodeMatcher {
+	public:
+		CodeMatcher();
+		CodeMatcher(const MatrixStr& mymatrix, const int num_fields);
+
+		void Build(const MatrixStr& mymatrix, const int num_fields);
+		int Find(const string& mystr) const;
+		int Find(const string& strfrom, const string& strto) const;
+
+	private:
+		// First and last row for each key
+		typedef pair<int, int> RowRange;
+		typedef map<string, RowRange> KeyMap;
+
+		KeyMap single;
+		map<string, KeyMap> pairs;
+};
+
+#endif  // _MATCHER_H_
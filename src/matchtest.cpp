@@ -0,0 +1,103 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    matchtest.cpp -- Randomized check of the code matcher
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+// Builds random property matrices and codes from a small alphabet, so that
+// exact, two-letter, one-letter and empty keys collide often, and checks
+// that the CodeMatcher finds the same row as the 'FindCode' functions that
+// scan the whole matrix, for nodes and for arcs. It stops at the first
+// difference and returns 1.
+//
+//    matchtest [--trials N] [--seed N]
+
+using namespace std;
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include "netscore.h"
+
+// Pseudo-random numbers (same sequence for the same seed)
+static unsigned long RandomState = 1;
+static int Random(const int n) {
+	RandomState = (RandomState * 1103515245 + 12345) % 2147483648UL;
+	return (int) ((double) n * RandomState / 2147483648.0);
+}
+
+// Code of 'minimum' to 'maximum' letters
+static string RandomCode(const int minimum, const int maximum) {
+	static const string Letters = "ABC";
+	string output = "";
+	int length = minimum + Random(maximum - minimum + 1);
+	for (int k = 0; k < length; ++k)
+		output += Letters[Random(Letters.size())];
+	return output;
+}
+
+// Matrix whose rows start with random keys (possibly empty)
+static MatrixStr RandomMatrix(const int num_fields) {
+	MatrixStr output;
+	int rows = Random(12);
+	for (int k = 0; k < rows; ++k) {
+		VectorStr row;
+		for (int f = 0; f < num_fields; ++f)
+			row.push_back(RandomCode(0, 3));
+		row.push_back("1");
+		output.push_back(row);
+	}
+	return output;
+}
+
+static void PrintMatrix(const MatrixStr& mymatrix) {
+	for (unsigned int k = 0; k < mymatrix.size(); ++k) {
+		cout << "\t\t" << k << ":";
+		for (unsigned int f = 0; f + 1 < mymatrix[k].size(); ++f)
+			cout << " '" << mymatrix[k][f] << "'";
+		cout << "\n";
+	}
+}
+
+int main(int argc, char* argv[]) {
+	int trials = 100000;
+	for (int a = 1; a < argc; ++a) {
+		string option = argv[a];
+		if ((option == "--trials") && (a + 1 < argc)) trials = atoi(argv[++a]);
+		else if ((option == "--seed") && (a + 1 < argc)) RandomState = atol(argv[++a]);
+		else cout << "\tWarning: Unknown option '" << option << "' is ignored\n";
+	}
+
+	long checks = 0;
+	for (int t = 0; t < trials; ++t) {
+		// Node codes
+		MatrixStr nodes = RandomMatrix(1);
+		CodeMatcher nodematcher(nodes, 1);
+		for (int c = 0; c < 8; ++c, ++checks) {
+			string code = RandomCode(1, 4);
+			int expected = FindCode(code, nodes), found = nodematcher.Find(code);
+			if (expected != found) {
+				cout << "\tERROR: Node code '" << code << "' gives row " << found << " instead of " << expected << "\n";
+				PrintMatrix(nodes);
+				return 1;
+			}
+		}
+
+		// Arc codes
+		MatrixStr arcs = RandomMatrix(2);
+		CodeMatcher arcmatcher(arcs, 2);
+		for (int c = 0; c < 8; ++c, ++checks) {
+			string from = RandomCode(1, 4), to = RandomCode(1, 4);
+			int expected = FindCode(from, to, arcs), found = arcmatcher.Find(from, to);
+			if (expected != found) {
+				cout << "\tERROR: Arc code '" << from << "' - '" << to << "' gives row " << found << " instead of " << expected << "\n";
+				PrintMatrix(arcs);
+				return 1;
+			}
+		}
+	}
+
+	cout << "- " << checks << " codes matched the same row in " << trials << " random matrices\n";
+	return 0;
+}
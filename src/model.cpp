@@ -0,0 +1,443 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    model.cpp -- Implementation of the optimization model builder
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+using namespace std;
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "global.h"
+#include "node.h"
+#include "arc.h"
+#include "network.h"
+#include "model.h"
+#include "presolve.h"
+
+// Contructor for the ModelBlock class
+ModelBlock::ModelBlock() :
+	start(1, 0) {}
+
+// Release the memory of all the elements (swapping with empty vectors, since
+// clearing them keeps their capacity)
+void ModelBlock::Clear() {
+	vector<char>().swap(rowtype);
+	vector<int>().swap(row);
+	vector<int>().swap(col);
+	vector<int>(1, 0).swap(start);
+	vector<int>().swap(entryrow);
+	vector<double>().swap(entryvalue);
+	vector<int>().swap(rhsrow);
+	vector<double>().swap(rhsvalue);
+	vector<char>().swap(boundtype);
+	vector<int>().swap(boundcol);
+	vector<double>().swap(boundvalue);
+	vector<int>().swap(keeprow);
+	vector<int>().swap(keepcol);
+}
+
+
+// Contructor for the ModelBuilder class (one more block is kept hidden to
+// store the elements that are only part of the full model)
+ModelBuilder::ModelBuilder(const int nblocks) :
+	blocks(nblocks + 1),
+	lastfull(nblocks + 1, false),
+	only(-1) {}
+
+// Id of a row or column name (it's added to the dictionary if it's new)
+int ModelBuilder::RowId(const string& name) {
+	return rownames.Add(name);
+}
+
+int ModelBuilder::ColumnId(const string& name) {
+	return colnames.Add(name);
+}
+
+// Add a new row
+void ModelBuilder::AddRow(const int block, const char type, const string& name, const int scope) {
+	int b = Target(block, scope);
+	if (!Keeps(b)) return;
+	if ((scope & MODEL_FULL) && (only < 0))
+		fullrows.push_back(make_pair(b, blocks[b].row.size()));
+	blocks[b].rowtype.push_back(type);
+	blocks[b].row.push_back(RowId(name));
+}
+
+// Add a coefficient to a column (entries of the same column must be added
+// one after the other, so the column is only stored once per block)
+void ModelBuilder::AddEntry(const int block, const int column, const int row, const double value, const int scope) {
+	int b = Target(block, scope);
+	if (!Keeps(b)) return;
+	ModelBlock& mb = blocks[b];
+	bool infull = (scope & MODEL_FULL) != 0;
+	if (mb.col.empty() || (mb.col.back() != column) || (lastfull[b] != infull)) {
+		if (infull && (only < 0))
+			fullcols.push_back(make_pair(b, mb.col.size()));
+		mb.col.push_back(column);
+		mb.start.push_back(mb.start.back());
+		lastfull[b] = infull;
+	}
+	mb.entryrow.push_back(row);
+	mb.entryvalue.push_back(value);
+	++mb.start.back();
+}
+
+void ModelBuilder::AddEntry(const int block, const int column, const string& row, const double value, const int scope) {
+	if (Keeps(Target(block, scope))) AddEntry(block, column, RowId(row), value, scope);
+}
+
+// Add a right-hand side value
+void ModelBuilder::AddRhs(const int block, const string& row, const double value, const int scope) {
+	int b = Target(block, scope);
+	if (!Keeps(b)) return;
+	if ((scope & MODEL_FULL) && (only < 0))
+		fullrhs.push_back(make_pair(b, blocks[b].rhsrow.size()));
+	blocks[b].rhsrow.push_back(RowId(row));
+	blocks[b].rhsvalue.push_back(value);
+}
+
+// Add a lower ('L') or upper ('U') bound to a column
+void ModelBuilder::AddBound(const int block, const char type, const int column, const double value, const int scope) {
+	int b = Target(block, scope);
+	if (!Keeps(b)) return;
+	if ((scope & MODEL_FULL) && (only < 0))
+		fullbounds.push_back(make_pair(b, blocks[b].boundcol.size()));
+	blocks[b].boundtype.push_back(type);
+	blocks[b].boundcol.push_back(column);
+	blocks[b].boundvalue.push_back(value);
+}
+
+// Keep a row or a column when the model files are reduced
+void ModelBuilder::KeepRow(const int block, const string& row, const int scope) {
+	if ((scope & MODEL_BENDERS) && Keeps(block)) blocks[block].keeprow.push_back(RowId(row));
+	if ((scope & MODEL_FULL) && Keeps(size())) blocks[size()].keeprow.push_back(RowId(row));
+}
+
+void ModelBuilder::KeepColumn(const int block, const int column, const int scope) {
+	if ((scope & MODEL_BENDERS) && Keeps(block)) blocks[block].keepcol.push_back(column);
+	if ((scope & MODEL_FULL) && Keeps(size())) blocks[size()].keepcol.push_back(column);
+}
+
+// Number of Benders blocks
+int ModelBuilder::size() const {
+	return blocks.size() - 1;
+}
+
+// Keep only the elements of one block (-1 for all of them). The order of the
+// full model is only stored while all the blocks are kept.
+void ModelBuilder::BuildOnly(const int block) {
+	only = block;
+}
+
+// Release the memory of a block (once it's written). While only one block is
+// kept, the names are only used by it, so they are released too.
+void ModelBuilder::Release(const int block) {
+	blocks[block].Clear();
+	lastfull[block] = false;
+	if (only >= 0) {
+		rownames = StringPool();
+		colnames = StringPool();
+	}
+}
+
+// Block where an element is stored
+int ModelBuilder::Target(const int block, const int scope) const {
+	return (scope & MODEL_BENDERS) ? block : size();
+}
+
+// Whether the elements of a block are kept
+bool ModelBuilder::Keeps(const int b) const {
+	return (only < 0) || (b == only);
+}
+
+
+// Contructor and destructor for the ModelFile class
+ModelFile::ModelFile() :
+	nrows(0), ncols(0), nnz(0), fullrows(0), fullcols(0), data(NULL), length(0) {}
+
+ModelFile::~ModelFile() {
+	Close();
+}
+
+// Map a binary model file in memory (false if it doesn't exist or it's not valid)
+bool ModelFile::Open(const char* fileinput) {
+	Close();
+	int fd = open(fileinput, O_RDONLY);
+	if (fd < 0) return false;
+	
+	struct stat info;
+	if ((fstat(fd, &info) == 0) && (info.st_size >= sizeof(ModelFileHeader))) {
+		length = info.st_size;
+		data = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED) data = NULL;
+	}
+	close(fd);
+	if (data == NULL) {
+		length = 0;
+		return false;
+	}
+	
+	// Check the header and the size of the file before using the sections
+	const ModelFileHeader* header = (const ModelFileHeader*) data;
+	nrows = header->nrows;
+	ncols = header->ncols;
+	nnz = header->nnz;
+	fullrows = header->fullrows;
+	fullcols = header->fullcols;
+	size_t expected = sizeof(ModelFileHeader) + sizeof(double) * (3*(size_t)ncols + nrows + nnz + fullcols)
+		+ sizeof(int) * ((size_t)ncols + 1 + nnz + fullcols + fullrows + nrows + ncols) + nrows + header->namesize;
+	if ((memcmp(header->magic, MODEL_FILE_MAGIC, 8) != 0) || (header->version != MODEL_FILE_VERSION) ||
+		(nrows < 0) || (ncols < 0) || (nnz < 0) || (fullrows < 0) || (fullcols < 0) || (expected != length)) {
+		printError("modelfile", fileinput);
+		Close();
+		return false;
+	}
+	
+	Map();
+	return true;
+}
+
+// Copy a section of a binary model file and move to the next one
+static void CopySection(char*& section, const void* input, const size_t length) {
+	if (length > 0) memcpy(section, input, length);
+	section += length;
+}
+
+// Assemble the binary model file of a Benders block (-1 for the full model),
+// reduced if asked to. It's stored in doubles, so all the sections are aligned.
+static size_t AssembleModelFile(const ModelBuilder& model, const int block, const bool reduce, vector<double>& image) {
+	// Elements of the model in order (block and position in the block)
+	vector< pair<int, int> > blockrows, blockcols, blockrhs, blockbounds;
+	if (block >= 0) {
+		const ModelBlock& mb = model.blocks[block];
+		for (unsigned int k = 0; k < mb.row.size(); ++k) blockrows.push_back(make_pair(block, k));
+		for (unsigned int k = 0; k < mb.col.size(); ++k) blockcols.push_back(make_pair(block, k));
+		for (unsigned int k = 0; k < mb.rhsrow.size(); ++k) blockrhs.push_back(make_pair(block, k));
+		for (unsigned int k = 0; k < mb.boundcol.size(); ++k) blockbounds.push_back(make_pair(block, k));
+	}
+	const vector< pair<int, int> >& rows = (block < 0) ? model.fullrows : blockrows;
+	const vector< pair<int, int> >& cols = (block < 0) ? model.fullcols : blockcols;
+	const vector< pair<int, int> >& rhs = (block < 0) ? model.fullrhs : blockrhs;
+	const vector< pair<int, int> >& bounds = (block < 0) ? model.fullbounds : blockbounds;
+	
+	// Position of each row in the file. The first free row is the objective
+	// and the rest of free rows (and entries in rows that don't exist) are
+	// dropped, as CPLEX does when it reads the MPS file.
+	const int OBJECTIVE = -2, DROPPED = -3;
+	ModelArrays p;
+	vector<int> rowpos(model.rownames.size(), -1), rowid;
+	int objective = -1;
+	for (unsigned int i = 0; i < rows.size(); ++i) {
+		const ModelBlock& mb = model.blocks[rows[i].first];
+		int id = mb.row[rows[i].second];
+		if (rowpos[id] != -1) continue;
+		if (mb.rowtype[rows[i].second] == 'N') {
+			rowpos[id] = (objective < 0) ? OBJECTIVE : DROPPED;
+			if (objective < 0) objective = id;
+		} else {
+			rowpos[id] = rowid.size();
+			rowid.push_back(id);
+			p.rowtype.push_back(mb.rowtype[rows[i].second]);
+		}
+	}
+	
+	// Columns (the parts of a column in different blocks are joined)
+	vector<int> colpos(model.colnames.size(), -1), colid;
+	p.start.assign(1, 0);
+	for (unsigned int i = 0; i < cols.size(); ++i) {
+		const ModelBlock& mb = model.blocks[cols[i].first];
+		int k = cols[i].second, id = mb.col[k];
+		if (colpos[id] == -1) {
+			colpos[id] = colid.size();
+			colid.push_back(id);
+			p.start.push_back(0);
+			p.obj.push_back(0);
+		}
+		for (int e = mb.start[k]; e < mb.start[k+1]; ++e) {
+			int row = rowpos[mb.entryrow[e]];
+			if (row >= 0) ++p.start[colpos[id]+1];
+			else if (row == OBJECTIVE) p.obj[colpos[id]] += mb.entryvalue[e];
+		}
+	}
+	for (unsigned int c = 1; c < p.start.size(); ++c)
+		p.start[c] += p.start[c-1];
+	
+	int ncols = colid.size(), nrows = rowid.size(), nnz = p.start.back();
+	vector<int> next(p.start.begin(), p.start.end() - 1);
+	p.index.resize(nnz);
+	p.value.resize(nnz);
+	for (unsigned int i = 0; i < cols.size(); ++i) {
+		const ModelBlock& mb = model.blocks[cols[i].first];
+		int k = cols[i].second, c = colpos[mb.col[k]];
+		for (int e = mb.start[k]; e < mb.start[k+1]; ++e) {
+			int row = rowpos[mb.entryrow[e]];
+			if (row < 0) continue;
+			p.index[next[c]] = row;
+			p.value[next[c]] = mb.entryvalue[e];
+			++next[c];
+		}
+	}
+	
+	// Bounds (zero and infinity by default) and right-hand side
+	p.lower.assign(ncols, 0);
+	p.upper.assign(ncols, HUGE_VAL);
+	p.rhs.assign(nrows, 0);
+	for (unsigned int i = 0; i < bounds.size(); ++i) {
+		const ModelBlock& mb = model.blocks[bounds[i].first];
+		int c = colpos[mb.boundcol[bounds[i].second]];
+		if (c < 0) continue;
+		if (mb.boundtype[bounds[i].second] == 'L') p.lower[c] = mb.boundvalue[bounds[i].second];
+		else p.upper[c] = mb.boundvalue[bounds[i].second];
+	}
+	for (unsigned int i = 0; i < rhs.size(); ++i) {
+		const ModelBlock& mb = model.blocks[rhs[i].first];
+		int row = rowpos[mb.rhsrow[rhs[i].second]];
+		if (row >= 0) p.rhs[row] = mb.rhsvalue[rhs[i].second];
+	}
+	
+	// Reduction, keeping the rows and columns of the block (or of the full
+	// model, in the hidden block) that the solver needs
+	PostsolveMap postsolve;
+	if (reduce) {
+		const ModelBlock& kept = model.blocks[(block < 0) ? model.size() : block];
+		vector<bool> keeprow(nrows, false), keepcol(ncols, false);
+		for (unsigned int k = 0; k < kept.keeprow.size(); ++k)
+			if (rowpos[kept.keeprow[k]] >= 0) keeprow[rowpos[kept.keeprow[k]]] = true;
+		for (unsigned int k = 0; k < kept.keepcol.size(); ++k)
+			if (colpos[kept.keepcol[k]] >= 0) keepcol[colpos[kept.keepcol[k]]] = true;
+		Profile.Start("model reduction");
+		ReduceModel(p, keeprow, keepcol, postsolve, block <= 0);
+		Profile.Stop(nrows + ncols - p.rowtype.size() - p.obj.size());
+		
+		vector<int> fullrowid(rowid), fullcolid(colid);
+		rowid.clear();
+		colid.clear();
+		for (int r = 0; r < nrows; ++r)
+			if (postsolve.rowmap[r] >= 0) rowid.push_back(fullrowid[r]);
+		for (int c = 0; c < ncols; ++c)
+			if (postsolve.colmap[c] >= 0) colid.push_back(fullcolid[c]);
+		ncols = colid.size();
+		nrows = rowid.size();
+		nnz = p.start.back();
+	}
+	int fullrows = postsolve.rowmap.size(), fullcols = postsolve.colmap.size();
+	
+	// Names: objective, rows and columns
+	string names = (objective >= 0) ? model.rownames[objective] : "obj";
+	names += '\0';
+	vector<int> nameoffset(nrows + ncols);
+	for (int r = 0; r < nrows; ++r) {
+		nameoffset[r] = names.size();
+		names += model.rownames[rowid[r]];
+		names += '\0';
+	}
+	for (int c = 0; c < ncols; ++c) {
+		nameoffset[nrows + c] = names.size();
+		names += model.colnames[colid[c]];
+		names += '\0';
+	}
+	
+	ModelFileHeader header;
+	memcpy(header.magic, MODEL_FILE_MAGIC, 8);
+	header.version = MODEL_FILE_VERSION;
+	header.nrows = nrows;
+	header.ncols = ncols;
+	header.nnz = nnz;
+	header.namesize = names.size();
+	header.fullrows = fullrows;
+	header.fullcols = fullcols;
+	header.unused = 0;
+	
+	size_t length = sizeof header + sizeof(double) * (3*(size_t)ncols + nrows + nnz + fullcols)
+		+ sizeof(int) * ((size_t)ncols + 1 + nnz + fullcols + fullrows + nrows + ncols) + nrows + names.size();
+	image.assign((length + sizeof(double) - 1) / sizeof(double), 0);
+	char* section = (char*) &image[0];
+	CopySection(section, &header, sizeof header);
+	CopySection(section, &p.obj[0], ncols * sizeof(double));
+	CopySection(section, &p.lower[0], ncols * sizeof(double));
+	CopySection(section, &p.upper[0], ncols * sizeof(double));
+	CopySection(section, &p.rhs[0], nrows * sizeof(double));
+	CopySection(section, &p.value[0], nnz * sizeof(double));
+	CopySection(section, &postsolve.fixed[0], fullcols * sizeof(double));
+	CopySection(section, &p.start[0], (ncols + 1) * sizeof(int));
+	CopySection(section, &p.index[0], nnz * sizeof(int));
+	CopySection(section, &postsolve.colmap[0], fullcols * sizeof(int));
+	CopySection(section, &postsolve.rowmap[0], fullrows * sizeof(int));
+	CopySection(section, &nameoffset[0], (nrows + ncols) * sizeof(int));
+	CopySection(section, &p.rowtype[0], nrows);
+	CopySection(section, names.data(), names.size());
+	return length;
+}
+
+// Assemble the problem of a Benders block (-1 for the full model) in memory,
+// with the same contents as the binary model file
+void ModelFile::Build(const ModelBuilder& model, const int block, const bool reduce) {
+	Close();
+	length = AssembleModelFile(model, block, reduce, image);
+	data = &image[0];
+	const ModelFileHeader* header = (const ModelFileHeader*) data;
+	nrows = header->nrows;
+	ncols = header->ncols;
+	nnz = header->nnz;
+	fullrows = header->fullrows;
+	fullcols = header->fullcols;
+	Map();
+}
+
+// Point the arrays to the sections of the file
+void ModelFile::Map() {
+	const char* section = (const char*) data + sizeof(ModelFileHeader);
+	obj = (const double*) section; section += ncols * sizeof(double);
+	lower = (const double*) section; section += ncols * sizeof(double);
+	upper = (const double*) section; section += ncols * sizeof(double);
+	rhs = (const double*) section; section += nrows * sizeof(double);
+	value = (const double*) section; section += nnz * sizeof(double);
+	fixed = (const double*) section; section += fullcols * sizeof(double);
+	start = (const int*) section; section += (ncols + 1) * sizeof(int);
+	index = (const int*) section; section += nnz * sizeof(int);
+	colmap = (const int*) section; section += fullcols * sizeof(int);
+	rowmap = (const int*) section; section += fullrows * sizeof(int);
+	nameoffset = (const int*) section; section += (nrows + ncols) * sizeof(int);
+	rowtype = section; section += nrows;
+	names = section;
+}
+
+// Release the memory map
+void ModelFile::Close() {
+	if ((data != NULL) && image.empty()) munmap(data, length);
+	image.clear();
+	data = NULL;
+	length = 0;
+	nrows = ncols = nnz = fullrows = fullcols = 0;
+}
+
+// Contents of the file (the header and all the sections)
+const char* ModelFile::Data() const {
+	return (const char*) data;
+}
+
+size_t ModelFile::Size() const {
+	return length;
+}
+
+// Names of the objective, rows and columns
+const char* ModelFile::ObjectiveName() const {
+	return names;
+}
+
+const char* ModelFile::RowName(const int row) const {
+	return names + nameoffset[row];
+}
+
+const char* ModelFile::ColumnName(const int col) const {
+	return names + nameoffset[nrows + col];
+}
@@ -0,0 +1,168 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    model.h -- Definition of the optimization model builder
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+#ifndef _MODEL_H_
+#define _MODEL_H_
+
+// Which models an element belongs to: the full model (netscore.mps), the
+// Benders block given when it's added (bend_#.mps), or both
+enum ModelScope {
+	MODEL_FULL = 1,
+	MODEL_BENDERS = 2,
+	MODEL_BOTH = 3
+};
+
+// Declare class type to store the part of the model in one Benders block.
+// Rows and columns are ids in the name dictionaries of the 'ModelBuilder'.
+class ModelBlock {
+	public:
+		ModelBlock();
+
+		// Rows ('N', 'E', 'L' or 'G')
+		vector<char> rowtype;
+		vector<int> row;
+
+		// Matrix compressed by columns: the entries of column 'col[c]' go from
+		// position start[c] to start[c+1]-1 (a column added in several steps
+		// appears once for each step)
+		vector<int> col, start, entryrow;
+		vector<double> entryvalue;
+
+		// Right-hand side and bounds ('L' for lower, 'U' for upper)
+		vector<int> rhsrow;
+		vector<double> rhsvalue;
+		vector<char> boundtype;
+		vector<int> boundcol;
+		vector<double> boundvalue;
+
+		// Rows and columns that the reduction of the model files keeps
+		vector<int> keeprow, keepcol;
+
+		// Release the memory of all the elements
+		void Clear();
+};
+
+// Declare class type to assemble the optimization model with integer ids
+// instead of text. Each element is stored once in its Benders block (0 is
+// the master problem and 1..n the years), and the full model keeps the
+// order in which the elements were added, as pairs of block and position.
+// It can also keep only the elements of one block, so the blocks are built,
+// written and released one at a time.
+class ModelBuilder {
+	public:
+		ModelBuilder(const int nblocks);
+
+		// Name dictionaries
+		int RowId(const string& name);
+		int ColumnId(const string& name);
+
+		void AddRow(const int block, const char type, const string& name, const int scope = MODEL_BOTH);
+		void AddEntry(const int block, const int column, const int row, const double value, const int scope = MODEL_BOTH);
+		void AddEntry(const int block, const int column, const string& row, const double value, const int scope = MODEL_BOTH);
+		void AddRhs(const int block, const string& row, const double value, const int scope = MODEL_BOTH);
+		void AddBound(const int block, const char type, const int column, const double value, const int scope = MODEL_BOTH);
+
+		// Keep a row or column when the model files are reduced, because the
+		// solver changes it or reads it by position (the ones kept in the
+		// full model are stored in the hidden block)
+		void KeepRow(const int block, const string& row, const int scope = MODEL_BOTH);
+		void KeepColumn(const int block, const int column, const int scope = MODEL_BOTH);
+		int size() const;
+
+		// Keep only the elements of one block from now on (-1 for all of
+		// them), without the order of the full model, and release a block
+		void BuildOnly(const int block);
+		void Release(const int block);
+
+		StringPool rownames, colnames;
+		vector<ModelBlock> blocks;
+
+		// Elements of the full model in order (block and position in the block)
+		vector< pair<int, int> > fullrows, fullcols, fullrhs, fullbounds;
+
+	private:
+		int Target(const int block, const int scope) const;
+		bool Keeps(const int b) const;
+
+		// Whether the last column of each block is part of the full model
+		vector<bool> lastfull;
+
+		// Only block that is kept (-1 for all of them)
+		int only;
+};
+
+// Binary model files (prepdata/*.bin) store the same problem as the MPS
+// files, the way CPLEX reads them: the first free row is the objective and
+// the other free rows are dropped. After the header, the sections are
+// (in this order, so every array is aligned): objective, lower and upper
+// bounds of the columns, right-hand side, matrix values, column starts,
+// row index of each value, name offsets, row types and names. Names are
+// stored one after another ending with '\0': objective, rows and columns.
+// Reduced problems (see presolve.h) also store the postsolve map, with the
+// size of the full problem in the header: the value of each full column
+// after the matrix values, and the position of each full column and row
+// after the row indices.
+#define MODEL_FILE_MAGIC "NETSCMDL"
+#define MODEL_FILE_VERSION 2
+
+struct ModelFileHeader {
+	char magic[8];
+	int version, nrows, ncols, nnz, namesize, fullrows, fullcols, unused;
+};
+
+// Declare class type to read a binary model file. The file is mapped in
+// memory and the arrays point to it, so nothing is parsed or copied. The
+// same contents can be built in memory from a 'ModelBuilder', to load the
+// problem without files or to write them.
+class ModelFile {
+	public:
+		ModelFile();
+		~ModelFile();
+
+		bool Open(const char* fileinput);
+		void Build(const ModelBuilder& model, const int block, const bool reduce = false);
+		void Close();
+		const char* Data() const;
+		size_t Size() const;
+		const char* ObjectiveName() const;
+		const char* RowName(const int row) const;
+		const char* ColumnName(const int col) const;
+
+		// Size of the problem ('nnz' is the number of matrix entries)
+		int nrows, ncols, nnz;
+
+		// Columns: objective coefficient, bounds and entries (from start[c] to start[c+1]-1)
+		const double *obj, *lower, *upper, *value;
+		const int *start, *index;
+
+		// Rows: type ('E', 'L' or 'G') and right-hand side
+		const char* rowtype;
+		const double* rhs;
+
+		// Postsolve map of a reduced problem (sizes are 0 if it wasn't
+		// reduced): position of each row and column of the full problem
+		// (-1 if it was removed) and value of the removed columns
+		int fullrows, fullcols;
+		const int *rowmap, *colmap;
+		const double* fixed;
+
+	private:
+		ModelFile(const ModelFile& rhs);
+		ModelFile& operator=(const ModelFile& rhs);
+
+		void Map();
+
+		const int* nameoffset;
+		const char* names;
+		void* data;
+		size_t length;
+
+		// Contents built in memory (empty if the file is mapped)
+		vector<double> image;
+};
+
+#endif  // _MODEL_H_
@@ -0,0 +1,292 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    modeltest.cpp -- Round-trip check of the MPS and binary model files
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+// Reads the MPS files written by 'prep' (netscore, if it's there, and
+// bend_#, plain or compressed) and checks that the binary model file next to
+// each one has the same problem: rows, columns, coefficients, right-hand
+// sides and bounds. Reduced binary files are compared through their
+// postsolve map: the rows and columns kept must match the MPS file by name,
+// the bounds may only be tighter, the removed columns must be fixed within
+// their bounds without cost, and the right-hand sides must include the
+// entries of the removed columns. It stops at the first file with
+// differences and returns 1.
+//
+//    modeltest [folder]      (prepdata by default)
+
+using namespace std;
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <zlib.h>
+#include "netscore.h"
+
+// Relative tolerance for values that are computed again (right-hand sides
+// of reduced files); everything else must be exactly the same
+#define MODELTEST_TOL 1e-9
+
+// Maximum number of differences printed for each file
+#define MODELTEST_ERRORS 10
+
+// Problem read from an MPS file, with the rows and columns in file order
+struct MpsProblem {
+	string objective;
+	vector<string> rownames, colnames;
+	vector<char> rowtype;
+	vector<double> rhs, obj, lower, upper;
+	vector< vector< pair<int, double> > > entries;
+};
+
+static bool Close(const double a, const double b) {
+	return (a == b) || (fabs(a - b) <= MODELTEST_TOL * (1 + fabs(a) + fabs(b)));
+}
+
+// Position of a column, added with the default bounds the first time
+static int MpsColumn(MpsProblem& mps, map<string, int>& colpos, const string& name) {
+	map<string, int>::iterator it = colpos.find(name);
+	if (it != colpos.end()) return it->second;
+	int c = mps.colnames.size();
+	colpos[name] = c;
+	mps.colnames.push_back(name);
+	mps.obj.push_back(0);
+	mps.lower.push_back(0);
+	mps.upper.push_back(HUGE_VAL);
+	mps.entries.push_back(vector< pair<int, double> >());
+	return c;
+}
+
+// Read an MPS file in the format written by 'WriteMPS' (zlib also reads
+// uncompressed files). Entries in free rows other than the objective and
+// in rows that aren't declared are ignored, as CPLEX does.
+static bool ReadMps(const string& fileinput, MpsProblem& mps) {
+	gzFile file = gzopen(fileinput.c_str(), "rb");
+	if (file == NULL) return false;
+
+	map<string, int> rowpos, colpos;
+	string section;
+	char line[1024];
+	bool valid = true;
+	while (valid && (gzgets(file, line, sizeof line) != NULL)) {
+		char* field[4];
+		int n = 0;
+		for (char* token = strtok(line, " \t\r\n"); (token != NULL) && (n < 4); token = strtok(NULL, " \t\r\n"))
+			field[n++] = token;
+		if (n == 0) continue;
+		if ((line[0] != ' ') && (line[0] != '\t')) {
+			section = field[0];
+			continue;
+		}
+
+		if (section == "ROWS") {
+			if (n != 2) valid = false;
+			else if (field[0][0] == 'N') {
+				if (mps.objective.empty()) mps.objective = field[1];
+				else rowpos[field[1]] = -1;
+			} else {
+				rowpos[field[1]] = mps.rownames.size();
+				mps.rownames.push_back(field[1]);
+				mps.rowtype.push_back(field[0][0]);
+				mps.rhs.push_back(0);
+			}
+		} else if (section == "COLUMNS") {
+			if (n != 3) {
+				valid = false;
+				continue;
+			}
+			int c = MpsColumn(mps, colpos, field[0]);
+			double value = atof(field[2]);
+			if (mps.objective == field[1]) {
+				mps.obj[c] += value;
+				continue;
+			}
+			map<string, int>::iterator it = rowpos.find(field[1]);
+			if ((it != rowpos.end()) && (it->second >= 0)) mps.entries[c].push_back(make_pair(it->second, value));
+		} else if (section == "RHS") {
+			map<string, int>::iterator it = rowpos.find(field[1]);
+			if (n != 3) valid = false;
+			else if ((it != rowpos.end()) && (it->second >= 0)) mps.rhs[it->second] = atof(field[2]);
+		} else if (section == "BOUNDS") {
+			if (n < 3) {
+				valid = false;
+				continue;
+			}
+			int c = MpsColumn(mps, colpos, field[2]);
+			string type = field[0];
+			double value = (n > 3) ? atof(field[3]) : 0;
+			if ((type == "LO") || (type == "FX")) mps.lower[c] = value;
+			if ((type == "UP") || (type == "FX")) mps.upper[c] = value;
+			if ((type == "FR") || (type == "MI")) mps.lower[c] = -HUGE_VAL;
+			if (type == "FR") mps.upper[c] = HUGE_VAL;
+		}
+	}
+	gzclose(file);
+	return valid && (section == "ENDATA");
+}
+
+// Entries of a column sorted by row, with the ones in the same row added
+// and the zeros dropped
+static void SortEntries(vector< pair<int, double> >& entries) {
+	sort(entries.begin(), entries.end());
+	unsigned int n = 0;
+	for (unsigned int k = 0; k < entries.size(); ++k) {
+		if ((n > 0) && (entries[n-1].first == entries[k].first)) entries[n-1].second += entries[k].second;
+		else entries[n++] = entries[k];
+	}
+	entries.resize(n);
+	n = 0;
+	for (unsigned int k = 0; k < entries.size(); ++k)
+		if (entries[k].second != 0) entries[n++] = entries[k];
+	entries.resize(n);
+}
+
+// Compare one binary model file with its MPS file and return the number of differences
+static int CompareModel(const string& name, const ModelFile& bin, MpsProblem& mps) {
+	int errors = 0;
+	#define MODEL_ERROR(message) { if (errors++ < MODELTEST_ERRORS) cout << "\tERROR: " << name << ": " << message << "\n"; }
+
+	// Postsolve map (the identity if the file wasn't reduced)
+	int fullrows = (bin.fullcols > 0) ? bin.fullrows : bin.nrows;
+	int fullcols = (bin.fullcols > 0) ? bin.fullcols : bin.ncols;
+	vector<int> rowmap(fullrows), colmap(fullcols);
+	vector<double> fixed(fullcols, 0);
+	for (int r = 0; r < fullrows; ++r) rowmap[r] = (bin.fullcols > 0) ? bin.rowmap[r] : r;
+	for (int c = 0; c < fullcols; ++c) colmap[c] = (bin.fullcols > 0) ? bin.colmap[c] : c;
+	if (bin.fullcols > 0) fixed.assign(bin.fixed, bin.fixed + fullcols);
+
+	if (mps.objective != bin.ObjectiveName())
+		MODEL_ERROR("objective '" << bin.ObjectiveName() << "' instead of '" << mps.objective << "'");
+	if (((int) mps.rownames.size() != fullrows) || ((int) mps.colnames.size() != fullcols)) {
+		MODEL_ERROR(fullrows << " rows and " << fullcols << " columns instead of " << mps.rownames.size() << " and " << mps.colnames.size());
+		return errors;
+	}
+
+	// Rows: same name and type, in the same order
+	vector<int> keptrow(bin.nrows, -1);
+	for (int r = 0; r < fullrows; ++r) {
+		int k = rowmap[r];
+		if (k < 0) continue;
+		if ((k >= bin.nrows) || (keptrow[k] >= 0)) {
+			MODEL_ERROR("row " << r << " is mapped to row " << k);
+			continue;
+		}
+		keptrow[k] = r;
+		if (mps.rownames[r] != bin.RowName(k)) MODEL_ERROR("row '" << bin.RowName(k) << "' instead of '" << mps.rownames[r] << "'");
+		if (mps.rowtype[r] != bin.rowtype[k]) MODEL_ERROR("row '" << mps.rownames[r] << "' of type " << bin.rowtype[k] << " instead of " << mps.rowtype[r]);
+	}
+	for (int k = 0; k < bin.nrows; ++k)
+		if (keptrow[k] < 0) MODEL_ERROR("row '" << bin.RowName(k) << "' isn't in the full problem");
+
+	// Columns: same name, cost and entries in the rows kept, and bounds
+	// within the original ones. Removed columns must keep the objective and
+	// move their entries to the right-hand side.
+	vector<double> moved(fullrows, 0);
+	vector<int> keptcol(bin.ncols, -1);
+	for (int c = 0; c < fullcols; ++c) {
+		const string& col = mps.colnames[c];
+		SortEntries(mps.entries[c]);
+		int k = colmap[c];
+		if (k < 0) {
+			if ((fixed[c] < mps.lower[c]) || (fixed[c] > mps.upper[c]))
+				MODEL_ERROR("column '" << col << "' fixed at " << fixed[c] << " out of its bounds");
+			if (mps.obj[c] * fixed[c] != 0)
+				MODEL_ERROR("column '" << col << "' fixed at " << fixed[c] << " changes the objective");
+			for (unsigned int e = 0; e < mps.entries[c].size(); ++e)
+				moved[mps.entries[c][e].first] += mps.entries[c][e].second * fixed[c];
+			continue;
+		}
+		if ((k >= bin.ncols) || (keptcol[k] >= 0)) {
+			MODEL_ERROR("column '" << col << "' is mapped to column " << k);
+			continue;
+		}
+		keptcol[k] = c;
+		if (col != bin.ColumnName(k)) MODEL_ERROR("column '" << bin.ColumnName(k) << "' instead of '" << col << "'");
+		if (mps.obj[c] != bin.obj[k]) MODEL_ERROR("column '" << col << "' with cost " << bin.obj[k] << " instead of " << mps.obj[c]);
+		if ((bin.lower[k] < mps.lower[c]) || (bin.upper[k] > mps.upper[c]) || (bin.lower[k] > bin.upper[k]))
+			MODEL_ERROR("column '" << col << "' with bounds [" << bin.lower[k] << ", " << bin.upper[k]
+				<< "] out of [" << mps.lower[c] << ", " << mps.upper[c] << "]");
+		if ((bin.fullcols == 0) && ((bin.lower[k] != mps.lower[c]) || (bin.upper[k] != mps.upper[c])))
+			MODEL_ERROR("column '" << col << "' with bounds [" << bin.lower[k] << ", " << bin.upper[k]
+				<< "] instead of [" << mps.lower[c] << ", " << mps.upper[c] << "]");
+
+		vector< pair<int, double> > expected, found;
+		for (unsigned int e = 0; e < mps.entries[c].size(); ++e)
+			if (rowmap[mps.entries[c][e].first] >= 0) expected.push_back(make_pair(rowmap[mps.entries[c][e].first], mps.entries[c][e].second));
+		for (int e = bin.start[k]; e < bin.start[k+1]; ++e)
+			found.push_back(make_pair(bin.index[e], bin.value[e]));
+		SortEntries(found);
+		if (expected != found) MODEL_ERROR("column '" << col << "' with " << found.size() << " entries different from the " << expected.size() << " in the MPS file");
+	}
+
+	// Right-hand sides, with the entries of the removed columns
+	for (int k = 0; k < bin.nrows; ++k) {
+		int r = keptrow[k];
+		if ((r >= 0) && !Close(bin.rhs[k], mps.rhs[r] - moved[r]))
+			MODEL_ERROR("row '" << mps.rownames[r] << "' with right-hand side " << bin.rhs[k] << " instead of " << mps.rhs[r] - moved[r]);
+	}
+	#undef MODEL_ERROR
+	return errors;
+}
+
+// Check one model (false if there are differences or the files can't be read)
+static bool CheckModel(const string& folder, const string& name) {
+	MpsProblem mps;
+	string mpsfile = folder + "/" + name + ".mps";
+	if (!ReadMps(mpsfile, mps)) {
+		mpsfile += ".gz";
+		mps = MpsProblem();
+		if (!ReadMps(mpsfile, mps)) {
+			cout << "\tERROR: Can't read the MPS file of '" << name << "'\n";
+			return false;
+		}
+	}
+	ModelFile bin;
+	string binfile = folder + "/" + name + ".bin";
+	if (!bin.Open(binfile.c_str())) {
+		printError("read", binfile.c_str());
+		return false;
+	}
+
+	int errors = CompareModel(name, bin, mps);
+	if (errors > 0) {
+		cout << "\tERROR: " << name << ": " << errors << " differences with '" << mpsfile << "'\n";
+		return false;
+	}
+	cout << "- " << name << ": " << bin.nrows << " of " << mps.rownames.size() << " rows and "
+		<< bin.ncols << " of " << mps.colnames.size() << " columns match the MPS file\n";
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	string folder = (argc > 1) ? argv[1] : "prepdata";
+	outputLevel = 2;
+
+	// Full model (not written when the Benders blocks are written one at a
+	// time) and Benders blocks (from bend_0 until one is missing)
+	ModelFile full;
+	bool hasfull = full.Open((folder + "/netscore.bin").c_str());
+	full.Close();
+	if (hasfull && !CheckModel(folder, "netscore")) return 1;
+	int blocks = 0;
+	while (true) {
+		string name = "bend_" + Num2Str(blocks);
+		ModelFile bin;
+		if (!bin.Open((folder + "/" + name + ".bin").c_str())) break;
+		bin.Close();
+		if (!CheckModel(folder, name)) return 1;
+		++blocks;
+	}
+	if (!hasfull && (blocks == 0)) {
+		cout << "\tERROR: There are no model files in '" << folder << "'\n";
+		return 1;
+	}
+	cout << "- " << (hasfull ? "The full model and " : "") << blocks << " Benders blocks match their MPS files\n";
+	return 0;
+}
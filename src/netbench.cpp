@@ -0,0 +1,132 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    netbench.cpp -- Benchmark of the preprocessor on synthetic data
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+// Generates data sets of increasing size with 'netgen' (bench/r<regions>/)
+// and preprocesses each one with 'prep', recording the throughput and peak
+// memory from its report (prep_profile.json) in bench/bench.csv:
+//   - arcs/s: arcs expanded per second of the whole preprocessor
+//   - MPS MB/s: size of prepdata/*.mps over the time spent writing them
+//
+//    netbench [--regions N,N,...] [--techs N] [--fleets N] [--years N]
+//             [--step y|ym|ymh] [--benders]
+
+using namespace std;
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+// Default ladder of sizes (number of regions)
+static const int Ladder[] = { 4, 8, 16, 32, 64 };
+
+// Value of a field in the JSON report: of the first phase with that name, or
+// of the whole program (fields written before the phases) if there's none
+static double ReportValue(const string& text, const string& phase, const string& field) {
+	size_t start = 0;
+	if (!phase.empty()) {
+		start = text.find("\"name\": \"" + phase + "\"");
+		if (start == string::npos) return 0;
+	}
+	size_t pos = text.find("\"" + field + "\": ", start);
+	if (pos == string::npos) return 0;
+	return atof(text.c_str() + pos + field.size() + 4);
+}
+
+// Bytes of the MPS files in a folder
+static double MpsSize(const string& folder) {
+	double output = 0;
+	DIR* dir = opendir(folder.c_str());
+	if (dir == NULL) return 0;
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != NULL) {
+		string name = entry->d_name;
+		size_t pos = name.rfind(".mps");
+		if ((pos == string::npos) || ((name.substr(pos) != ".mps") && (name.substr(pos) != ".mps.gz")))
+			continue;
+		struct stat info;
+		if (stat((folder + "/" + name).c_str(), &info) == 0) output += info.st_size;
+	}
+	closedir(dir);
+	return output;
+}
+
+int main(int argc, char* argv[]) {
+	vector<int> regions(Ladder, Ladder + sizeof(Ladder) / sizeof(Ladder[0]));
+	string options = "";
+	for (int a = 1; a < argc; ++a) {
+		string option = argv[a];
+		if ((option == "--regions") && (a + 1 < argc)) {
+			regions.clear();
+			stringstream list(argv[++a]);
+			string item;
+			while (getline(list, item, ','))
+				if (atoi(item.c_str()) > 0) regions.push_back(atoi(item.c_str()));
+		} else if (((option == "--techs") || (option == "--fleets") || (option == "--years") || (option == "--step")) && (a + 1 < argc)) {
+			options += " " + option + " " + argv[++a];
+		} else if (option == "--benders") {
+			options += " " + option;
+		} else cout << "\tWarning: Unknown option '" << option << "' is ignored\n";
+	}
+
+	char path[4096];
+	if (getcwd(path, sizeof(path)) == NULL) return 1;
+	string root = path;
+	mkdir("bench", 0777);
+	ofstream file("bench/bench.csv");
+	if (!file.is_open()) {
+		cout << "\tERROR: File 'bench/bench.csv' can't be written!\n";
+		return 1;
+	}
+	file << "regions,nodes,arcs,columns,wall,cpu,arcs_per_s,mps_mb,mps_mb_per_s,peak_rss_mb\n";
+	printf("regions     arcs  columns   wall (s)    arcs/s   MPS (MB)   MPS MB/s   peak (MB)\n");
+
+	for (unsigned int k = 0; k < regions.size(); ++k) {
+		ostringstream folder;
+		folder << "bench/r" << regions[k];
+		ostringstream command;
+		command << root << "/netgen " << folder.str() << " --regions " << regions[k] << options << " > /dev/null";
+		if (system(command.str().c_str()) != 0) {
+			cout << "\tERROR: Data set '" << folder.str() << "' couldn't be generated\n";
+			continue;
+		}
+		command.str("");
+		command << "cd " << folder.str() << " && rm -rf prepdata && " << root << "/prep > prep.log 2>&1";
+		if (system(command.str().c_str()) != 0) {
+			cout << "\tERROR: Preprocessing failed (see " << folder.str() << "/prep.log)\n";
+			continue;
+		}
+
+		ifstream report((folder.str() + "/prep_profile.json").c_str());
+		if (!report.is_open()) {
+			cout << "\tERROR: File '" << folder.str() << "/prep_profile.json' not found!\n";
+			continue;
+		}
+		stringstream buffer;
+		buffer << report.rdbuf();
+		string text = buffer.str();
+
+		double wall = ReportValue(text, "", "wall"), cpu = ReportValue(text, "", "cpu");
+		double nodes = ReportValue(text, "node expansion", "items"), arcs = ReportValue(text, "arc expansion", "items");
+		double columns = ReportValue(text, "build model", "items"), mpswall = ReportValue(text, "mps files", "wall");
+		double mps = MpsSize(folder.str() + "/prepdata") / 1048576, peak = ReportValue(text, "", "peak_rss_kb") / 1024;
+		double arcrate = (wall > 0) ? arcs / wall : 0, mpsrate = (mpswall > 0) ? mps / mpswall : 0;
+
+		file << regions[k] << "," << nodes << "," << arcs << "," << columns << "," << wall << "," << cpu << ","
+			<< arcrate << "," << mps << "," << mpsrate << "," << peak << "\n";
+		printf("%7d %8.0f %8.0f %10.2f %9.0f %10.1f %10.1f %11.1f\n", regions[k], arcs, columns, wall, arcrate, mps, mpsrate, peak);
+		fflush(stdout);
+	}
+	file.close();
+	cout << "- Results written to 'bench/bench.csv'\n";
+	return 0;
+}
@@ -0,0 +1,507 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    netgen.cpp -- Generator of synthetic data sets
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+// Writes a complete data set (folder/data/) with the same structure as the
+// national one: electric regions with demand and generation technologies,
+// coal production shipped by the transportation fleets to the coal plants,
+// diesel and electricity used by the fleets, transmission lines and
+// resiliency events. Its size is given by the number of regions,
+// technologies, fleets, years and the step resolution ('y', 'ym' or
+// 'ymh'), and the same options always give the same files.
+//
+//    netgen <folder> [--regions N] [--techs N] [--fleets N] [--years N]
+//                    [--step y|ym|ymh] [--events N] [--benders] [--seed N]
+
+using namespace std;
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <math.h>
+#include <sys/stat.h>
+
+// Declare structure with the size of a synthetic data set
+struct NetSize {
+	int regions, techs, fleets, years, events;
+	string step;
+	bool benders;
+	unsigned long seed;
+};
+
+// Declare structure with the data of a generation technology: letter of its
+// nodes (E?), whether it burns coal brought by the fleets or its energy is
+// free at the node (wind, nuclear fuel, etc.), investment cost (M$/GW),
+// life span (years), operational cost (M$/GWh), CO2 emissions (ton/GWh),
+// capacity factor and share of the demand already installed
+struct Technology {
+	char letter;
+	bool coal;
+	double invcost;
+	int lifespan;
+	double opcost, co2, factor, existing;
+};
+
+static const Technology Technologies[] = {
+	{ 'C', true,  1788, 40, 0.025,  919, 1.00, 0.40 },
+	{ 'G', false,  827, 30, 0.045,  407, 1.00, 0.25 },
+	{ 'N', false, 3156, 60, 0.012,    0, 1.00, 0.20 },
+	{ 'W', false, 1568, 25, 0.000,    0, 0.35, 0.05 },
+	{ 'H', false, 2936, 80, 0.005,    0, 0.50, 0.07 },
+	{ 'V', false, 3500, 30, 0.000,    0, 0.20, 0.00 },
+	{ 'T', false,  551, 30, 0.070,  555, 1.00, 0.08 },
+	{ 'O', false, 1000, 30, 0.120,  808, 1.00, 0.03 },
+	{ 'M', false, 3000, 30, 0.030,    0, 1.00, 0.00 },
+	{ 'A', false, 2500, 30, 0.030,  100, 1.00, 0.00 },
+	{ 'B', false, 2600, 30, 0.030,  120, 1.00, 0.00 },
+	{ 'D', false, 2700, 30, 0.030,  140, 1.00, 0.00 },
+	{ 'F', false, 2800, 30, 0.030,  160, 1.00, 0.00 },
+	{ 'I', false, 2900, 30, 0.030,  180, 1.00, 0.00 },
+	{ 'J', false, 3000, 30, 0.030,  200, 1.00, 0.00 },
+	{ 'K', false, 3100, 30, 0.030,  220, 1.00, 0.00 },
+	{ 'P', false, 3200, 30, 0.030,  240, 1.00, 0.00 },
+	{ 'Q', false, 3300, 30, 0.030,  260, 1.00, 0.00 },
+	{ 'R', false, 3400, 30, 0.030,  280, 1.00, 0.00 },
+	{ 'S', false, 3500, 30, 0.030,  300, 1.00, 0.00 }
+};
+#define MAX_TECHS 20
+
+// Letters of the fleets and of the infrastructures they share (two fleets
+// each, in order): even fleets burn diesel and odd ones use electricity
+static const string FleetLetters = "tkgcefbdijlmnos";
+static const string InfraLetters = "rhapquvwy";
+#define MAX_FLEETS 15
+
+// Pseudo-random numbers (same sequence for the same seed)
+static unsigned long RandomState = 1;
+static double Random(const double low, const double high) {
+	RandomState = (RandomState * 1103515245 + 12345) % 2147483648UL;
+	return low + (high - low) * RandomState / 2147483648.0;
+}
+
+template <class T>
+static string ToString(const T& input) {
+	ostringstream output;
+	output << input;
+	return output.str();
+}
+
+// Two-letter code of a region (AA, AB, ...), used by all its nodes and by
+// the transportation network
+static string Region(const int r) {
+	return string(1, 'A' + r / 26) + string(1, 'A' + r % 26);
+}
+
+// Regions are laid out in a grid, connected to the ones on the right and
+// below
+static vector< pair<int,int> > Corridors(const int regions) {
+	vector< pair<int,int> > output(0);
+	int width = (int) ceil(sqrt((double) regions));
+	for (int r = 0; r < regions; ++r) {
+		if (((r + 1) % width != 0) && (r + 1 < regions)) output.push_back(make_pair(r, r + 1));
+		if (r + width < regions) output.push_back(make_pair(r, r + width));
+	}
+	return output;
+}
+
+// Header of a properties file with one column per year
+static string YearHeader(const string& fields, const int years) {
+	string output = fields;
+	for (int y = 1; y <= years; ++y) output += ",y" + ToString<int>(y);
+	return output;
+}
+
+static bool OpenFile(ofstream& file, const string& name) {
+	file.open(name.c_str());
+	if (!file.is_open()) {
+		cout << "\tERROR: File '" << name << "' can't be written!\n";
+		return false;
+	}
+	return true;
+}
+
+// Electric demand of each region (GW), the same for all the files
+static vector<double> Demand;
+
+static void WriteParameters(const string& folder, const NetSize& size) {
+	ofstream file;
+	if (!OpenFile(file, folder + "/parameters.csv")) return;
+	string length = "y" + ToString<int>(size.years), hours = "8640";
+	if (size.step == "ym") {
+		length += "m12";
+		hours = "720";
+	} else if (size.step == "ymh") {
+		length += "m12h3";
+		hours = "240";
+	}
+	file << "StepName," << size.step << ",\n";
+	file << "StepLength," << length << ",\n";
+	file << "StepHours," << hours << ",\n";
+	file << "UseDCFlow,FALSE,\n";
+	file << "UseBenders," << (size.benders ? "TRUE" : "FALSE") << ",\n";
+	file << "CompressMPS,FALSE,\n";
+	file << "OutputLevel,2,\n";
+	file << "PrepThreads,1,\n";
+	file << "IncrementalPrep,FALSE,\n";
+	file << "ReduceModel,TRUE,\n";
+	file << "CodeDC,EL,\n";
+	file << "DefStep,y,\n";
+	file << "DefInflation,0.02,\n";
+	file << "DefDiscount,0.07,\n";
+	file << "TransStep,y,\n";
+	for (int f = 0; f < size.fleets; f += 2)
+		file << "TransInfra," << InfraLetters[f/2] << FleetLetters.substr(f, (f + 1 < size.fleets) ? 2 : 1) << ",\n";
+	if (size.fleets > 0) {
+		file << "% Coal can use all the fleets,\n";
+		file << "TransComm,1" << FleetLetters.substr(0, size.fleets) << ",\n";
+		file << "TransCoal,1,\n";
+	}
+	file << "popsize,8,\n";
+	file << "ngen,75,\n";
+	file << "AddObj,EmCO2,\n";
+	file << "NumberEvents," << size.events << ",\n";
+	file << "pstart,0.15,\n";
+	file << "pmut_bin,0.2,\n";
+	file << "pcross_bin,0.1,\n";
+	file << "stages,2,\n";
+	file << "Sobjeval," << size.years << ",\n";
+	file << "cofire,0.111111111,\n";
+	file << "segmnt,15,\n";
+	file.close();
+}
+
+static void WriteNodes(const string& folder, const NetSize& size) {
+	ofstream file;
+	if (OpenFile(file, folder + "/nodes_List.csv")) {
+		file << "code,\n";
+		file << "% Electricity demand,\n";
+		for (int r = 0; r < size.regions; ++r) file << "EL" << Region(r) << "\n";
+		file << "% Generation technologies,\n";
+		for (int t = 0; t < size.techs; ++t)
+			for (int r = 0; r < size.regions; ++r) file << 'E' << Technologies[t].letter << Region(r) << "\n";
+		file << "% Coal production and coal at each region,\n";
+		for (int r = 0; r < size.regions; r += 3) file << "CP" << Region(r) << "\n";
+		for (int r = 0; r < size.regions; ++r) file << "1T" << Region(r) << "\n";
+		file << "% Diesel for the fleets,\n";
+		for (int r = 0; r < size.regions; ++r) file << "XD" << Region(r) << "\n";
+		for (int r = 0; r < size.regions; ++r) file << "DD" << Region(r) << "\n";
+		file.close();
+	}
+
+	if (OpenFile(file, folder + "/nodes_Step.csv")) {
+		file << "code,step\n";
+		file << "E," << size.step << " % Electricity nodes\n";
+		file << "CP,y\n";
+		file << "1,y\n";
+		file << "X,y\n";
+		file << "D,y\n";
+		file.close();
+	}
+
+	// Coal production and technologies with free energy are sources
+	if (OpenFile(file, folder + "/nodes_Demand.csv")) {
+		file << "code,const\n";
+		file << "CP,X % Coal production\n";
+		for (int t = 0; t < size.techs; ++t)
+			if (!Technologies[t].coal) file << 'E' << Technologies[t].letter << ",X\n";
+		file.close();
+	}
+
+	if (OpenFile(file, folder + "/nodes_DemandPower.csv")) {
+		file << "code,const\n";
+		file << "% Electrical demand (GW),\n";
+		for (int r = 0; r < size.regions; ++r) file << "EL" << Region(r) << "," << Demand[r] << "\n";
+		file.close();
+	}
+
+	if (OpenFile(file, folder + "/nodes_PeakPower.csv")) {
+		file << "code,const\n";
+		file << "% Electrical demand (GW),\n";
+		for (int r = 0; r < size.regions; ++r) file << "EL" << Region(r) << "," << 1.3 * Demand[r] << "\n";
+		file.close();
+	}
+
+	const char* names[3] = { "/nodes_DemandRate.csv", "/nodes_PeakPowerRate.csv", "/nodes_CostUD.csv" };
+	const char* values[3] = { "EL,0.015\n", "EL,0.02\n", "EL,10\n" };
+	for (int k = 0; k < 3; ++k) {
+		if (!OpenFile(file, folder + names[k])) continue;
+		file << "code,const\n" << values[k];
+		file.close();
+	}
+}
+
+static void WriteArcs(const string& folder, const NetSize& size) {
+	vector< pair<int,int> > lines = Corridors(size.regions);
+	ofstream file;
+	if (OpenFile(file, folder + "/arcs_List.csv")) {
+		file << "from,to,\n";
+		file << "% Coal production to transportation node,,\n";
+		for (int r = 0; r < size.regions; r += 3) file << "CP" << Region(r) << ",1T" << Region(r) << ",\n";
+		file << "% Generation,,\n";
+		for (int t = 0; t < size.techs; ++t) {
+			for (int r = 0; r < size.regions; ++r) {
+				if (Technologies[t].coal) file << "1T" << Region(r) << ",EC" << Region(r) << ",\n";
+				file << 'E' << Technologies[t].letter << Region(r) << ",EL" << Region(r) << ",\n";
+			}
+		}
+		file << "% Transmission lines,,\n";
+		for (unsigned int k = 0; k < lines.size(); ++k)
+			file << "EL" << Region(lines[k].first) << ",EL" << Region(lines[k].second) << ",\n";
+		file << "% Diesel supply,,\n";
+		for (int r = 0; r < size.regions; ++r) file << "XD" << Region(r) << ",DD" << Region(r) << ",\n";
+		file.close();
+	}
+
+	// Existing capacity of the generators (retired along their life span),
+	// transmission lines, coal production and fleets
+	if (OpenFile(file, folder + "/arcs_OpMax.csv")) {
+		file << YearHeader("from,to,const", size.years) << "\n";
+		file << "% Coal production (thousand short ton / h),,\n";
+		for (int r = 0; r < size.regions; r += 3) file << "CP" << Region(r) << ",1T" << Region(r) << "," << Random(0.5, 3) << "\n";
+		file << "% Generation (GW),,\n";
+		for (int t = 0; t < size.techs; ++t) {
+			const Technology& tech = Technologies[t];
+			if (tech.existing == 0) {
+				file << 'E' << tech.letter << ",EL,0\n";
+				continue;
+			}
+			for (int r = 0; r < size.regions; ++r) {
+				double capacity = tech.existing * Demand[r] * Random(0.5, 1.5), age = Random(0, tech.lifespan);
+				file << 'E' << tech.letter << Region(r) << ",EL" << Region(r) << ",";
+				for (int y = 1; y <= size.years; ++y)
+					file << "," << ((y + age < tech.lifespan) ? capacity * (1 - (y + age) / tech.lifespan) : 0);
+				file << "\n";
+			}
+		}
+		file << "% Transmission (GW),,\n";
+		for (unsigned int k = 0; k < lines.size(); ++k)
+			file << "EL" << Region(lines[k].first) << ",EL" << Region(lines[k].second) << "," << Random(1, 5) << "\n";
+		if (size.fleets > 0) file << "% Fleets and infrastructures (vehicles),,\n";
+		for (unsigned int k = 0; k < lines.size(); ++k) {
+			for (int d = 0; d < 2; ++d) {
+				string codes = d ? Region(lines[k].second) + Region(lines[k].first) : Region(lines[k].first) + Region(lines[k].second);
+				for (int f = 0; f < size.fleets; ++f)
+					file << FleetLetters[f] << FleetLetters[f] << codes << ",," << Random(100, 5000) << "\n";
+				for (int f = 0; f < size.fleets; f += 2)
+					file << InfraLetters[f/2] << InfraLetters[f/2] << codes << ",," << Random(5000, 20000) << "\n";
+			}
+		}
+		file.close();
+	}
+
+	if (OpenFile(file, folder + "/arcs_OpCost.csv")) {
+		file << "from,to,const\n";
+		file << "% Coal production (Million $ / thousand short ton),,\n";
+		file << "CP,1T,0.04\n";
+		file << "% Generation (Million $ / GWh),,\n";
+		for (int t = 0; t < size.techs; ++t)
+			if (Technologies[t].opcost != 0) file << 'E' << Technologies[t].letter << ",EL," << Technologies[t].opcost << "\n";
+		file << "% Diesel (Million $ / MM gallon),,\n";
+		file << "XD,DD,2.5\n";
+		for (int f = 0; f < size.fleets; ++f)
+			file << FleetLetters[f] << FleetLetters[f] << ",," << 0.00001 * (f + 1) << "\n";
+		file.close();
+	}
+
+	if (OpenFile(file, folder + "/arcs_Eff.csv")) {
+		file << "from,to,const\n";
+		file << "% Generation from coal (GWh / thousand short ton),,\n";
+		file << "1T,EC,2.1\n";
+		for (int t = 0; t < size.techs; ++t)
+			if (Technologies[t].coal) file << 'E' << Technologies[t].letter << ",EL,0.85\n";
+		file << "% Transmission losses,,\n";
+		file << "EL,EL,0.98\n";
+		for (int f = 0; f < size.fleets; ++f)
+			file << FleetLetters[f] << FleetLetters[f] << ",," << Random(1, 20) << "\n";
+		file.close();
+	}
+
+	if (OpenFile(file, folder + "/arcs_InvertEff.csv")) {
+		file << "from,to,const\n";
+		for (int f = 0; f < size.fleets; ++f)
+			file << FleetLetters[f] << FleetLetters[f] << ",,1\n";
+		file.close();
+	}
+
+	if (OpenFile(file, folder + "/arcs_InvCost.csv")) {
+		file << "from,to,const\n";
+		file << "% Electric generation (million$/GW),,\n";
+		for (int t = 0; t < size.techs; ++t)
+			file << 'E' << Technologies[t].letter << ",E," << Technologies[t].invcost << "\n";
+		file << "% Transmission (million$/GW),,\n";
+		file << "EL,EL,900\n";
+		file << "% Fleets (million$/vehicle),,\n";
+		for (int f = 0; f < size.fleets; ++f)
+			file << FleetLetters[f] << FleetLetters[f] << ",," << Random(0.01, 2) << "\n";
+		file.close();
+	}
+
+	if (OpenFile(file, folder + "/arcs_InvMax.csv")) {
+		file << "from,to,const\n";
+		for (int t = 0; t < size.techs; ++t)
+			if (Technologies[t].factor < 1) file << 'E' << Technologies[t].letter << ",EL,5\n";
+		for (int f = 0; f < size.fleets; ++f)
+			file << FleetLetters[f] << FleetLetters[f] << ",,10000\n";
+		file.close();
+	}
+
+	if (OpenFile(file, folder + "/arcs_InvStart.csv")) {
+		file << "from,to,const\n";
+		file << "E,EL,y2\n";
+		for (int f = 0; f < size.fleets; ++f)
+			file << FleetLetters[f] << FleetLetters[f] << ",,y2\n";
+		file.close();
+	}
+
+	if (OpenFile(file, folder + "/arcs_LifeSpan.csv")) {
+		file << "from,to,const\n";
+		for (int t = 0; t < size.techs; ++t)
+			file << 'E' << Technologies[t].letter << ",EL,y" << Technologies[t].lifespan << "\n";
+		file << "EL,EL,y40\n";
+		for (int f = 0; f < size.fleets; ++f)
+			file << FleetLetters[f] << FleetLetters[f] << ",,y" << 12 + 4 * f << "\n";
+		file.close();
+	}
+
+	if (OpenFile(file, folder + "/arcs_CapacityFactor.csv")) {
+		file << "from,to,const\n";
+		for (int t = 0; t < size.techs; ++t)
+			file << 'E' << Technologies[t].letter << ",E," << Technologies[t].factor << "\n";
+		file.close();
+	}
+
+	if (OpenFile(file, folder + "/arcs_OpEmCO2.csv")) {
+		file << "from,to,const\n";
+		file << "% Generators (short ton per GWh),,\n";
+		for (int t = 0; t < size.techs; ++t)
+			if (Technologies[t].co2 != 0) file << 'E' << Technologies[t].letter << ",EL," << Technologies[t].co2 << "\n";
+		file << "% Diesel (short ton per MM gallon),,\n";
+		file << "XD,DD,10180\n";
+		file.close();
+	}
+
+	// Energy used by the fleets at both ends of each corridor
+	if (OpenFile(file, folder + "/arcs_TransEnergy.csv")) {
+		file << "from,to,const\n";
+		file << "% Diesel fleets (MM gallon / vehicle mile) and electric fleets (GWh / vehicle mile),,\n";
+		for (unsigned int k = 0; k < lines.size(); ++k) {
+			double miles = Random(100, 600);
+			for (int d = 0; d < 2; ++d) {
+				string from = Region(d ? lines[k].second : lines[k].first), to = Region(d ? lines[k].first : lines[k].second);
+				for (int f = 0; f < size.fleets; ++f) {
+					string node = (f % 2) ? "EL" : "DD";
+					file << FleetLetters[f] << FleetLetters[f] << from << to << ',' << node << from << ',' << miles * 1e-8 << "\n";
+					file << FleetLetters[f] << FleetLetters[f] << from << to << ',' << node << to << ',' << miles * 1e-8 << "\n";
+				}
+			}
+		}
+		file.close();
+	}
+
+	// Cost of the coal production in three segments
+	if (OpenFile(file, folder + "/arcs_CostCurve.csv")) {
+		file << "from,to,step,segment,breakpoint,cost\n";
+		for (int r = 0; r < size.regions; r += 3) {
+			double capacity = Random(0.5, 3);
+			for (int s = 1; s <= 3; ++s)
+				file << "CP" << Region(r) << ",1T" << Region(r) << ",const," << s << "," << capacity * s / 3 << "," << 0.02 * s << "\n";
+		}
+		file.close();
+	}
+
+	if (OpenFile(file, folder + "/trans_List.csv")) {
+		file << "from,to,mileage,fleet\n";
+		for (unsigned int k = 0; k < lines.size(); ++k) {
+			// Some corridors don't have the last fleet
+			int fleets = ((k % 3 == 2) && (size.fleets > 1)) ? size.fleets - 1 : size.fleets;
+			file << Region(lines[k].first) << "," << Region(lines[k].second) << "," << Random(100, 600) << "," << FleetLetters.substr(0, fleets) << "\n";
+		}
+		file.close();
+	}
+
+	if (OpenFile(file, folder + "/sust_Limits.csv")) {
+		file << YearHeader("code", size.years) << "\n";
+		file << "% CO2 limits (short ton) can be given here,\n";
+		file.close();
+	}
+}
+
+// Capacity lost by some generators in a few consecutive years
+static void WriteEvents(const string& folder, const NetSize& size) {
+	if (size.events > 0) mkdir((folder + "/events").c_str(), 0777);
+	for (int j = 1; j <= size.events; ++j) {
+		ofstream file;
+		if (!OpenFile(file, folder + "/events/CapacityLoss" + ToString<int>(j) + ".csv")) continue;
+		int first = 1 + (int) Random(0, size.years - 1), last = (first + 2 < size.years) ? first + 2 : size.years;
+		file << "from,to";
+		for (int y = first; y <= last; ++y) file << ",y" << y;
+		file << "\n";
+		const Technology& tech = Technologies[(j - 1) % size.techs];
+		for (int r = (j - 1) % 4; r < size.regions; r += 4) {
+			file << 'E' << tech.letter << ",EL" << Region(r);
+			for (int y = first; y <= last; ++y) file << "," << 0.5 + 0.2 * (y - first);
+			file << "\n";
+		}
+		file.close();
+	}
+}
+
+int main(int argc, char* argv[]) {
+	NetSize size;
+	size.regions = 13;
+	size.techs = 6;
+	size.fleets = 4;
+	size.years = 20;
+	size.events = 0;
+	size.step = "ym";
+	size.benders = false;
+	size.seed = 1;
+
+	string folder = "";
+	for (int a = 1; a < argc; ++a) {
+		string option = argv[a];
+		bool value = (a + 1 < argc);
+		if (option == "--benders") size.benders = true;
+		else if ((option == "--regions") && value) size.regions = atoi(argv[++a]);
+		else if ((option == "--techs") && value) size.techs = atoi(argv[++a]);
+		else if ((option == "--fleets") && value) size.fleets = atoi(argv[++a]);
+		else if ((option == "--years") && value) size.years = atoi(argv[++a]);
+		else if ((option == "--events") && value) size.events = atoi(argv[++a]);
+		else if ((option == "--step") && value) size.step = argv[++a];
+		else if ((option == "--seed") && value) size.seed = atol(argv[++a]);
+		else if ((option[0] != '-') && folder.empty()) folder = option;
+		else cout << "\tWarning: Unknown option '" << option << "' is ignored\n";
+	}
+	if (folder.empty()) {
+		cout << "Usage: netgen <folder> [--regions N] [--techs N] [--fleets N] [--years N] [--step y|ym|ymh] [--events N] [--benders] [--seed N]\n";
+		return 1;
+	}
+	if ((size.regions < 1) || (size.regions > 26 * 26) || (size.techs < 1) || (size.techs > MAX_TECHS) || (size.fleets < 0)
+		|| (size.fleets > MAX_FLEETS) || (size.years < 2) || (size.events < 0)
+		|| ((size.step != "y") && (size.step != "ym") && (size.step != "ymh"))) {
+		cout << "\tERROR: Invalid size (1-676 regions, 1-" << MAX_TECHS << " technologies, 0-" << MAX_FLEETS
+			<< " fleets, 2 or more years and step 'y', 'ym' or 'ymh')\n";
+		return 1;
+	}
+
+	RandomState = size.seed;
+	Demand.resize(size.regions);
+	for (int r = 0; r < size.regions; ++r) Demand[r] = Random(5, 100);
+
+	mkdir(folder.c_str(), 0777);
+	string data = folder + "/data";
+	mkdir(data.c_str(), 0777);
+	WriteParameters(data, size);
+	WriteNodes(data, size);
+	WriteArcs(data, size);
+	WriteEvents(data, size);
+
+	cout << "- Data set written to '" << data << "': " << size.regions << " regions, " << size.techs << " technologies, "
+		<< size.fleets << " fleets, " << size.years << " years, step '" << size.step << "'\n";
+	return 0;
+}
@@ -8,20 +8,33 @@
 #include "global.h"
 #include "node.h"
 #include "arc.h"
+#include "network.h"
+#include "model.h"
 #include "index.h"
+#include "cache.h"
 #include "read.h"
 #include "write.h"
 
 // Global variables
 string SName;
 Step SLength, steplife;
-bool useDCflow = false, useBenders = false, useEndSalvg= true, useEndPrimE= false, useEndDualE= false, useEndFixed= false;// Venkat End effect Apr 12 2013
+bool useDCflow = false, useBenders = false, useCompressMPS = false, useEndSalvg= true, useEndPrimE= false, useEndDualE= false, useEndFixed= false, useIncrementalPrep = false, useModelReduction = false, usePruneFleets = false;// Venkat End effect Apr 12 2013
 string DefStep = "", StorageCode = "S", DCCode = "", TransStep = "", TransDummy = "XT", TransCoal = "";
 int Npopsize = 20, Nngen = 200, Nobj = 1, Nevents = 0;
 string Npcross_real = "0.75", Npmut_real = "0.2", Neta_c = "7", Neta_m = "20", Npcross_bin = "0.4", Npmut_bin = "0.7", Nstages = "2";
 double Np_start = 0.5, Loadgrowth = 1.02, CapRed=0.75, Sobjeval=40, cofire=0.1;
-vector<string> ArcProp(0), ArcDefault(0), NodeProp(0), NodeDefault(0), TransInfra(0), TransComm(0), StepHours(0), SustObj(0), SustMet(0);
+vector<string> TransInfra(0), TransComm(0), StepHours(0), SustObj(0), SustMet(0);
+Schema NodeSchema, ArcSchema;
+NodeSlots NSlot;
+ArcSlots ASlot;
 int NodePropOffset = 0, ArcPropOffset = 0, outputLevel = 2, SLengthend=20, life_more=1, segmnt= 15;
+int PrepThreads = 1, SolverThreads = 0, SubproblemWorkers = 0;
+int CutPoolSize = 0, CutPoolAge = 5, BendersCutGroup = 5, BasisStore = 0;
+bool useParetoCuts = false;
+string BendersMode = "kelley", BendersCore = "master", BendersCuts = "year";
+double BendersGap = 0.001, BendersTrustRadius = 0.5, BendersLevel = 0.5, BendersInOutWeight = 0.5;
+string ScenarioFile = "";
+PhaseProfiler Profile;
 // Store indices to recover data after optimization
 Index IdxNode, IdxUd, IdxRm, IdxArc, IdxInv, IdxCap, IdxUb, IdxEm, IdxDc, IdxNsga, IdxHo; // end effects
 
@@ -29,23 +42,34 @@ int FindCode(const string& mystr, const MatrixStr mymatrix);
 int FindCode(const string& strfrom, const string& strto, const MatrixStr mymatrix);
 int FindCode(const Node& mynode, const MatrixStr mymatrix);
 int FindCode(const Arc& myarc, const MatrixStr mymatrix);
+int FindCode(const Node& mynode, const CodeMatcher& matcher);
+int FindCode(const Arc& myarc, const CodeMatcher& matcher);
 
 
-// Write DC Power flow columns in the MPS file
-vector<string> DCFlowColumns(const vector<Node>& v, const vector<Arc>& w) {
-	vector<string> temp_output(SLength[0]+1, "");
-	for (unsigned int i = 0; i < v.size(); ++i) {
-		for (unsigned int j = 0; j < w.size(); ++j) {
-			if (w[j].Get("From") < w[j].Get("To")) {
-				if (v[i].Get("Code") == (w[j].Get("From") + w[j].Get("FromStep"))) {
-					temp_output[ v[i].Time() ] += "    th" + v[i].Get("Code") + " dcpf" + w[j].Get("Code") + " " + w[j].Get("Suscep") + "\n";
-				} else if (v[i].Get("Code") == (w[j].Get("To") + w[j].Get("ToStep"))) {
-					temp_output[ v[i].Time() ] += "    th" + v[i].Get("Code") + " dcpf" + w[j].Get("Code") + " -" + w[j].Get("Suscep") + "\n";
+// Add DC Power flow columns to the model (the angles of each year go together,
+// and only the ones of one year are added if 'year' isn't -1)
+void DCFlowColumns(const ExpandedNetwork& net, ModelBuilder& model, const int year) {
+	vector< vector<int> > years(SLength[0]+1);
+	for (unsigned int i = 0; i < net.dcnodes.size(); ++i)
+		years[ net.nodes[net.dcnodes[i]].Time() ].push_back(net.dcnodes[i]);
+	
+	AdjacencyIndex adjacent;
+	adjacent.Build(net, net.dcnodes, net.dcarcs);
+	for (unsigned int t = 1; t < years.size(); ++t) {
+		if ((year >= 0) && ((int) t != year)) continue;
+		for (unsigned int i = 0; i < years[t].size(); ++i) {
+			NodeRow v = net.nodes[years[t][i]];
+			int col = model.ColumnId("th" + v.Get(NSlot.Code));
+			int k = adjacent.Find(v.Get(NSlot.ShortCode), v.Get(NSlot.Step));
+			for (int j = adjacent.start[k]; j < adjacent.start[k+1]; ++j) {
+				ArcRow w = net.arcs[adjacent.arc[j]];
+				if (w.Get(ASlot.From) < w.Get(ASlot.To)) {
+					double suscep = w.GetValue(ASlot.Suscep);
+					model.AddEntry(t, col, "dcpf" + w.Get(ASlot.Code), adjacent.outgoing[j] ? suscep : -suscep);
 				}
 			}
 		}
 	}
-	return temp_output;
 }
 
 
@@ -115,7 +139,7 @@ int FindCode(const string& strfrom, const string& strto, const MatrixStr mymatri
 
 // Shortcuts for nodes and arcs
 int FindCode(const Node& mynode, const MatrixStr mymatrix) {
-	return FindCode(mynode.Get("ShortCode"), mymatrix);
+	return FindCode(mynode.Get(NSlot.ShortCode), mymatrix);
 }
 
 int FindCode(const Arc& myarc, const MatrixStr mymatrix) {
@@ -123,11 +147,30 @@ int FindCode(const Arc& myarc, const MatrixStr mymatrix) {
 	// Look for properties for the arc in the opposite direction
 	Arc myarc2(myarc, true);
 	if (myarc.isBidirect() || myarc.isTransport()) {
-		int code1 = FindCode(myarc.Get("From"), myarc.Get("To"), mymatrix);
-		int code2 = FindCode(myarc2.Get("From"), myarc2.Get("To"), mymatrix);
+		int code1 = FindCode(myarc.Get(ASlot.From), myarc.Get(ASlot.To), mymatrix);
+		int code2 = FindCode(myarc2.Get(ASlot.From), myarc2.Get(ASlot.To), mymatrix);
+		output = (code1 >= code2) ? code1 : code2;
+	} else {
+		output = FindCode(myarc.Get(ASlot.From), myarc.Get(ASlot.To), mymatrix);
+	}
+	return output;
+}
+
+// Same shortcuts using a matcher prepared in advance (faster for large matrices)
+int FindCode(const Node& mynode, const CodeMatcher& matcher) {
+	return matcher.Find(mynode.Get(NSlot.ShortCode));
+}
+
+int FindCode(const Arc& myarc, const CodeMatcher& matcher) {
+	int output = -1;
+	// Look for properties for the arc in the opposite direction
+	if (myarc.isBidirect() || myarc.isTransport()) {
+		Arc myarc2(myarc, true);
+		int code1 = matcher.Find(myarc.Get(ASlot.From), myarc.Get(ASlot.To));
+		int code2 = matcher.Find(myarc2.Get(ASlot.From), myarc2.Get(ASlot.To));
 		output = (code1 >= code2) ? code1 : code2;
 	} else {
-		output = FindCode(myarc.Get("From"), myarc.Get("To"), mymatrix);
+		output = matcher.Find(myarc.Get(ASlot.From), myarc.Get(ASlot.To));
 	}
 	return output;
 }
@@ -0,0 +1,352 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    network.cpp -- Implementation of the expanded network tables
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+using namespace std;
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <stdlib.h>
+#include <algorithm>
+#include "global.h"
+#include "node.h"
+#include "arc.h"
+#include "network.h"
+
+// Add a string to the pool (if it's new) and return its id
+int StringPool::Add(const string& input) {
+	map<string, int>::iterator it = lookup.find(input);
+	if (it != lookup.end()) return it->second;
+	int id = text.size();
+	text.push_back(input);
+	lookup[input] = id;
+	return id;
+}
+
+const string& StringPool::operator[](const int id) const {
+	return text[id];
+}
+
+int StringPool::size() const {
+	return text.size();
+}
+
+
+// Contructor for the NodeTable class (one column for each declared property)
+NodeTable::NodeTable() :
+	codes(NodeSchema.DefaultCodes().size()),
+	values(NodeSchema.DefaultValues().size()),
+	year(0),
+	flags(0) {}
+
+// Copy a node at the end of the table
+void NodeTable::Add(const Node& mynode) {
+	for (unsigned int s = 0; s < codes.size(); ++s)
+		codes[s].push_back(pool.Add(mynode.Get(s)));
+	for (unsigned int s = 0; s < values.size(); ++s)
+		values[s].push_back(mynode.GetValue(s));
+	year.push_back(mynode.Time());
+
+	int myflags = 0;
+	if (mynode.isDCflow()) myflags |= NF_DCFLOW;
+	if (mynode.isFirstinYear()) myflags |= NF_FIRSTINYEAR;
+	flags.push_back(myflags);
+}
+
+// Copy all the nodes of another table at the end of this one
+void NodeTable::Append(const NodeTable& rhs) {
+	vector<int> newid(rhs.pool.size());
+	for (int i = 0; i < rhs.pool.size(); ++i)
+		newid[i] = pool.Add(rhs.pool[i]);
+	for (unsigned int s = 0; s < codes.size(); ++s)
+		for (unsigned int i = 0; i < rhs.codes[s].size(); ++i)
+			codes[s].push_back(newid[rhs.codes[s][i]]);
+	for (unsigned int s = 0; s < values.size(); ++s)
+		values[s].insert(values[s].end(), rhs.values[s].begin(), rhs.values[s].end());
+	year.insert(year.end(), rhs.year.begin(), rhs.year.end());
+	flags.insert(flags.end(), rhs.flags.begin(), rhs.flags.end());
+}
+
+// Overwrite the nodes from 'row' on with the nodes of another table
+void NodeTable::Replace(const int row, const NodeTable& rhs) {
+	vector<int> newid(rhs.pool.size());
+	for (int i = 0; i < rhs.pool.size(); ++i)
+		newid[i] = pool.Add(rhs.pool[i]);
+	for (unsigned int s = 0; s < codes.size(); ++s)
+		for (unsigned int i = 0; i < rhs.codes[s].size(); ++i)
+			codes[s][row + i] = newid[rhs.codes[s][i]];
+	for (unsigned int s = 0; s < values.size(); ++s)
+		copy(rhs.values[s].begin(), rhs.values[s].end(), values[s].begin() + row);
+	copy(rhs.year.begin(), rhs.year.end(), year.begin() + row);
+	copy(rhs.flags.begin(), rhs.flags.end(), flags.begin() + row);
+}
+
+int NodeTable::size() const {
+	return year.size();
+}
+
+NodeRow NodeTable::operator[](const int row) const {
+	return NodeRow(*this, row);
+}
+
+
+// Contructor for the ArcTable class (one column for each declared property)
+ArcTable::ArcTable() :
+	codes(ArcSchema.DefaultCodes().size()),
+	values(ArcSchema.DefaultValues().size()),
+	year(0),
+	flags(0),
+	t2e(0),
+	t2e_scale(0),
+	couple_key(0),
+	couple_start(1, 0),
+	couple_node(0),
+	couple_value(0),
+	cc_start(1, 0),
+	cc_width(0),
+	cc_cost(0) {}
+
+// Copy an arc at the end of the table
+void ArcTable::Add(const Arc& myarc) {
+	for (unsigned int s = 0; s < codes.size(); ++s)
+		codes[s].push_back(pool.Add(myarc.Get(s)));
+	for (unsigned int s = 0; s < values.size(); ++s)
+		values[s].push_back(myarc.GetValue(s));
+	year.push_back(myarc.Time());
+
+	int myflags = 0;
+	if (myarc.isFirstinYear()) myflags |= AF_FIRSTINYEAR;
+	if (myarc.InvArc()) myflags |= AF_INVARC;
+	if (myarc.InvertEff()) myflags |= AF_INVERTEFF;
+	if (myarc.isDCflow()) myflags |= AF_DCFLOW;
+	if (myarc.isCostCurve()) myflags |= AF_COSTCURVE;
+	if (myarc.isStorage()) myflags |= AF_STORAGE;
+	if (myarc.isBidirect()) myflags |= AF_BIDIRECT;
+	if (myarc.isFirstBidirect()) myflags |= AF_FIRSTBIDIRECT;
+	if (myarc.isTransport()) myflags |= AF_TRANSPORT;
+	if (myarc.isFirstTransport()) myflags |= AF_FIRSTTRANSPORT;
+	if (myarc.GetBool("Energy2Trans")) myflags |= AF_ENERGY2TRANS;
+	flags.push_back(myflags);
+
+	// Energy consumption (a coupling of this table)
+	t2e.push_back(myarc.GetTrans2Energy());
+	t2e_scale.push_back(myarc.GetTrans2EnergyScale());
+	
+	// Segments of the cost curve
+	cc_width.insert(cc_width.end(), myarc.GetCurveWidth().begin(), myarc.GetCurveWidth().end());
+	cc_cost.insert(cc_cost.end(), myarc.GetCurveCost().begin(), myarc.GetCurveCost().end());
+	cc_start.push_back(cc_width.size());
+}
+
+// Copy all the arcs of another table at the end of this one
+void ArcTable::Append(const ArcTable& rhs) {
+	vector<int> newid(rhs.pool.size());
+	for (int i = 0; i < rhs.pool.size(); ++i)
+		newid[i] = pool.Add(rhs.pool[i]);
+	for (unsigned int s = 0; s < codes.size(); ++s)
+		for (unsigned int i = 0; i < rhs.codes[s].size(); ++i)
+			codes[s].push_back(newid[rhs.codes[s][i]]);
+	for (unsigned int s = 0; s < values.size(); ++s)
+		values[s].insert(values[s].end(), rhs.values[s].begin(), rhs.values[s].end());
+	year.insert(year.end(), rhs.year.begin(), rhs.year.end());
+	flags.insert(flags.end(), rhs.flags.begin(), rhs.flags.end());
+	
+	// Couplings with the same key are only stored once
+	vector<int> newcouple(rhs.couple_key.size());
+	for (unsigned int c = 0; c < rhs.couple_key.size(); ++c)
+		newcouple[c] = CopyCoupling(rhs, c, newid, false);
+	for (unsigned int i = 0; i < rhs.t2e.size(); ++i)
+		t2e.push_back((rhs.t2e[i] < 0) ? -1 : newcouple[rhs.t2e[i]]);
+	t2e_scale.insert(t2e_scale.end(), rhs.t2e_scale.begin(), rhs.t2e_scale.end());
+	
+	int offset = cc_width.size();
+	for (unsigned int i = 1; i < rhs.cc_start.size(); ++i)
+		cc_start.push_back(rhs.cc_start[i] + offset);
+	cc_width.insert(cc_width.end(), rhs.cc_width.begin(), rhs.cc_width.end());
+	cc_cost.insert(cc_cost.end(), rhs.cc_cost.begin(), rhs.cc_cost.end());
+}
+
+// Overwrite the arcs from 'row' on with the arcs of another table. Their
+// couplings overwrite the ones with the same key, which must have the same
+// number of entries, and their cost curves must have the same number of
+// segments (false otherwise).
+bool ArcTable::Replace(const int row, const ArcTable& rhs) {
+	for (int i = 0; i < rhs.size(); ++i)
+		if (rhs.cc_start[i+1] - rhs.cc_start[i] != cc_start[row+i+1] - cc_start[row+i]) return false;
+	vector<int> newid(rhs.pool.size());
+	for (int i = 0; i < rhs.pool.size(); ++i)
+		newid[i] = pool.Add(rhs.pool[i]);
+	vector<int> newcouple(rhs.couple_key.size());
+	for (unsigned int c = 0; c < rhs.couple_key.size(); ++c) {
+		newcouple[c] = CopyCoupling(rhs, c, newid, true);
+		if (newcouple[c] < 0) return false;
+	}
+	
+	for (unsigned int s = 0; s < codes.size(); ++s)
+		for (unsigned int i = 0; i < rhs.codes[s].size(); ++i)
+			codes[s][row + i] = newid[rhs.codes[s][i]];
+	for (unsigned int s = 0; s < values.size(); ++s)
+		copy(rhs.values[s].begin(), rhs.values[s].end(), values[s].begin() + row);
+	copy(rhs.year.begin(), rhs.year.end(), year.begin() + row);
+	copy(rhs.flags.begin(), rhs.flags.end(), flags.begin() + row);
+	for (unsigned int i = 0; i < rhs.t2e.size(); ++i)
+		t2e[row + i] = (rhs.t2e[i] < 0) ? -1 : newcouple[rhs.t2e[i]];
+	copy(rhs.t2e_scale.begin(), rhs.t2e_scale.end(), t2e_scale.begin() + row);
+	copy(rhs.cc_width.begin(), rhs.cc_width.end(), cc_width.begin() + cc_start[row]);
+	copy(rhs.cc_cost.begin(), rhs.cc_cost.end(), cc_cost.begin() + cc_start[row]);
+	return true;
+}
+
+int ArcTable::size() const {
+	return year.size();
+}
+
+int ArcTable::FindCoupling(const long long key) const {
+	map<long long, int>::const_iterator it = couple_lookup.find(key);
+	return (it != couple_lookup.end()) ? it->second : -1;
+}
+
+// Store a coupling (energy nodes and energy per unit of flow)
+int ArcTable::AddCoupling(const long long key, const vector<string>& nodes, const vector<double>& values) {
+	int c = couple_key.size();
+	couple_key.push_back(key);
+	couple_lookup[key] = c;
+	for (unsigned int k = 0; k < nodes.size(); ++k) {
+		couple_node.push_back(pool.Add(nodes[k]));
+		couple_value.push_back(values[k]);
+	}
+	couple_start.push_back(couple_node.size());
+	return c;
+}
+
+// Find the couplings by key again (after the arrays are loaded)
+void ArcTable::IndexCouplings() {
+	couple_lookup.clear();
+	for (unsigned int c = 0; c < couple_key.size(); ++c)
+		couple_lookup[couple_key[c]] = c;
+}
+
+// Copy coupling 'c' of another table ('newid' are the ids of its codes in
+// this pool), unless there is one with the same key, which is overwritten
+// if asked to. -1 if the one to overwrite has a different size.
+int ArcTable::CopyCoupling(const ArcTable& rhs, const int c, const vector<int>& newid, const bool overwrite) {
+	int begin = rhs.couple_start[c], end = rhs.couple_start[c+1];
+	int output = FindCoupling(rhs.couple_key[c]);
+	if (output < 0) {
+		output = couple_key.size();
+		couple_key.push_back(rhs.couple_key[c]);
+		couple_lookup[rhs.couple_key[c]] = output;
+		for (int k = begin; k < end; ++k) {
+			couple_node.push_back(newid[rhs.couple_node[k]]);
+			couple_value.push_back(rhs.couple_value[k]);
+		}
+		couple_start.push_back(couple_node.size());
+	} else if (overwrite) {
+		int offset = couple_start[output];
+		if (couple_start[output+1] - offset != end - begin) return -1;
+		for (int k = begin; k < end; ++k) {
+			couple_node[offset + k - begin] = newid[rhs.couple_node[k]];
+			couple_value[offset + k - begin] = rhs.couple_value[k];
+		}
+	}
+	return output;
+}
+
+ArcRow ArcTable::operator[](const int row) const {
+	return ArcRow(*this, row);
+}
+
+
+// Store a node or an arc after expansion
+void ExpandedNetwork::Add(const Node& mynode) {
+	if (mynode.isDCflow())
+		dcnodes.push_back(nodes.size());
+	nodes.Add(mynode);
+}
+
+void ExpandedNetwork::Add(const Arc& myarc) {
+	if (myarc.isDCflow())
+		dcarcs.push_back(arcs.size());
+	arcs.Add(myarc);
+}
+
+// Copy another network at the end of this one (rows keep their order)
+void ExpandedNetwork::Append(const ExpandedNetwork& rhs) {
+	for (unsigned int i = 0; i < rhs.dcnodes.size(); ++i)
+		dcnodes.push_back(rhs.dcnodes[i] + nodes.size());
+	for (unsigned int i = 0; i < rhs.dcarcs.size(); ++i)
+		dcarcs.push_back(rhs.dcarcs[i] + arcs.size());
+	nodes.Append(rhs.nodes);
+	arcs.Append(rhs.arcs);
+}
+
+
+// Index the given rows of a network (the lists are built in two passes:
+// count the arcs of each key, then fill them in order)
+void AdjacencyIndex::Build(const ExpandedNetwork& net, const vector<int>& noderows, const vector<int>& arcrows) {
+	lookup.clear();
+	node.clear();
+	for (unsigned int i = 0; i < noderows.size(); ++i) {
+		NodeRow v = net.nodes[noderows[i]];
+		int k = Key(v.Get(NSlot.ShortCode), v.Get(NSlot.Step));
+		if (node[k] == -1) node[k] = noderows[i];
+	}
+	
+	// Keys of both ends of each arc (a loop is only listed once, as outgoing)
+	vector<int> fromkey(arcrows.size()), tokey(arcrows.size());
+	for (unsigned int j = 0; j < arcrows.size(); ++j) {
+		ArcRow w = net.arcs[arcrows[j]];
+		fromkey[j] = Key(w.Get(ASlot.From), w.Get(ASlot.FromStep));
+		tokey[j] = Key(w.Get(ASlot.To), w.Get(ASlot.ToStep));
+	}
+	
+	start.assign(node.size() + 1, 0);
+	for (unsigned int j = 0; j < arcrows.size(); ++j) {
+		++start[fromkey[j] + 1];
+		if (tokey[j] != fromkey[j]) ++start[tokey[j] + 1];
+	}
+	for (unsigned int k = 0; k < node.size(); ++k)
+		start[k+1] += start[k];
+	
+	vector<int> next(start.begin(), start.end() - 1);
+	arc.assign(start.back(), 0);
+	outgoing.assign(start.back(), false);
+	for (unsigned int j = 0; j < arcrows.size(); ++j) {
+		arc[next[fromkey[j]]] = arcrows[j];
+		outgoing[next[fromkey[j]]++] = true;
+		if (tokey[j] != fromkey[j])
+			arc[next[tokey[j]]++] = arcrows[j];
+	}
+}
+
+// Key of a node (-1 if it's not in the index)
+int AdjacencyIndex::Find(const string& shortcode, const string& step) const {
+	map< pair<string, string>, int >::const_iterator it = lookup.find(make_pair(shortcode, step));
+	return (it != lookup.end()) ? it->second : -1;
+}
+
+int AdjacencyIndex::size() const {
+	return node.size();
+}
+
+// Key of a node (it's added to the index if it's new)
+int AdjacencyIndex::Key(const string& shortcode, const string& step) {
+	pair< map< pair<string, string>, int >::iterator, bool > it = lookup.insert(make_pair(make_pair(shortcode, step), (int) node.size()));
+	if (it.second) node.push_back(-1);
+	return it.first->second;
+}
+
+// Find the rows of nodes and arcs that are part of DC flow constraints
+// (after the tables are changed in place)
+void ExpandedNetwork::FindDC() {
+	dcnodes.clear();
+	for (int i = 0; i < nodes.size(); ++i)
+		if (nodes.flags[i] & NF_DCFLOW) dcnodes.push_back(i);
+	dcarcs.clear();
+	for (int i = 0; i < arcs.size(); ++i)
+		if (arcs.flags[i] & AF_DCFLOW) dcarcs.push_back(i);
+}
@@ -0,0 +1,138 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    network.h -- Definition of the expanded network tables
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+#ifndef _NETWORK_H_
+#define _NETWORK_H_
+
+// Flags evaluated once, when a node or an arc is added to a table
+enum NodeFlags {
+	NF_DCFLOW = 1,
+	NF_FIRSTINYEAR = 2
+};
+
+enum ArcFlags {
+	AF_FIRSTINYEAR = 1,
+	AF_INVARC = 2,
+	AF_INVERTEFF = 4,
+	AF_DCFLOW = 8,
+	AF_COSTCURVE = 16,
+	AF_STORAGE = 32,
+	AF_BIDIRECT = 64,
+	AF_FIRSTBIDIRECT = 128,
+	AF_TRANSPORT = 256,
+	AF_FIRSTTRANSPORT = 512,
+	AF_ENERGY2TRANS = 1024
+};
+
+// Declare class type to store each different string only once
+class StringPool {
+	public:
+		int Add(const string& input);
+		const string& operator[](const int id) const;
+		int size() const;
+
+	private:
+		vector<string> text;
+		map<string, int> lookup;
+};
+
+// Declare class type to store expanded nodes by columns: one array per property
+class NodeTable {
+	public:
+		NodeTable();
+		void Add(const Node& mynode);
+		void Append(const NodeTable& rhs);
+		void Replace(const int row, const NodeTable& rhs);
+		int size() const;
+		NodeRow operator[](const int row) const;
+
+		// Columns (string codes are ids in 'pool')
+		StringPool pool;
+		vector< vector<int> > codes;
+		vector< vector<double> > values;
+		vector<int> year, flags;
+};
+
+// Declare class type to store expanded arcs by columns: one array per property
+class ArcTable {
+	public:
+		ArcTable();
+		void Add(const Arc& myarc);
+		void Append(const ArcTable& rhs);
+		bool Replace(const int row, const ArcTable& rhs);
+		int size() const;
+		ArcRow operator[](const int row) const;
+
+		// Couplings with the energy nodes, found by a key given by whoever
+		// adds them (-1 if there isn't any with that key)
+		int FindCoupling(const long long key) const;
+		int AddCoupling(const long long key, const vector<string>& nodes, const vector<double>& values);
+		void IndexCouplings();
+
+		// Columns (string codes are ids in 'pool')
+		StringPool pool;
+		vector< vector<int> > codes;
+		vector< vector<double> > values;
+		vector<int> year, flags;
+
+		// Energy consumed by each arc (arcs_TransEnergy.csv): coupling t2e[i]
+		// (-1 if none) multiplied by t2e_scale[i]. Couplings are a sparse
+		// matrix shared by the arcs: the entries of coupling 'c' (energy node,
+		// as an id in 'pool', and energy per unit of flow) go from position
+		// couple_start[c] to couple_start[c+1]-1.
+		vector<int> t2e;
+		vector<double> t2e_scale;
+		vector<long long> couple_key;
+		vector<int> couple_start, couple_node;
+		vector<double> couple_value;
+
+		// Cost curve of each arc with AF_COSTCURVE: the width and cost of its
+		// segments go from position cc_start[i] to cc_start[i+1]-1
+		vector<int> cc_start;
+		vector<double> cc_width, cc_cost;
+
+	private:
+		int CopyCoupling(const ArcTable& rhs, const int c, const vector<int>& newid, const bool overwrite);
+		map<long long, int> couple_lookup;
+};
+
+// Declare class type to hold the network after expansion in steps
+class ExpandedNetwork {
+	public:
+		void Add(const Node& mynode);
+		void Add(const Arc& myarc);
+		void Append(const ExpandedNetwork& rhs);
+		void FindDC();
+
+		NodeTable nodes;
+		ArcTable arcs;
+		// Rows of nodes and arcs that are part of DC flow constraints
+		vector<int> dcnodes, dcarcs;
+};
+
+// Declare class type to find the arcs incident to each node. Nodes are keyed
+// on their short code and step, which is how arcs name their endpoints
+// ('From'/'FromStep' and 'To'/'ToStep'), so no codes need to be concatenated.
+// The arcs of key 'k' go from position start[k] to start[k+1]-1, in the same
+// order as they were given, and 'outgoing' tells if the node is the 'from' end.
+class AdjacencyIndex {
+	public:
+		void Build(const ExpandedNetwork& net, const vector<int>& noderows, const vector<int>& arcrows);
+		int Find(const string& shortcode, const string& step) const;
+		int size() const;
+
+		// Node row of each key (-1 if the key only appears in arcs)
+		vector<int> node;
+		vector<int> start, arc;
+		vector<bool> outgoing;
+
+	private:
+		int Key(const string& shortcode, const string& step);
+		map< pair<string, string>, int > lookup;
+};
+
+#endif  // _NETWORK_H_
@@ -13,162 +13,239 @@ using namespace std;
 #include <stdlib.h> // May 26 2013
 #include "global.h"
 #include "node.h"
+#include "arc.h"
+#include "network.h"
+#include "model.h"
 
 // Contructors and destructor for the Node class
-Node::Node() : Properties(NodeDefault) {}
+Node::Node() :
+	Codes(NodeSchema.DefaultCodes()),
+	Values(NodeSchema.DefaultValues()) {}
 
-Node::Node(const Node& rhs) : Properties(rhs.GetVecStr()) {}
+Node::Node(const Node& rhs) :
+	Codes(rhs.Codes),
+	Values(rhs.Values) {}
 
 Node::~Node() {}
 
 Node& Node::operator=(const Node& rhs) {
-	Properties = rhs.GetVecStr();
+	Codes = rhs.Codes;
+	Values = rhs.Values;
 	return *this;
 }
 
+// Read a string code
+const string& Node::Get(const int slot) const {
+	return Codes[slot];
+}
+
+// Read a numeric value as stored (NaN if it's missing)
+double Node::GetValue(const int slot) const {
+	return Values[slot];
+}
+
+// Read a numeric value (zero if it's missing)
+double Node::GetDouble(const int slot) const {
+	return (Values[slot] == Values[slot]) ? Values[slot] : 0;
+}
+
+// Read a numeric value in string format
+string Node::GetText(const int slot) const {
+	return Num2Str(Values[slot]);
+}
+
+// Is the numeric value given? (i.e., not 'X')
+bool Node::Has(const int slot) const {
+	return Values[slot] == Values[slot];
+}
+
+// Modify a string code
+void Node::Set(const int slot, const string& input) {
+	Codes[slot] = input;
+}
+
+// Modify a numeric value
+void Node::SetDouble(const int slot, const double input) {
+	Values[slot] = input;
+}
+
+// Multiply stored values by 'value'
+void Node::Multiply(const int slot, const double value) {
+	if ((Values[slot] == Values[slot]) && (Values[slot] != 0))
+		Values[slot] = Values[slot] * value;
+}
+
 // Read a node property in string format
 string Node::Get(const string& selector) const {
 	string temp_output;
-	int index = FindNodeSelector(selector);
-	if (index >= 0) temp_output = Properties[index];
-	else {
+	int index = NodeSchema.Find(selector);
+	if (index >= 0) {
+		if (NodeSchema.isNumeric(index))
+			temp_output = GetText(NodeSchema.Slot(index));
+		else
+			temp_output = Codes[NodeSchema.Slot(index)];
+	} else {
 		temp_output = "ERROR";
 		printError("noderead", selector);
 	};
 	return temp_output;
 };
 
-// Read a property as a double
-double Node::GetDouble(const string& selector) const {
-	double output;
-	output = (Get(selector) != "X") ? atof(Get(selector).c_str()) : 0;
-	return output;
-}
-
-// Copy the entire vector of properties
-vector<string> Node::GetVecStr() const {
-	return Properties;
-};
-
 // Modify a property
 void Node::Set(const string& selector, const string& input){
-	int index = FindNodeSelector(selector);
-	if (index >= 0) Properties[index] = input;
-	else printError("nodewrite", selector);
-};
-
-// Multiply stored values by 'value'
-void Node::Multiply(const string& selector, const double value) {
-	int index = FindNodeSelector(selector);
+	int index = NodeSchema.Find(selector);
 	if (index >= 0) {
-		double actual = GetDouble(selector);
-		if (actual != 0) {
-			Set(selector, ToString<double>(actual * value));
-		}
+		if (NodeSchema.isNumeric(index))
+			Values[NodeSchema.Slot(index)] = Str2Num(input);
+		else
+			Codes[NodeSchema.Slot(index)] = input;
 	} else printError("nodewrite", selector);
 };
 
 // Get what time the node belongs to (i.e., year)
 int Node::Time() const {
-	return Str2Step(Get("Step"))[0];
+	return Str2Step(Codes[NSlot.Step])[0];
 }
 
 
-// ****** MPS output functions ******
-string Node::NodeNames() const {
-	string temp_output = "";
-	// Create constraint for ach node with a valid demand
-	if ((Get("Demand") != "X") && (Get("Code")[0] != 'X')) {
-		temp_output += " E " + Get("Code") + "\n";
+// ****** Boolean functions ******
+// Is Node a DC node and are we considering DC flow in the model?
+bool Node::isDCflow() const {
+	return (Get(NSlot.ShortCode).substr(0,2) == DCCode) && useDCflow;
+}
+
+// Is this the first node in a year?
+bool Node::isFirstinYear() const {
+	bool output = true;
+	Step tempstep = Str2Step(Get(NSlot.Step));
+	for (unsigned int k = 1; k < SName.size(); k++)
+		output = output && ((tempstep[k]==0) || (tempstep[k]==1));
+	
+	return output;
+}
+
 
-		if (Get("ShortCode").substr(0,2)=="EC")
-			temp_output += " L co" + Get("Code") + "\n"; // Mar 04 2014 co-fire
+// Contructor for the NodeRow class
+NodeRow::NodeRow(const NodeTable& mytable, const int myrow) :
+	table(&mytable),
+	row(myrow) {}
+
+// Read a string code
+const string& NodeRow::Get(const int slot) const {
+	return table->pool[table->codes[slot][row]];
+}
 
+// Read a numeric value as stored (NaN if it's missing)
+double NodeRow::GetValue(const int slot) const {
+	return table->values[slot][row];
+}
+
+// Read a numeric value (zero if it's missing)
+double NodeRow::GetDouble(const int slot) const {
+	double value = table->values[slot][row];
+	return (value == value) ? value : 0;
+}
+
+// Read a numeric value in string format
+string NodeRow::GetText(const int slot) const {
+	return Num2Str(table->values[slot][row]);
+}
+
+// Is the numeric value given? (i.e., not 'X')
+bool NodeRow::Has(const int slot) const {
+	double value = table->values[slot][row];
+	return value == value;
+}
+
+// Read a node property in string format
+string NodeRow::Get(const string& selector) const {
+	string temp_output;
+	int index = NodeSchema.Find(selector);
+	if (index >= 0) {
+		if (NodeSchema.isNumeric(index))
+			temp_output = GetText(NodeSchema.Slot(index));
+		else
+			temp_output = Get(NodeSchema.Slot(index));
 	} else {
-		temp_output += " N " + Get("Code") + "\n";
+		temp_output = "ERROR";
+		printError("noderead", selector);
 	}
 	return temp_output;
 }
 
-string Node::NodeUDColumns() const {
-	string temp_output = "";
+// Get what time the node belongs to (i.e., year)
+int NodeRow::Time() const {
+	return table->year[row];
+}
+
+
+// ****** Model output functions ******
+void NodeRow::NodeNames(ModelBuilder& model) const {
+	// Create constraint for ach node with a valid demand
+	if (Has(NSlot.Demand) && (Get(NSlot.Code)[0] != 'X')) {
+		model.AddRow(Time(), 'E', Get(NSlot.Code));
+		model.KeepRow(Time(), Get(NSlot.Code)); // Nodal duals
+
+		if (Get(NSlot.ShortCode).substr(0,2)=="EC")
+			model.AddRow(Time(), 'L', "co" + Get(NSlot.Code)); // Mar 04 2014 co-fire
+
+	} else {
+		model.AddRow(Time(), 'N', Get(NSlot.Code));
+	}
+}
+
+void NodeRow::NodeUDColumns(ModelBuilder& model) const {
 	// If unserved demand is allowed, write the appropriate cost
-	if (Get("CostUD") != "X") {
-		temp_output += "    UD_" + Get("Code") + " obj " + Get("CostUD") + "\n";
+	if (Has(NSlot.CostUD)) {
+		int col = model.ColumnId("UD_" + Get(NSlot.Code));
+		model.AddEntry(Time(), col, "obj", GetValue(NSlot.CostUD));
 		if (Time()<=Sobjeval)
-			temp_output += "    UD_" + Get("Code") + " HTobj " + Get("CostUD") + "\n";
+			model.AddEntry(Time(), col, "HTobj", GetValue(NSlot.CostUD));
 
-		temp_output += "    UD_" + Get("Code") + " " + Get("Code") + " 1\n";
+		model.AddEntry(Time(), col, Get(NSlot.Code), 1);
 	}
-	return temp_output;
 }
 
-string Node::NodePeakRows() const {
-	string temp_output = "";
+void NodeRow::NodePeakRows(ModelBuilder& model) const {
 	// If peak demand is available, write the appropriate row
-	if ((Get("PeakPower") != "X") && isFirstinYear()) {
-		temp_output += " E pk" + Get("Code") + "\n";
+	if (Has(NSlot.PeakPower) && isFirstinYear()) {
+		model.AddRow(0, 'E', "pk" + Get(NSlot.Code));
 	}
-	return temp_output;
 }
 
-string Node::NodeRMColumns() const {
-	string temp_output = "";
+void NodeRow::NodeRMColumns(ModelBuilder& model) const {
 	// If peak demand is available, write reserve margin variable
-	if ((Get("PeakPower") != "X") && isFirstinYear()) {
-		temp_output += "    RM_" + Get("Code") + " pk" + Get("Code") + " -" + Get("PeakPower") + "\n";
+	if (Has(NSlot.PeakPower) && isFirstinYear()) {
+		model.AddEntry(0, model.ColumnId("RM_" + Get(NSlot.Code)), "pk" + Get(NSlot.Code), -GetValue(NSlot.PeakPower));
 	}
-	return temp_output;
 }
 
-string Node::NodeRMBounds() const {
-	string temp_output = "";
+void NodeRow::NodeRMBounds(ModelBuilder& model) const {
 	// If peak demand is available, write lower bound for reserve margin
-	if ((Get("PeakPower") != "X") && isFirstinYear()) {
-		temp_output += " LO bnd RM_" + Get("Code") + " 1\n";
+	if (Has(NSlot.PeakPower) && isFirstinYear()) {
+		model.AddBound(0, 'L', model.ColumnId("RM_" + Get(NSlot.Code)), 1);
 	}
-	return temp_output;
 }
 
-string Node::NodeRhs() const {
-	string temp_output = "";
+void NodeRow::NodeRhs(ModelBuilder& model) const {
 	// Demand RHS if it's valid
-	if ((Get("Demand") != "X") && (Get("Demand") != "0")) {
-		temp_output = " rhs " + Get("Code") + " " + Get("Demand") + "\n";
+	if (Has(NSlot.Demand) && (GetValue(NSlot.Demand) != 0)) {
+		model.AddRhs(Time(), Get(NSlot.Code), GetValue(NSlot.Demand));
 	}
-	return temp_output;
 }
 
-string Node::DCNodesBounds() const {
-	string temp_output = "";
+void NodeRow::DCNodesBounds(ModelBuilder& model) const {
 	// Write minimum and max for DC Power flow anges (-pi and pi)
-	temp_output += " LO bnd th" + Get("Code") + " -3.14\n";
-	temp_output += " UP bnd th" + Get("Code") + " 3.14\n";
-	return temp_output;
+	int col = model.ColumnId("th" + Get(NSlot.Code));
+	model.AddBound(Time(), 'L', col, -3.14);
+	model.AddBound(Time(), 'U', col, 3.14);
 }
 
-// ****** Boolean functions ******
-// Is Node a DC node and are we considering DC flow in the model?
-bool Node::isDCflow() const {
-	return (Get("ShortCode").substr(0,2) == DCCode) && useDCflow;
+// ****** Boolean functions (evaluated when the node was stored) ******
+bool NodeRow::isDCflow() const {
+	return (table->flags[row] & NF_DCFLOW) != 0;
 }
 
-// Is this the first node in a year?
-bool Node::isFirstinYear() const {
-	bool output = true;
-	Step tempstep = Str2Step(Get("Step"));
-	for (unsigned int k = 1; k < SName.size(); k++)
-		output = output && ((tempstep[k]==0) || (tempstep[k]==1));
-	
-	return output;
-}
-
-// ****** Other functions ******
-// Find the index for a node property selector
-int FindNodeSelector(const string& selector) {
-	int index = -1;
-	for (unsigned int k = 0; k < NodeProp.size(); ++k) {
-		if (selector == NodeProp[k]) index = k;
-	}
-	return index;
+bool NodeRow::isFirstinYear() const {
+	return (table->flags[row] & NF_FIRSTINYEAR) != 0;
 }
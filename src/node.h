@@ -8,6 +8,15 @@
 #ifndef _NODE_H_
 #define _NODE_H_
 
+// Storage slots for node properties (resolved by ReadParameters)
+struct NodeSlots {
+	// String codes
+	int Code, ShortCode, Step;
+	// Numeric values
+	int StepLength, Demand, DemandPower, DemandRate, PeakPower, PeakPowerRate, CostUD, DiscountRate, InflationRate;
+};
+extern NodeSlots NSlot;
+
 // Declare class type to hold node information
 class Node {
 	public:
@@ -16,29 +25,63 @@ class Node {
 		~Node();
 		Node& operator=(const Node& rhs);
 		
+		// Access by slot (string codes and numeric values)
+		const string& Get(const int slot) const;
+		double GetValue(const int slot) const;
+		double GetDouble(const int slot) const;
+		string GetText(const int slot) const;
+		bool Has(const int slot) const;
+		void Set(const int slot, const string& input);
+		void SetDouble(const int slot, const double input);
+		void Multiply(const int slot, const double value);
+		
+		// Access by property name (slower, used when reading data)
 		string Get(const string& selector) const;
-		double GetDouble(const string& selector) const;
-		vector<string> GetVecStr() const;
 		void Set(const string& selector, const string& input);
-		void Multiply(const string& selector, const double value);
 		int Time() const;
 		
-		string NodeNames() const;
-		string NodeUDColumns() const;
-		string NodePeakRows() const;
-		string NodeRMColumns() const;
-		string NodeRMBounds() const;
-		string NodeRhs() const;
-		string DCNodesBounds() const;
-		
 		bool isDCflow() const;
 		bool isFirstinYear() const;
 		
 	private:
-		vector<string> Properties;
+		vector<string> Codes;
+		vector<double> Values;
 };
 
-// Find the index for a node property selector
-int FindNodeSelector(const string& selector);
+class NodeTable;
+class ModelBuilder;
+
+// Declare class type to read a node stored in a 'NodeTable' (used to build the model)
+class NodeRow {
+	public:
+		NodeRow(const NodeTable& table, const int row);
+		
+		// Access by slot (string codes and numeric values)
+		const string& Get(const int slot) const;
+		double GetValue(const int slot) const;
+		double GetDouble(const int slot) const;
+		string GetText(const int slot) const;
+		bool Has(const int slot) const;
+		
+		// Access by property name
+		string Get(const string& selector) const;
+		int Time() const;
+		
+		// Add the rows, columns, right-hand sides and bounds of the node to the model
+		void NodeNames(ModelBuilder& model) const;
+		void NodeUDColumns(ModelBuilder& model) const;
+		void NodePeakRows(ModelBuilder& model) const;
+		void NodeRMColumns(ModelBuilder& model) const;
+		void NodeRMBounds(ModelBuilder& model) const;
+		void NodeRhs(ModelBuilder& model) const;
+		void DCNodesBounds(ModelBuilder& model) const;
+		
+		bool isDCflow() const;
+		bool isFirstinYear() const;
+		
+	private:
+		const NodeTable* table;
+		int row;
+};
 
 #endif  // _NODE_H_
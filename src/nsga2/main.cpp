@@ -82,6 +82,8 @@ int main (int argc, char **argv) {
 	}
 	
 	cout << endl << "- Generations finished, now reporting solutions" << endl;
+	if (useBenders && (netplan.BendersSolves > 0))
+		cout << "- Benders iterations per individual: " << (double) netplan.BendersIterations / netplan.BendersSolves << endl;
 	nsga2->fileio->report_pop(nsga2->parent_pop, nsga2->fileio->fpt2);
 	nsga2->fileio->report_feasible(nsga2->parent_pop, nsga2->fileio->fpt3);
 	if (nsga2->nreal!=0) {
@@ -0,0 +1,1218 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    pipeline.cpp -- Implementation of the preprocessor stages
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+using namespace std;
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "global.h"
+#include "node.h"
+#include "arc.h"
+#include "network.h"
+#include "model.h"
+#include "index.h"
+#include "cache.h"
+#include "read.h"
+#include "write.h"
+#include "factor.h"
+#include "curve.h"
+#include "pipeline.h"
+
+// Nodes, arcs and indices obtained by expanding a block of the lists. For the
+// incremental preprocessing, the sizes of the tables after each list entity
+// (PREP_TABLES numbers per entity) and the rows of the properties files it
+// used are kept too. Properties files are numbered in the order they are
+// read: node properties, arcs_TransEnergy.csv and arc properties.
+struct PrepBlock {
+	ExpandedNetwork Net;
+	Index IdxNode, IdxUd, IdxRm, IdxDc, IdxArc, IdxInv, IdxNsga, IdxUb, IdxCap;
+	vector<int> Ends, UseEnds;
+	vector< pair<int, int> > Uses;
+};
+
+// Indices of a block and global indices, in the order of 'PREP_TABLES'
+void BlockIndices(PrepBlock& Block, Index* Idx[]) {
+	Index* output[PREP_TABLES-2] = { &Block.IdxNode, &Block.IdxUd, &Block.IdxRm, &Block.IdxDc, &Block.IdxArc,
+		&Block.IdxInv, &Block.IdxNsga, &Block.IdxUb, &Block.IdxCap };
+	for (int t = 0; t < PREP_TABLES-2; ++t) Idx[t] = output[t];
+}
+
+void GlobalIndices(Index* Idx[]) {
+	Index* output[PREP_TABLES-2] = { &IdxNode, &IdxUd, &IdxRm, &IdxDc, &IdxArc, &IdxInv, &IdxNsga, &IdxUb, &IdxCap };
+	for (int t = 0; t < PREP_TABLES-2; ++t) Idx[t] = output[t];
+}
+
+// Number of rows in each table
+void TableSizes(const ExpandedNetwork& Net, Index* Idx[], int sizes[]) {
+	sizes[0] = Net.nodes.size();
+	sizes[1] = Net.arcs.size();
+	for (int t = 0; t < PREP_TABLES-2; ++t) sizes[t+2] = Idx[t]->size;
+}
+
+// Record the end of the list entity that was just expanded in a block
+void MarkEntity(PrepBlock& Block) {
+	Index* Idx[PREP_TABLES-2];
+	int sizes[PREP_TABLES];
+	BlockIndices(Block, Idx);
+	TableSizes(Block.Net, Idx, sizes);
+	Block.Ends.insert(Block.Ends.end(), sizes, sizes + PREP_TABLES);
+	Block.UseEnds.push_back(Block.Uses.size());
+}
+
+// Expand node 'k' of the list through all the steps
+void ExpandNode(const PrepInput& In, Node& ListNode, const int k, FactorTable& Factors, PrepBlock& Out) {
+	vector<int> NVectorIndex(In.NVectorMatch.size(), -1);
+	
+	int StepIndex = FindCode(ListNode, In.NStepMatch);
+	
+	// Identify the row containing data for each property
+	for (unsigned int t=0; t < NVectorIndex.size(); ++t) {
+		NVectorIndex[t] = FindCode(ListNode, In.NVectorMatch[t]);
+		if (NVectorIndex[t] >= 0) Out.Uses.push_back(make_pair(t, NVectorIndex[t]));
+	}
+	
+	// Copy step information
+	if (StepIndex >= 0) ListNode.Set(NSlot.Step, In.NStep[StepIndex][1]);
+	
+	if (ListNode.Get(NSlot.Step) == "") {
+		printError("nodestep", ListNode.Get(NSlot.ShortCode));
+	} else {
+		// Use a temporary node to store information and cycle through steps
+		Step TempStep(SName.size(), 0);
+		for (unsigned int l = 0; l < ListNode.Get(NSlot.Step).size(); l++) TempStep[l] = 1;
+		
+		while (TempStep <= SLength) {
+			// Apply information
+			Node TempNode = ListNode;
+			TempNode.Set(NSlot.Step, Step2Str(TempStep));
+			TempNode.SetDouble(NSlot.StepLength, Str2Num(Step2Hours(TempStep)));
+			int l = Step2Pos(TempStep) + 1;
+			TempNode.Set(NSlot.Code, TempNode.Get(NSlot.ShortCode) + Step2Str(TempStep));
+			
+			for (unsigned int t=0; t < NVectorIndex.size(); ++t) {
+				int tmp_index = NVectorIndex[t];
+				if (tmp_index < 0) continue;
+				int slot = NodeSchema.Slot(NodePropOffset + t);
+				if (NodeSchema.isNumeric(NodePropOffset + t))
+					TempNode.SetDouble(slot, In.NVectorNum[t][tmp_index][l]);
+				else
+					TempNode.Set(slot, In.NVectorProp[t][tmp_index][l]);
+			}
+			
+			// Calculate demand if power demand is given
+			if ((TempNode.GetValue(NSlot.Demand) == 0) && TempNode.Has(NSlot.DemandPower)) {
+				double step_length = TempNode.GetDouble(NSlot.StepLength);
+				TempNode.Multiply(NSlot.DemandPower, step_length);
+				TempNode.SetDouble(NSlot.Demand, TempNode.GetValue(NSlot.DemandPower));
+			}
+			
+			// Adjust peak demand with increase rate
+			double dem_rate = TempNode.GetDouble(NSlot.DemandRate);
+			double peak_rate = TempNode.GetDouble(NSlot.PeakPowerRate);
+			if ((dem_rate != 0) || (peak_rate != 0)) {
+				TempNode.Multiply(NSlot.Demand, Factors.Growth(dem_rate)[TempStep[0]]);
+				TempNode.Multiply(NSlot.PeakPower, Factors.Growth(peak_rate)[TempStep[0]]);
+			}
+
+			// Store node for later use
+			Out.Net.Add(TempNode);
+			if (TempNode.isDCflow()) {
+				Out.IdxDc.Add(k, TempStep, TempNode.Get(NSlot.ShortCode));
+			}
+			
+			// Record indices to recover information
+			Out.IdxNode.Add(k, TempStep, TempNode.Get(NSlot.ShortCode));
+			if (TempNode.Has(NSlot.CostUD)) {
+				Out.IdxUd.Add(k, TempStep, TempNode.Get(NSlot.ShortCode));
+			}
+			if ((TempNode.Has(NSlot.PeakPower)) && TempNode.isFirstinYear()) {
+				Step temp2(SName.size(), 0);
+				temp2[0] = TempStep[0];
+				Out.IdxRm.Add(k, temp2, TempNode.Get(NSlot.ShortCode));
+			}
+			
+			// Move to the next step
+			TempStep = NextStep(TempStep);
+		}
+	}
+}
+
+// Expand arc 'k' of the list through all the steps
+void ExpandArc(const PrepInput& In, Arc& ListArc, const int k, FactorTable& Factors, PrepBlock& Out) {
+	vector<int> AVectorIndex(In.AVectorMatch.size(), -1);
+	
+	// Identify the row containing data for each property
+	int StepFromIndex = In.NStepMatch.Find(ListArc.Get(ASlot.From));
+	int StepToIndex = In.NStepMatch.Find(ListArc.Get(ASlot.To));
+	int TransEnergyIndex = In.ATransEnergyMatch.Find(ListArc.Get(ASlot.From));
+	int CurveIndex = FindCode(ListArc, In.CostCurves.matcher);
+	vector<double> CurveWidth(0), CurveCost(0);
+	for (unsigned int t=0; t < AVectorIndex.size(); ++t) {
+		AVectorIndex[t] = FindCode(ListArc, In.AVectorMatch[t]);
+		if (AVectorIndex[t] >= 0) Out.Uses.push_back(make_pair(In.NVectorMatch.size() + 1 + t, AVectorIndex[t]));
+	}
+	for (int r = TransEnergyIndex; (r >= 0) && (r < In.ATransEnergy.size()); ++r) {
+		if ((r > TransEnergyIndex) && (ListArc.Get(ASlot.From) != In.ATransEnergy[r][0])) break;
+		Out.Uses.push_back(make_pair(In.NVectorMatch.size(), r));
+	}
+	
+	// Recover step information
+	if (StepFromIndex >= 0) ListArc.Set(ASlot.FromStep, In.NStep[StepFromIndex][1]);
+	if (StepToIndex >= 0) ListArc.Set(ASlot.ToStep, In.NStep[StepToIndex][1]);
+	
+	// Check for a storage arc
+	bool isStorage = ListArc.isStorage();
+	
+	if ((ListArc.Get(ASlot.FromStep) == "") && (ListArc.Get(ASlot.ToStep) == "")) {
+		printError("arcstep", ListArc.Get(ASlot.From) + "_" + ListArc.Get(ASlot.To));
+	} else {
+		// Cycle through steps (more complicated here) to expand arcs
+		string TempArcStepCode = max(ListArc.Get(ASlot.FromStep), ListArc.Get(ASlot.ToStep));
+		
+		Step TempStep(SName.size()), TempFromStep(SName.size(), 0), TempToStep(SName.size(), 0);
+		Step NextFromStep(SName.size()), NextToStep(SName.size());
+		
+		for (unsigned int l = 0; l < ListArc.Get(ASlot.FromStep).size(); l++) TempFromStep[l] = 1;
+		for (unsigned int l = ListArc.Get(ASlot.FromStep).size(); l < SName.size(); l++) TempFromStep[l] = 0;
+		
+		if (isStorage) {
+			TempToStep = NextStep(TempFromStep);
+		} else {
+			for (unsigned int l = 0; l < ListArc.Get(ASlot.ToStep).size(); l++) TempToStep[l] = 1;
+			for (unsigned int l = ListArc.Get(ASlot.ToStep).size(); l < SName.size(); l++) TempToStep[l] = 0;
+		}
+		
+		NextFromStep = (TempFromStep[0] == 1) ? NextStep(TempFromStep) : NextStep(SLength);
+		NextToStep = (TempToStep[0] == 1) ? NextStep(TempToStep) : NextStep(SLength);
+		
+		TempStep = ((TempFromStep < TempToStep) && !isStorage) ? TempToStep : TempFromStep;
+		
+		// Find the shortest step, to assign it as a default for 'InvStep'
+		string TempStepStr = (TempFromStep < TempToStep) ? ListArc.Get(ASlot.ToStep) : ListArc.Get(ASlot.FromStep);
+		
+		while ((TempStep <= SLength) && (TempToStep <= SLength)) {
+			// Apply information
+			Arc TempArc = ListArc;
+			int l = Step2Pos(TempStep) + 2;
+			TempArc.Set(ASlot.FromStep, Step2Str(TempFromStep));
+			TempArc.Set(ASlot.ToStep, Step2Str(TempToStep));
+			TempArc.SetDouble(ASlot.StepLength, Str2Num(Step2Hours(TempStep)));
+			
+			if (TempArc.isTransport() && (TempArc.Get(ASlot.TransInfr) == ""))
+				TempArc.Set(ASlot.Code, TempArc.Get(ASlot.From) + Step2Str(TempFromStep));
+			else
+				TempArc.Set(ASlot.Code, TempArc.Get(ASlot.From) + Step2Str(TempFromStep) + "_" + TempArc.Get(ASlot.To) + Step2Str(TempToStep));
+			
+			for (unsigned int t=0; t < AVectorIndex.size(); ++t) {
+				int tmp_index = AVectorIndex[t];
+				if (tmp_index < 0) continue;
+				int slot = ArcSchema.Slot(ArcPropOffset + t);
+				if (ArcSchema.isNumeric(ArcPropOffset + t))
+					TempArc.SetDouble(slot, In.AVectorNum[t][tmp_index][l]);
+				else
+					TempArc.Set(slot, In.AVectorProp[t][tmp_index][l]);
+			}
+			
+			// Segments of the cost curve in this step
+			if (CurveIndex >= 0) {
+				In.CostCurves.Segments(CurveIndex, Step2Pos(TempStep), CurveWidth, CurveCost);
+				TempArc.SetCostCurve(CurveWidth, CurveCost);
+			}
+			
+			// Is there a load on the an energy node? The loads are the same for
+			// all the arcs from the same node in the same step, so they are
+			// only stored once (a coupling, multiplied by the distance later)
+			if (TransEnergyIndex >= 0) {
+				long long key = ((long long) TransEnergyIndex * (STEP_LEVELS + 1) + TempArcStepCode.size()) * (Step2Pos(SLength) + 1) + Step2Pos(TempStep);
+				int coupling = Out.Net.arcs.FindCoupling(key);
+				if (coupling < 0) {
+					vector<string> LoadNodes(0);
+					vector<double> LoadValues(0);
+					for (int IndexTemp = TransEnergyIndex; IndexTemp < In.ATransEnergy.size(); ++IndexTemp) {
+						if (ListArc.Get(ASlot.From) != In.ATransEnergy[IndexTemp][0]) break;
+						
+						// Read code and step for energy node
+						string LoadCode = In.ATransEnergy[IndexTemp][1];
+						int LoadIndex = In.NStepMatch.Find(LoadCode);
+						string LoadStepCode = DefStep;
+						if (LoadIndex >= 0) LoadStepCode = In.NStep[LoadIndex][1];
+						
+						if (LoadStepCode.size() <= TempArcStepCode.size()) {
+							Step LoadStep = TempStep;
+							for (unsigned int m = LoadStepCode.size(); m < LoadStep.size(); m++) LoadStep[m] = 0;
+							LoadNodes.push_back(LoadCode + Step2Str(LoadStep));
+							LoadValues.push_back(In.ATransEnergyNum[IndexTemp][Step2Pos(LoadStep) + 2]);
+						} else {
+							Step NextTempStep = NextStep(TempStep);
+							Step LoadStep = TempStep;
+							for (unsigned int m = TempArcStepCode.size(); m < LoadStepCode.size(); m++) LoadStep[m] = 1;
+							while (LoadStep < NextTempStep) {
+								LoadNodes.push_back(LoadCode + Step2Str(LoadStep));
+								LoadValues.push_back(In.ATransEnergyNum[IndexTemp][Step2Pos(LoadStep) + 2]);
+								LoadStep = NextStep(LoadStep);
+							}
+						}
+					}
+					coupling = Out.Net.arcs.AddCoupling(key, LoadNodes, LoadValues);
+				}
+				TempArc.SetTrans2Energy(coupling);
+			}
+			
+			// From Investment cost, retirement cost, Fixed O&M, discount rate, lifetime  ==> Overnight cost
+			// Feature is planned but not implemented yet
+			
+			// Apply discount and inflation rate to investment and operational costs
+			double dollar_factor = Factors.Dollar(TempArc.GetDouble(ASlot.InflationRate), TempArc.GetDouble(ASlot.DiscountRate))[TempStep[0]];
+			
+			// If distance is available adjust costs, emissions, demand for energy...
+			if (TempArc.Has(ASlot.Distance)) {
+				double distance = TempArc.GetDouble(ASlot.Distance);
+				dollar_factor = dollar_factor * distance;
+				
+				for (int j = 0; j < SustMet.size(); ++j)
+					TempArc.Multiply(ASlot.Sust[j], distance);
+				TempArc.Multiply("Trans2Energy", distance);
+			}
+			
+			if (dollar_factor != 1) {
+				TempArc.Multiply(ASlot.OpCost, dollar_factor);
+			}
+			
+			
+				// Need to adjust for investment costs at the end of the simulation period- salvage value
+				const double* salvage = Factors.Salvage(TempArc.Get(ASlot.LifeSpan));
+				if (salvage != NULL) dollar_factor = dollar_factor * salvage[TempStep[0]];
+			
+			
+			
+			// Store modified investment costs
+			if (dollar_factor != 1) {
+				if ((TempArc.Has(ASlot.Distance)) && (Str2Step(TempArc.Get(ASlot.LifeSpan))[0] < 55)){ // NEW! July 03 2012 - Except for HSR infra, which needs to be multiplied by Distance
+					double distance = TempArc.GetDouble(ASlot.Distance);
+					dollar_factor = dollar_factor / distance; // changed transportation cost Dec 07 2011 - in $, not $/mile
+				}
+
+					TempArc.Multiply(ASlot.InvCost, dollar_factor);
+			}
+
+			
+					
+							
+			// Store Arc for later use
+			Out.Net.Add(TempArc);
+			
+			// Store Arc indices to recover solution information
+			if (!TempArc.isTransport() || TempArc.Get(ASlot.TransInfr) != "") {
+				Out.IdxArc.Add(k, TempStep, TempArc.Get(ASlot.From) + "_" + TempArc.Get(ASlot.To));
+			}
+			if (TempArc.InvArc()  && TempArc.Get(ASlot.TransInfr) == "") {
+				Step YearStep(SName.size(), 0);
+				YearStep[0] = TempStep[0];
+				Out.IdxInv.Add(k, YearStep, TempArc.Get(ASlot.From) + "_" + TempArc.Get(ASlot.To));
+				if (!isinf(TempArc.GetValue(ASlot.InvMax)))
+					Out.IdxNsga.Add(k, YearStep, TempArc.Get(ASlot.From) + "_" + TempArc.Get(ASlot.To));
+			}
+			if (!isinf(TempArc.GetValue(ASlot.OpMax))  && TempArc.Get(ASlot.TransInfr) == "") {
+				Out.IdxUb.Add(k, TempStep, TempArc.Get(ASlot.From) + "_" + TempArc.Get(ASlot.To));
+				if (TempArc.isFirstinYear()) {
+					Step temp2(SName.size(), 0);
+					temp2[0] = TempStep[0];
+					Out.IdxCap.Add(k, temp2, TempArc.Get(ASlot.From) + "_" + TempArc.Get(ASlot.To));
+				}
+			}
+			
+			// Move to next time step
+			TempStep = NextStep(TempStep);
+			if (NextFromStep <= TempStep) {
+				TempFromStep = NextFromStep;
+				NextFromStep = NextStep(NextFromStep);
+			}
+			
+			if (isStorage) {
+				TempToStep = NextToStep;
+				NextToStep = NextStep(NextToStep);
+				// This part of the code eliminates storage connection between different years (interferes with Benders decomposition)
+				// Must have a negative demand on the storage node for the first step in the year and a positive for the last
+				if (TempFromStep[0] != TempToStep[0]) {
+					TempStep = NextStep(TempStep);
+					TempFromStep = NextFromStep;
+					TempToStep = NextToStep;
+					NextFromStep = NextStep(NextFromStep);
+					NextToStep = NextStep(NextToStep);
+				}
+			} else if (NextToStep <= TempStep) {
+				TempToStep = NextToStep;
+				NextToStep = NextStep(NextToStep);
+			}
+		}
+	}
+}
+
+// Work shared by the expansion threads. The lists are split in blocks that
+// the threads take in order; a block is merged into the network as soon as
+// all the previous ones are, so the result does not depend on the number of
+// threads and only a few blocks are kept in memory at once.
+struct PrepJob {
+	const PrepInput* In;
+	ExpandedNetwork* Net;
+	PrepCache* Cache;
+	vector<PrepBlock>* Blocks;
+	vector<bool> ready;
+	bool arcs;
+	int size, blocksize, next, done, merged;
+	pthread_mutex_t lock;
+};
+
+// Copy a block at the end of the network and indices, and release it. The
+// ends and property rows of its list entities are kept in the cache, if any.
+void MergeBlock(PrepBlock& Block, ExpandedNetwork& Net, PrepCache* Cache) {
+	if (Cache != NULL) {
+		Index* Idx[PREP_TABLES-2];
+		int sizes[PREP_TABLES];
+		GlobalIndices(Idx);
+		TableSizes(Net, Idx, sizes);
+		for (unsigned int e = 0; e < Block.UseEnds.size(); ++e) {
+			for (int t = 0; t < PREP_TABLES; ++t)
+				Cache->ends.push_back(sizes[t] + Block.Ends[e * PREP_TABLES + t]);
+			for (int u = (e > 0) ? Block.UseEnds[e-1] : 0; u < Block.UseEnds[e]; ++u) {
+				Cache->usefile.push_back(Block.Uses[u].first);
+				Cache->userow.push_back(Block.Uses[u].second);
+			}
+			Cache->usestart.push_back(Cache->usefile.size());
+		}
+	}
+	Net.Append(Block.Net);
+	IdxNode.Append(Block.IdxNode);
+	IdxUd.Append(Block.IdxUd);
+	IdxRm.Append(Block.IdxRm);
+	IdxDc.Append(Block.IdxDc);
+	IdxArc.Append(Block.IdxArc);
+	IdxInv.Append(Block.IdxInv);
+	IdxNsga.Append(Block.IdxNsga);
+	IdxUb.Append(Block.IdxUb);
+	IdxCap.Append(Block.IdxCap);
+	Block = PrepBlock();
+}
+
+void* ExpandBlocks(void* arg) {
+	PrepJob* job = (PrepJob*) arg;
+	FactorTable Factors;
+	for (;;) {
+		pthread_mutex_lock(&job->lock);
+		int b = job->next++;
+		pthread_mutex_unlock(&job->lock);
+		if (b >= job->Blocks->size()) break;
+		
+		int begin = b * job->blocksize;
+		int end = min(begin + job->blocksize, job->size);
+		for (int k = begin; k < end; ++k) {
+			if (job->arcs)
+				ExpandArc(*job->In, (*job->In->ListArcs)[k], k, Factors, (*job->Blocks)[b]);
+			else
+				ExpandNode(*job->In, (*job->In->ListNodes)[k], k, Factors, (*job->Blocks)[b]);
+			if (job->Cache != NULL) MarkEntity((*job->Blocks)[b]);
+		}
+		
+		// Merge the blocks that are complete in list order and print progress
+		pthread_mutex_lock(&job->lock);
+		job->ready[b] = true;
+		while ((job->merged < job->Blocks->size()) && job->ready[job->merged])
+			MergeBlock((*job->Blocks)[job->merged++], *job->Net, job->Cache);
+		job->done += end - begin;
+		cout << "\r- Expanding " << (job->arcs ? "arcs" : "nodes") << "... " << job->done << " / " << job->size << flush;
+		pthread_mutex_unlock(&job->lock);
+	}
+	return NULL;
+}
+
+// Expand the list of nodes or arcs with 'PrepThreads' threads (what each
+// entity produced and used is kept in 'Cache', if any)
+void ExpandList(const PrepInput& In, const bool arcs, ExpandedNetwork& Net, PrepCache* Cache) {
+	PrepJob job;
+	int nthreads = (PrepThreads > 1) ? PrepThreads : 1;
+	job.In = &In;
+	job.Net = &Net;
+	job.Cache = Cache;
+	job.arcs = arcs;
+	job.size = arcs ? In.ListArcs->size() : In.ListNodes->size();
+	job.blocksize = job.size / (8 * nthreads) + 1;
+	job.next = 0;
+	job.done = 0;
+	job.merged = 0;
+	pthread_mutex_init(&job.lock, NULL);
+	
+	vector<PrepBlock> Blocks((job.size + job.blocksize - 1) / job.blocksize);
+	job.Blocks = &Blocks;
+	job.ready.assign(Blocks.size(), false);
+	if (nthreads > 1) {
+		vector<pthread_t> threads(nthreads);
+		for (int i = 0; i < nthreads; ++i)
+			pthread_create(&threads[i], NULL, ExpandBlocks, &job);
+		for (int i = 0; i < nthreads; ++i)
+			pthread_join(threads[i], NULL);
+	} else {
+		ExpandBlocks(&job);
+	}
+	pthread_mutex_destroy(&job.lock);
+	cout << endl;
+}
+
+// Expand again the list entities (nodes first, then arcs) whose property
+// rows changed since the previous run and overwrite their rows in the network
+// and indices loaded from the cache. False if any of them now takes a
+// different number of rows, so the whole lists have to be expanded.
+bool PatchNetwork(const PrepInput& In, const PrepCache& Cache, const vector<int>& entities, ExpandedNetwork& Net) {
+	Index* Idx[PREP_TABLES-2];
+	GlobalIndices(Idx);
+	int nnodes = In.ListNodes->size();
+	FactorTable Factors;
+	for (unsigned int i = 0; i < entities.size(); ++i) {
+		int e = entities[i];
+		PrepBlock Block;
+		if (e < nnodes)
+			ExpandNode(In, (*In.ListNodes)[e], e, Factors, Block);
+		else
+			ExpandArc(In, (*In.ListArcs)[e - nnodes], e - nnodes, Factors, Block);
+		
+		Index* BlockIdx[PREP_TABLES-2];
+		int first[PREP_TABLES], sizes[PREP_TABLES];
+		BlockIndices(Block, BlockIdx);
+		TableSizes(Block.Net, BlockIdx, sizes);
+		for (int t = 0; t < PREP_TABLES; ++t) {
+			first[t] = (e > 0) ? Cache.ends[(e-1) * PREP_TABLES + t] : 0;
+			if (Cache.ends[e * PREP_TABLES + t] - first[t] != sizes[t]) return false;
+		}
+		
+		Net.nodes.Replace(first[0], Block.Net.nodes);
+		if (!Net.arcs.Replace(first[1], Block.Net.arcs)) return false;
+		for (int t = 0; t < PREP_TABLES-2; ++t)
+			Idx[t]->Replace(first[t+2], *BlockIdx[t]);
+	}
+	Net.FindDC();
+	return true;
+}
+
+// Whether an output of the previous run can be kept: it has the same hash
+// and the file is still there
+bool KeepOutput(const PrepManifest& Previous, const string& file_name, const unsigned long long hash) {
+	map<string, unsigned long long>::const_iterator it = Previous.outputs.find(file_name);
+	return (it != Previous.outputs.end()) && (it->second == hash) && (access(file_name.c_str(), F_OK) == 0);
+}
+
+// Whether an output can be a hard link to the file of the base data set of
+// the scenarios with the same hash (if the link can't be made, it's written)
+static bool LinkOutput(const PrepData& Data, const string& file_name, const unsigned long long hash) {
+	if (Data.BaseFolder.empty()) return false;
+	map<string, unsigned long long>::const_iterator it = Data.BaseOutputs.outputs.find(file_name);
+	if ((it == Data.BaseOutputs.outputs.end()) || (it->second != hash)) return false;
+	remove(file_name.c_str());
+	return link((Data.BaseFolder + "/" + file_name).c_str(), file_name.c_str()) == 0;
+}
+
+// Contructor for the PrepData class
+PrepData::PrepData() :
+	incremental(false), changed(true), recordUses(false) {
+	In.ListNodes = &ListNodes;
+	In.ListArcs = &ListArcs;
+}
+
+string PrepData::File(const string& name) const {
+	map<string, string>::const_iterator it = files.find(name);
+	return (it == files.end()) ? name : it->second;
+}
+
+// Read the lists of nodes and arcs and all their properties
+void ReadInputs(PrepData& Data) {
+	vector<Node>& ListNodes = Data.ListNodes;
+	vector<Arc>& ListArcs = Data.ListArcs;
+	PrepInput& In = Data.In;
+	In.NVectorProp.resize(NodeSchema.size()-NodePropOffset);
+	In.NVectorNum.resize(NodeSchema.size()-NodePropOffset);
+	In.NVectorMatch.resize(NodeSchema.size()-NodePropOffset);
+	In.AVectorProp.resize(ArcSchema.size()-ArcPropOffset);
+	In.AVectorNum.resize(ArcSchema.size()-ArcPropOffset);
+	In.AVectorMatch.resize(ArcSchema.size()-ArcPropOffset);
+	
+	cout << "- Reading list of nodes...\n";
+	Profile.Start("node list");
+	ListNodes = ReadListNodes(Data.File("data/nodes_List.csv").c_str());
+	Profile.Stop(ListNodes.size());
+	cout << "- Reading node data...\n";
+	Profile.Start("node properties");
+	In.NStep = ReadStep(Data.File("data/nodes_Step.csv").c_str());
+	In.NStepMatch.Build(In.NStep, 1);
+	vector<PropertyFile> NodeFiles(0);
+	for (unsigned int t=NodePropOffset; t < NodeSchema.size(); ++t) {
+		PropertyFile file;
+		file.name = Data.File("data/nodes_" + NodeSchema.Name(t) + ".csv");
+		file.defvalue = NodeSchema.Default(t);
+		file.num_fields = 1;
+		file.text = &In.NVectorProp[t-NodePropOffset];
+		file.numbers = NodeSchema.isNumeric(t) ? &In.NVectorNum[t-NodePropOffset] : NULL;
+		file.matcher = &In.NVectorMatch[t-NodePropOffset];
+		NodeFiles.push_back(file);
+	}
+	ReadPropertyFiles(NodeFiles, PrepThreads);
+	Profile.Stop(NodeFiles.size());
+	
+	cout << "- Reading list of arcs...\n";
+	Profile.Start("arc list");
+	ListArcs = ReadListArcs(Data.File("data/arcs_List.csv").c_str());
+	Profile.Stop(ListArcs.size());
+	cout << "- Reading arc data...\n";
+	Profile.Start("arc properties");
+	vector<PropertyFile> ArcFiles(1);
+	ArcFiles[0].name = Data.File("data/arcs_TransEnergy.csv");
+	ArcFiles[0].defvalue = "X";
+	ArcFiles[0].num_fields = 2;
+	ArcFiles[0].text = &In.ATransEnergy;
+	ArcFiles[0].numbers = &In.ATransEnergyNum;
+	ArcFiles[0].matcher = &In.ATransEnergyMatch;
+	for (unsigned int t=ArcPropOffset; t < ArcSchema.size(); ++t) {
+		PropertyFile file;
+		if (t < ArcSchema.size() - Nevents) {
+			// Regular properties
+			file.name = Data.File("data/arcs_" + ArcSchema.Name(t) + ".csv");
+		} else {
+			// Resiliency properties
+			file.name = Data.File("data/events/" + ArcSchema.Name(t) + ".csv");
+		}
+		file.defvalue = ArcSchema.Default(t);
+		file.num_fields = 2;
+		file.text = &In.AVectorProp[t-ArcPropOffset];
+		file.numbers = ArcSchema.isNumeric(t) ? &In.AVectorNum[t-ArcPropOffset] : NULL;
+		file.matcher = &In.AVectorMatch[t-ArcPropOffset];
+		ArcFiles.push_back(file);
+	}
+	ReadPropertyFiles(ArcFiles, PrepThreads);
+	Profile.Stop(ArcFiles.size());
+	Data.PropFiles = NodeFiles;
+	Data.PropFiles.insert(Data.PropFiles.end(), ArcFiles.begin(), ArcFiles.end());
+	
+	cout << "- Reading cost curves...\n";
+	Profile.Start("cost curves");
+	string CurveFile = Data.File("data/arcs_CostCurve.csv");
+	if (!In.CostCurves.Read(CurveFile.c_str())) {
+		// Older format: one file for the breakpoints and one for the costs of each segment
+		vector<string> Breakpoints(0), Costs(0);
+		if (access(Data.File("data/arcs_OpMaxc1.csv").c_str(), F_OK) == 0) {
+			for (int j = 1; j <= segmnt; ++j) {
+				Breakpoints.push_back(Data.File("data/arcs_OpMaxc" + ToString<int>(j) + ".csv"));
+				Costs.push_back(Data.File("data/arcs_OpCostc" + ToString<int>(j) + ".csv"));
+			}
+		} else printError("warning", CurveFile.c_str());
+		In.CostCurves.ReadSegmentFiles(Breakpoints, Costs);
+	}
+	Profile.Stop(In.CostCurves.keys.size());
+	
+	cout << "- Creating transportation network...\n";
+	Profile.Start("trans network");
+	int NumArcs = ListArcs.size();
+	ReadTrans(ListNodes, ListArcs, Data.File("data/trans_List.csv").c_str());
+	Profile.Stop(ListArcs.size() - NumArcs);
+	
+	cout << "- Reading sustainability constraints...\n";
+	Profile.Start("sustainability limits");
+	Data.SustLimits = ReadProperties(Data.File("data/sust_Limits.csv").c_str(), "X", 1);
+	Profile.Stop(Data.SustLimits.size());
+}
+
+// Expand nodes and arcs through all the steps, and fill the indices. False
+// if incremental preprocessing finds that prepdata/ is up to date.
+bool ExpandNetwork(PrepData& Data) {
+	vector<Node>& ListNodes = Data.ListNodes;
+	vector<Arc>& ListArcs = Data.ListArcs;
+	const PrepInput& In = Data.In;
+	const vector<PropertyFile>& PropFiles = Data.PropFiles;
+	ExpandedNetwork& Net = Data.Net;
+	PrepManifest& Manifest = Data.Manifest;
+	PrepManifest& Previous = Data.Previous;
+	PrepCache& Cache = Data.Cache;
+	bool& incremental = Data.incremental;
+	bool& changed = Data.changed;
+	
+	// With incremental preprocessing, the inputs are compared with the ones of
+	// the previous run (prepdata/manifest.csv). If only properties files
+	// changed, and no codes in them, the network is loaded from the cache
+	// and only the nodes and arcs that use changed rows are expanded again.
+	Index* Idx[PREP_TABLES-2];
+	GlobalIndices(Idx);
+	bool expanded = false;
+	incremental = false;
+	changed = true;
+	if (useIncrementalPrep) {
+		cout << "- Checking changes since the previous run...\n";
+		Profile.Start("check changes");
+		const char* GlobalFiles[6] = { "prep", "data/parameters.csv", "data/nodes_List.csv",
+			"data/nodes_Step.csv", "data/arcs_List.csv", "data/trans_List.csv" };
+		Manifest.inputs["prep"] = HashFile("/proc/self/exe");
+		for (int f = 1; f < 6; ++f)
+			Manifest.inputs[GlobalFiles[f]] = HashFile(GlobalFiles[f]);
+		Manifest.inputs["data/sust_Limits.csv"] = HashFile("data/sust_Limits.csv");
+		const vector<string>& CurveFiles = In.CostCurves.files;
+		for (unsigned int f = 0; f < CurveFiles.size(); ++f)
+			Manifest.inputs[CurveFiles[f]] = HashFile(CurveFiles[f].c_str());
+		Cache.keys.resize(PropFiles.size());
+		Cache.rows.resize(PropFiles.size());
+		for (unsigned int f = 0; f < PropFiles.size(); ++f) {
+			Manifest.inputs[PropFiles[f].name] = HashFile(PropFiles[f].name.c_str());
+			HashProperties(*PropFiles[f].text, PropFiles[f].numbers, PropFiles[f].num_fields, Cache.keys[f], Cache.rows[f]);
+		}
+		
+		// The program, parameters, lists and set of files must be the same
+		incremental = Previous.Read("prepdata/manifest.csv") && (Previous.inputs.size() == Manifest.inputs.size());
+		for (map<string, unsigned long long>::const_iterator it = Manifest.inputs.begin(); incremental && (it != Manifest.inputs.end()); ++it)
+			incremental = (Previous.inputs.count(it->first) > 0);
+		for (int f = 0; incremental && (f < 6); ++f)
+			incremental = (Previous.inputs[GlobalFiles[f]] == Manifest.inputs[GlobalFiles[f]]);
+		for (unsigned int f = 0; incremental && (f < CurveFiles.size()); ++f)
+			incremental = (Previous.inputs[CurveFiles[f]] == Manifest.inputs[CurveFiles[f]]);
+		
+		if (incremental && (Previous.inputs == Manifest.inputs)) {
+			bool uptodate = true;
+			for (map<string, unsigned long long>::const_iterator it = Previous.outputs.begin(); it != Previous.outputs.end(); ++it)
+				uptodate = uptodate && (access(it->first.c_str(), F_OK) == 0);
+			if (uptodate) {
+				Profile.Stop();
+				return false;
+			}
+		}
+		
+		// The manifest is written again once all outputs are
+		remove("prepdata/manifest.csv");
+		
+		PrepCache Old;
+		int nentities = ListNodes.size() + ListArcs.size();
+		bool loaded = incremental && Old.Load("prepdata/prep_cache.bin", Net, Idx) && (Old.usestart.size() == nentities + 1)
+			&& (Old.ends.size() == nentities * PREP_TABLES) && (Old.keys == Cache.keys);
+		Profile.Stop();
+		if (loaded) {
+			// Nodes and arcs that use rows that changed
+			vector<int> entities;
+			for (int e = 0; e < nentities; ++e) {
+				for (int u = Old.usestart[e]; u < Old.usestart[e+1]; ++u) {
+					if (Old.rows[Old.usefile[u]][Old.userow[u]] != Cache.rows[Old.usefile[u]][Old.userow[u]]) {
+						entities.push_back(e);
+						break;
+					}
+				}
+			}
+			cout << "- Expanding " << entities.size() << " changed nodes and arcs..." << endl;
+			Profile.Start("changed nodes and arcs");
+			expanded = PatchNetwork(In, Old, entities, Net);
+			Profile.Stop(entities.size());
+			changed = !entities.empty();
+			if (expanded) {
+				Cache.ends.swap(Old.ends);
+				Cache.usestart.swap(Old.usestart);
+				Cache.usefile.swap(Old.usefile);
+				Cache.userow.swap(Old.userow);
+			}
+		}
+		if (!expanded) changed = true;
+	}
+	
+	// Expand nodes and arcs through all the steps
+	if (!expanded) {
+		Net = ExpandedNetwork();
+		for (int t = 0; t < PREP_TABLES-2; ++t) *Idx[t] = Index();
+		Cache.usestart.assign(1, 0);
+		cout << "- Expanding network (" << PrepThreads << " threads)..." << endl;
+		Profile.Start("node expansion");
+		ExpandList(In, false, Net, (useIncrementalPrep || Data.recordUses) ? &Cache : NULL);
+		Profile.Stop(Net.nodes.size());
+		Profile.Start("arc expansion");
+		ExpandList(In, true, Net, (useIncrementalPrep || Data.recordUses) ? &Cache : NULL);
+		Profile.Stop(Net.arcs.size());
+	}
+	
+	// Save index for sustainability metrics
+	IdxEm = Index();
+	for (int j = 0; j < SustMet.size(); ++j)
+		for (int i = 1; i <= SLength[0]; ++i)
+			IdxEm.Add(j, i-1, i, SustMet[j]);
+	return true;
+}
+
+// Read again the properties files replaced by a scenario and expand again
+// the nodes and arcs that use changed rows, or the whole lists if the codes
+// in the files changed. The network must have been expanded with
+// 'recordUses'. Lists and other global files are not replaced here.
+void ExpandScenario(PrepData& Data) {
+	vector<PropertyFile> Replaced(0);
+	vector<int> ids(0);
+	for (unsigned int f = 0; f < Data.PropFiles.size(); ++f) {
+		string name = Data.File(Data.PropFiles[f].name);
+		if (name == Data.PropFiles[f].name) continue;
+		Replaced.push_back(Data.PropFiles[f]);
+		Replaced.back().name = name;
+		ids.push_back(f);
+	}
+	
+	// Compare the rows of the base data set and the replacements
+	vector< vector<unsigned long long> > keys(Replaced.size()), rows(Replaced.size());
+	for (unsigned int k = 0; k < Replaced.size(); ++k)
+		HashProperties(*Replaced[k].text, Replaced[k].numbers, Replaced[k].num_fields, keys[k], rows[k]);
+	ReadPropertyFiles(Replaced, 1);
+	bool samecodes = true;
+	vector< vector<bool> > changed(Data.PropFiles.size());
+	for (unsigned int k = 0; k < Replaced.size(); ++k) {
+		vector<unsigned long long> newkeys, newrows;
+		HashProperties(*Replaced[k].text, Replaced[k].numbers, Replaced[k].num_fields, newkeys, newrows);
+		samecodes = samecodes && (newkeys == keys[k]);
+		changed[ids[k]].assign(newrows.size(), false);
+		for (unsigned int r = 0; samecodes && (r < newrows.size()); ++r)
+			changed[ids[k]][r] = (newrows[r] != rows[k][r]);
+		Data.PropFiles[ids[k]].name = Replaced[k].name;
+	}
+	
+	const PrepCache& Cache = Data.Cache;
+	if (samecodes && (Cache.usestart.size() == Data.ListNodes.size() + Data.ListArcs.size() + 1)) {
+		vector<int> entities(0);
+		for (unsigned int e = 0; e + 1 < Cache.usestart.size(); ++e) {
+			for (int u = Cache.usestart[e]; u < Cache.usestart[e+1]; ++u) {
+				const vector<bool>& rowchanged = changed[Cache.usefile[u]];
+				if (!rowchanged.empty() && rowchanged[Cache.userow[u]]) {
+					entities.push_back(e);
+					break;
+				}
+			}
+		}
+		cout << "- Expanding " << entities.size() << " changed nodes and arcs..." << endl;
+		if (PatchNetwork(Data.In, Cache, entities, Data.Net)) return;
+	}
+	
+	cout << "- Expanding network..." << endl;
+	Index* Idx[PREP_TABLES-2];
+	GlobalIndices(Idx);
+	Data.Net = ExpandedNetwork();
+	for (int t = 0; t < PREP_TABLES-2; ++t) *Idx[t] = Index();
+	ExpandList(Data.In, false, Data.Net, NULL);
+	ExpandList(Data.In, true, Data.Net, NULL);
+}
+
+// Add the elements of the optimization model of the expanded network: all of
+// them ('year' -1), or only the ones of one Benders block, the master problem
+// ('year' 0) or a year. Either way the elements are added in the same order,
+// so each block is the same.
+static void AddModelElements(const PrepData& Data, ModelBuilder& model, const int year) {
+	const ExpandedNetwork& Net = Data.Net;
+	const MatrixStr& SustLimits = Data.SustLimits;
+	int nyears = SLength[0];
+	string Ychar = SName.substr(0,1);
+	
+	// Nodes and arcs of the block, and the ones that also add elements to
+	// the master problem (all of them for the master problem)
+	vector<int> nodes(0), arcs(0), dcnodes(0), masternodes(0), masterarcs(0);
+	for (unsigned int i = 0; i < Net.nodes.size(); ++i) {
+		if ((year < 0) || (Net.nodes[i].Time() == year)) nodes.push_back(i);
+		if ((year <= 0) || (Net.nodes[i].Time() == year)) masternodes.push_back(i);
+	}
+	for (unsigned int i = 0; i < Net.arcs.size(); ++i) {
+		if ((year < 0) || (Net.arcs[i].Time() == year)) arcs.push_back(i);
+		if ((year <= 0) || (Net.arcs[i].Time() == year)) masterarcs.push_back(i);
+	}
+	for (unsigned int i = 0; i < Net.dcnodes.size(); ++i)
+		if ((year < 0) || (Net.nodes[Net.dcnodes[i]].Time() == year)) dcnodes.push_back(Net.dcnodes[i]);
+	int first = (year < 0) ? 0 : year, last = (year < 0) ? nyears : year;
+	
+	// ROWS (Cost objective funtion)
+	for (int i = first; i <= last; ++i)
+		model.AddRow(i, 'N', "obj", (i == 0) ? MODEL_BOTH : MODEL_BENDERS);
+	if (year < 0)
+		model.AddRow(0, 'E', "HTobj", MODEL_FULL); // End effects - horizon time period objective function May 3 2013
+	
+	// Sustainability metrics (rows)
+	for (int j = 0; j < SustMet.size(); ++j)
+		for (int i = (first > 1) ? first : 1; i <= last; ++i)
+			model.AddRow(i, 'E', SustMet[j] + Ychar + ToString<int>(i));
+	
+	// Peak load
+	for (unsigned int i = 0; i < masternodes.size(); ++i)
+		Net.nodes[masternodes[i]].NodePeakRows(model);
+	
+	// Nodal demand constraints
+	for (unsigned int i = 0; i < nodes.size(); ++i)
+		Net.nodes[nodes[i]].NodeNames(model);
+	
+	// Upper bound constraints rows
+	for (unsigned int i = 0; i < arcs.size(); ++i)
+		Net.arcs[arcs[i]].ArcUbNames(model);
+	
+	// "inv2cap" constraints
+	for (unsigned int i = 0; i < masterarcs.size(); ++i)
+		Net.arcs[masterarcs[i]].ArcCapNames(model);
+	
+	// DC Power flow constraints
+	for (unsigned int i = 0; i < arcs.size(); ++i)
+		Net.arcs[arcs[i]].ArcDcNames(model);
+	
+	// COLUMNS (Variables)
+	// Cost of subproblems (BENDERS ONLY)
+	for (int i = 1; i <= ((year <= 0) ? nyears : 0); ++i) {
+		model.AddEntry(0, model.ColumnId("cost_" + ToString<int>(i)), "obj", 1, MODEL_BENDERS);
+		model.KeepColumn(0, model.ColumnId("cost_" + ToString<int>(i)), MODEL_BENDERS);
+	}
+	
+	// Capacities (these vary slightly for Benders)
+	for (unsigned int i = 0; i < masterarcs.size(); ++i)
+		Net.arcs[masterarcs[i]].CapArcColumns(model);
+	
+	// Investments
+	for (unsigned int i = 0; i < masterarcs.size(); ++i)
+		Net.arcs[masterarcs[i]].InvArcColumns(model);
+	
+	// Sustainability metrics
+	for (int j = 0; j < SustMet.size(); ++j)
+		for (int i = (first > 1) ? first : 1; i <= last; ++i)
+			model.AddEntry(i, model.ColumnId(SustMet[j] + "_" + Ychar + ToString<int>(i)), SustMet[j] + Ychar + ToString<int>(i), -1);
+	
+	// Reserve margin
+	for (unsigned int i = 0; i < masternodes.size(); ++i)
+		Net.nodes[masternodes[i]].NodeRMColumns(model);
+	
+	// Flows
+	for (unsigned int i = 0; i < arcs.size(); ++i)
+		Net.arcs[arcs[i]].ArcColumns(model);
+	
+	// Unserved demands
+	for (unsigned int i = 0; i < nodes.size(); ++i)
+		Net.nodes[nodes[i]].NodeUDColumns(model);
+	
+	// Power flow variables (angles)
+	DCFlowColumns(Net, model, year);
+
+	// End Effects - Objective function computation - May 03 2013 Venkat
+	if (year < 0)
+		model.AddEntry(0, model.ColumnId("HTobjvar"), "HTobj", -1, MODEL_FULL);
+	// Save index for end effect obj. fn. metrics
+	IdxHo = Index();
+	IdxHo.Add(0, 0, 1, "HTobj");
+
+		// Cost curves - March 04 2014 - Venkat
+	for (unsigned int i = 0; i < arcs.size(); ++i)
+		Net.arcs[arcs[i]].ArcCC(model);
+
+		
+	// RHS
+	// Nodal Demands
+	for (unsigned int i = 0; i < nodes.size(); ++i)
+		Net.nodes[nodes[i]].NodeRhs(model);
+	
+	// Initial capacity terms
+	for (unsigned int i = 0; i < masterarcs.size(); ++i)
+		Net.arcs[masterarcs[i]].ArcRhs(model);
+	
+	// BOUNDS
+	// Peak load must be met
+	for (unsigned int i = 0; i < masternodes.size(); ++i)
+		Net.nodes[masternodes[i]].NodeRMBounds(model);
+	
+	// Flow and investment bounds, cost curve
+	for (unsigned int i = 0; i < masterarcs.size(); ++i) {
+		Net.arcs[masterarcs[i]].ArcBounds(model);
+		Net.arcs[masterarcs[i]].ArcInvBounds(model);
+		// Cost curve Mar 04 2014 - Venkat
+		Net.arcs[masterarcs[i]].ArcCCBounds(model);
+	}
+	
+	// DC Power flow angles
+	for (unsigned int i = 0; i < dcnodes.size(); ++i)
+		Net.nodes[dcnodes[i]].DCNodesBounds(model);
+	
+	// Sustainability limits
+	for (int j = 0; j < SustMet.size(); ++j) {
+		int SustIndex = FindCode(SustMet[j], SustLimits);
+		if (SustIndex >= 0) {
+			Step TempStep(SName.size(), 0);
+			for (int i = (first > 1) ? first : 1; i <= last; ++i) {
+				TempStep[0] = i;
+				string Value = SustLimits[SustIndex][Step2Pos(TempStep)+1];
+				if (Value != "X")
+					model.AddBound(i, 'U', model.ColumnId(SustMet[j] + "_" + Step2Str(TempStep)), Str2Num(Value));
+			}
+		}
+	}
+}
+
+// Build the optimization model of the expanded network
+void BuildModel(const PrepData& Data, ModelBuilder& model) {
+	AddModelElements(Data, model, -1);
+}
+
+// Rows of prepdata/bend_events.csv: the capacity of each capacitated arc in
+// each event, and then whether each year has to be solved for each event
+MatrixStr PrepEventRows(const ExpandedNetwork& Net) {
+	int nyears = SLength[0];
+	MatrixStr output(0);
+	
+	// Determines whether an operational year needs to be solved for each event
+	vector<double> YearEvents(nyears*(Nevents+1), 0);
+	
+	for (unsigned int i = 0; i < Net.arcs.size(); ++i) {
+		vector<string> ArcEvents(Net.arcs[i].Events());
+		// If information is returned
+		if (ArcEvents.size() > 0) {
+			output.push_back(ArcEvents);
+			for (int k = 1; k < ArcEvents.size(); ++k) {
+				if (ArcEvents[k] != "1") {
+					YearEvents[(Net.arcs[i].Time()-1) * (Nevents+1) + k] = 1;
+					YearEvents[(Net.arcs[i].Time()-1) * (Nevents+1)] = 1;
+				}
+			}
+		}
+	}
+	for (int i=0; i < nyears; ++i) {
+		VectorStr row(0);
+		for (int k=0; k <= Nevents; ++k)
+			row.push_back(ToString<double>(YearEvents[ i * (Nevents+1) + k ]));
+		output.push_back(row);
+	}
+	return output;
+}
+
+// Same values 'ReadEvents' reads from prepdata/bend_events.csv
+void PrepEvents(const ExpandedNetwork& Net, double output[]) {
+	MatrixStr EventRows(PrepEventRows(Net));
+	int i = 0;
+	for (unsigned int r = 0; r < EventRows.size(); ++r)
+		for (int k = 0; k <= Nevents; ++k)
+			output[i++] = atof(EventRows[r][k].c_str());
+}
+
+// Write the events and multiobjective parameters files in prepdata/
+static void WriteAuxFiles(const ExpandedNetwork& Net) {
+	// *** Write step lengths for capacitated arcs ***
+	ofstream afile;
+	afile.open("prepdata/bend_events.csv");
+	MatrixStr EventRows(PrepEventRows(Net));
+	for (unsigned int i = 0; i < EventRows.size(); ++i) {
+		afile << EventRows[i][0];
+		for (unsigned int k = 1; k < EventRows[i].size(); ++k)
+			afile << "," << EventRows[i][k];
+		afile << endl;
+	}
+	afile.close();
+	
+	// *** Write multiobjective parameters file ***
+	afile.open("prepdata/param.in");
+
+	// Pop. size, # gen, # objectives, # constraints
+	afile << Npopsize << endl;
+	afile << Nngen << endl;
+	afile << Nobj << endl;
+	afile << "0" << endl;
+	
+	// # real variables (none use yet)
+	afile << "0" << endl;
+	
+	// Crossover probability, mutation, 2 more indices
+	afile << Npcross_real << endl;
+	afile << Npmut_real << endl;
+	afile << Neta_c << endl;
+	afile << Neta_m << endl;
+	
+	// Add # of binary variables, min and max for all
+	int num_var = 0;
+	string text_var = "";
+	for (unsigned int i = 0; i < Net.arcs.size(); ++i) {
+		if (Net.arcs[i].InvArc() && (Net.arcs[i].Get(ASlot.TransInfr) == "") && !isinf(Net.arcs[i].GetValue(ASlot.InvMax))) {
+			num_var++;
+			text_var += Nstages + " " + Net.arcs[i].GetText(ASlot.InvMin) + " " + Net.arcs[i].GetText(ASlot.InvMax) + "\n";
+		}
+	}
+	
+	afile << num_var << endl;
+	afile << text_var;
+	
+	// Crossover probability, mutation
+	afile << Npcross_bin << endl;
+	afile << Npmut_bin << endl;
+	
+	// Close file
+	afile.close();
+}
+
+// Names of the model files of a Benders block (or of the full model, -1)
+static string ModelFileName(const int block) {
+	return (block < 0) ? "prepdata/netscore" : "prepdata/bend_" + ToString<int>(block);
+}
+
+// Write the MPS and binary model files of a Benders block (or of the full
+// model, -1). With incremental preprocessing, files that would be written
+// with the same contents as in the previous run are kept, and for the
+// scenarios, the ones with the same contents as the base are linked. Files
+// are removed before they're written, since they may be links. Returns the
+// number of files kept or linked.
+static int WriteModelFiles(PrepData& Data, const ModelBuilder& model, const int block, const unsigned long long hash) {
+	string mps_ext = useCompressMPS ? ".mps.gz" : ".mps", old_ext = useCompressMPS ? ".mps" : ".mps.gz";
+	string file_name = ModelFileName(block);
+	remove((file_name + old_ext).c_str());
+	if (useIncrementalPrep) {
+		Data.Manifest.outputs[file_name + mps_ext] = hash;
+		Data.Manifest.outputs[file_name + ".bin"] = hash;
+		if (Data.incremental && KeepOutput(Data.Previous, file_name + mps_ext, hash) && KeepOutput(Data.Previous, file_name + ".bin", hash))
+			return 2;
+	}
+	if (LinkOutput(Data, file_name + mps_ext, hash) && LinkOutput(Data, file_name + ".bin", hash))
+		return 2;
+	remove((file_name + mps_ext).c_str());
+	remove((file_name + ".bin").c_str());
+	FileWriter mpsfile;
+	Profile.Start("mps files");
+	mpsfile.Open(file_name + mps_ext);
+	WriteMPS(mpsfile, model, block);
+	mpsfile.Close();
+	Profile.Stop(1);
+	Profile.Start("binary model files");
+	WriteModelFile((file_name + ".bin").c_str(), model, block);
+	Profile.Stop(1);
+	return 0;
+}
+
+// Index files (prepdata/idx_*.csv)
+static const int IdxCount = 11;
+static void IndexFiles(Index* IdxFiles[], const char* IdxNames[]) {
+	Index* files[IdxCount] = { &IdxNode, &IdxUd, &IdxRm, &IdxArc, &IdxInv, &IdxNsga, &IdxCap, &IdxUb, &IdxEm, &IdxDc, &IdxHo };
+	const char* names[IdxCount] = { "prepdata/idx_node.csv", "prepdata/idx_ud.csv", "prepdata/idx_rm.csv",
+		"prepdata/idx_arc.csv", "prepdata/idx_inv.csv", "prepdata/idx_nsga.csv", "prepdata/idx_cap.csv",
+		"prepdata/idx_ub.csv", "prepdata/idx_em.csv", "prepdata/idx_dc.csv", "prepdata/idx_ho.csv" }; // idx_ho: end effects
+	for (int t = 0; t < IdxCount; ++t) {
+		IdxFiles[t] = files[t];
+		IdxNames[t] = names[t];
+	}
+}
+
+// Write the index and auxiliary files, and the manifest and cache of the
+// incremental preprocessing ('kept' model files were kept or linked)
+static void WriteIndexFiles(PrepData& Data, int kept) {
+	const ExpandedNetwork& Net = Data.Net;
+	PrepManifest& Manifest = Data.Manifest;
+	const PrepManifest& Previous = Data.Previous;
+	const PrepCache& Cache = Data.Cache;
+	const bool incremental = Data.incremental, changed = Data.changed;
+	Index* Idx[PREP_TABLES-2];
+	GlobalIndices(Idx);
+	
+	cout << "- Writing auxiliary files..." << endl;
+	
+	// *** Write node, arc information index files ***
+	Index* IdxFiles[IdxCount];
+	const char* IdxNames[IdxCount];
+	IndexFiles(IdxFiles, IdxNames);
+	Profile.Start("index files");
+	int IdxLines = 0;
+	for (int t = 0; t < IdxCount; ++t) {
+		unsigned long long hash = (useIncrementalPrep || !Data.BaseFolder.empty()) ? HashIndex(*IdxFiles[t]) : 0;
+		if (useIncrementalPrep) {
+			Manifest.outputs[IdxNames[t]] = hash;
+			if (incremental && KeepOutput(Previous, IdxNames[t], hash)) {
+				++kept;
+				continue;
+			}
+		}
+		if (LinkOutput(Data, IdxNames[t], hash)) {
+			++kept;
+			continue;
+		}
+		remove(IdxNames[t]);
+		IdxFiles[t]->WriteFile(IdxNames[t]);
+		IdxLines += IdxFiles[t]->size;
+	}
+	Profile.Stop(IdxLines);
+	
+
+	// *** Write node demand information ***
+	//WriteOutput("prepdata/data_node_demand.csv", IdxNode, Net.nodes, "Demand", "% Node demand");
+	//WriteOutput("prepdata/data_arc_opmax.csv", IdxArc, Net.arcs, "OpMax", "% Initial capacity");
+	//WriteOutput("prepdata/data_arc_invcost.csv", IdxArc, Net.arcs, "InvCost", "% Arc: Investment costs");
+	//WriteOutput("prepdata/data_arc_invstart.csv", IdxArc, Net.arcs, "InvStart", "% Arc: Investment start");
+	/*for (int j = 0; j < SustMet.size(); ++j) {
+		string file_name = "prepdata/data_arc_" + SustMet[j] + ".csv";
+		WriteOutput(file_name.c_str(), IdxArc, Net.arcs, "Op" + SustMet[j], "% Arc sustainability: " + SustMet[j]);
+	}*/
+	
+	
+	Profile.Start("auxiliary files");
+	WriteAuxFiles(Net);
+	Profile.Stop();
+	
+	if ((kept > 0) && !Data.BaseFolder.empty()) cout << "- Linked " << kept << " files with the same contents as the base model" << endl;
+	
+	// *** Save the hashes and expansion for the next incremental run ***
+	if (useIncrementalPrep) {
+		if ((kept > 0) && Data.BaseFolder.empty()) cout << "- Kept " << kept << " unchanged files from the previous run" << endl;
+		Manifest.outputs["prepdata/bend_events.csv"] = HashFile("prepdata/bend_events.csv");
+		Manifest.outputs["prepdata/param.in"] = HashFile("prepdata/param.in");
+		if (changed) Cache.Save("prepdata/prep_cache.bin", Net, Idx);
+		Manifest.Write("prepdata/manifest.csv");
+	}
+}
+
+// Write the model files (netscore.mps stores one single problem, without
+// Benders, and bend_#.mps store the Benders decomposition; binary files
+// (*.bin) have the same problems, ready to be loaded by the solver, reduced
+// with ReduceModel and with the map back to the full problems), and then the
+// rest of prepdata/
+void WritePrepFiles(PrepData& Data, const ModelBuilder& model) {
+	int nyears = SLength[0];
+	cout << "- Writing MPS and binary model files..." << endl;
+	bool hashed = useIncrementalPrep || !Data.BaseFolder.empty();
+	vector<unsigned long long> ModelHash;
+	if (hashed) ModelHash = HashModel(model);
+	int kept = 0;
+	for (int i = -1; i <= nyears; ++i)
+		kept += WriteModelFiles(Data, model, i, hashed ? ((i < 0) ? ModelHash.back() : ModelHash[i]) : 0);
+	WriteIndexFiles(Data, kept);
+}
+
+// Hashes of the model and index files that 'WritePrepFiles' writes for a
+// model (and the current indices)
+void PrepOutputHashes(const ModelBuilder& model, PrepManifest& output) {
+	string mps_ext = useCompressMPS ? ".mps.gz" : ".mps";
+	vector<unsigned long long> ModelHash = HashModel(model);
+	for (int i = -1; i <= SLength[0]; ++i) {
+		unsigned long long hash = (i < 0) ? ModelHash.back() : ModelHash[i];
+		output.outputs[ModelFileName(i) + mps_ext] = hash;
+		output.outputs[ModelFileName(i) + ".bin"] = hash;
+	}
+	Index* IdxFiles[IdxCount];
+	const char* IdxNames[IdxCount];
+	IndexFiles(IdxFiles, IdxNames);
+	for (int t = 0; t < IdxCount; ++t)
+		output.outputs[IdxNames[t]] = HashIndex(*IdxFiles[t]);
+}
+
+// Build and write the Benders blocks one at a time (the master problem first,
+// and then each year), releasing each block once it's written, so the memory
+// used doesn't grow with the number of years. The full model isn't built:
+// the solver only reads the blocks with Benders decomposition, so the files
+// of netscore are removed.
+void StreamPrepFiles(PrepData& Data, ModelBuilder& model) {
+	int nyears = SLength[0];
+	cout << "- Building and writing the MPS and binary model files of each Benders block..." << endl;
+	remove("prepdata/netscore.mps");
+	remove("prepdata/netscore.mps.gz");
+	remove("prepdata/netscore.bin");
+	int kept = 0;
+	for (int i = 0; i <= nyears; ++i) {
+		Profile.Start("build model");
+		model.BuildOnly(i);
+		AddModelElements(Data, model, i);
+		Profile.Stop(model.colnames.size());
+		kept += WriteModelFiles(Data, model, i, useIncrementalPrep ? HashBlock(model, i) : 0);
+		model.Release(i);
+	}
+	model.BuildOnly(-1);
+	WriteIndexFiles(Data, kept);
+}
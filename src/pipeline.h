@@ -0,0 +1,81 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    pipeline.h -- Definition of the preprocessor stages
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+#ifndef _PIPELINE_H_
+#define _PIPELINE_H_
+
+// Data read from the input files, shared by the threads that expand the network
+struct PrepInput {
+	vector<Node>* ListNodes;
+	vector<Arc>* ListArcs;
+	MatrixStr NStep, ATransEnergy;
+	MatrixNum ATransEnergyNum;
+	vector<MatrixStr> NVectorProp, AVectorProp;
+	vector<MatrixNum> NVectorNum, AVectorNum;
+	vector<CodeMatcher> NVectorMatch, AVectorMatch;
+	CodeMatcher NStepMatch, ATransEnergyMatch;
+	CostCurveData CostCurves;
+};
+
+// Declare class type to keep the inputs and the expanded network between the
+// stages of the preprocessor. 'prep' runs all of them and writes prepdata/;
+// 'netplan-run' hands the model to the solver in memory instead.
+class PrepData {
+	public:
+		PrepData();
+
+		// Name of an input file, after the replacements of the scenario
+		string File(const string& name) const;
+
+		// Input files replaced by others (see 'Scenario')
+		map<string, string> files;
+
+		vector<Node> ListNodes;
+		vector<Arc> ListArcs;
+		MatrixStr SustLimits;
+		PrepInput In;
+		vector<PropertyFile> PropFiles;
+		ExpandedNetwork Net;
+
+		// Incremental preprocessing: hashes of this and the previous run, and
+		// whether prepdata/ can be reused and the network changed. With
+		// 'recordUses', the rows used by each node and arc are kept in the
+		// cache even without incremental preprocessing (for the scenarios).
+		PrepManifest Manifest, Previous;
+		PrepCache Cache;
+		bool incremental, changed, recordUses;
+
+		// Scenarios: hashes of the files written for the base data set, whose
+		// prepdata/ is in 'BaseFolder'. Files that would be written with the
+		// same contents are hard links to the ones of the base instead.
+		PrepManifest BaseOutputs;
+		string BaseFolder;
+
+	private:
+		PrepData(const PrepData& rhs);
+		PrepData& operator=(const PrepData& rhs);
+};
+
+// Defined in netscore.h, with the global variables
+int FindCode(const string& mystr, const MatrixStr mymatrix);
+int FindCode(const Node& mynode, const CodeMatcher& matcher);
+int FindCode(const Arc& myarc, const CodeMatcher& matcher);
+void DCFlowColumns(const ExpandedNetwork& net, ModelBuilder& model, const int year = -1);
+
+void ReadInputs(PrepData& Data);
+bool ExpandNetwork(PrepData& Data);
+void ExpandScenario(PrepData& Data);
+void BuildModel(const PrepData& Data, ModelBuilder& model);
+void WritePrepFiles(PrepData& Data, const ModelBuilder& model);
+void PrepOutputHashes(const ModelBuilder& model, PrepManifest& output);
+void StreamPrepFiles(PrepData& Data, ModelBuilder& model);
+
+// Capacity of the arcs in each event (prepdata/bend_events.csv)
+MatrixStr PrepEventRows(const ExpandedNetwork& Net);
+void PrepEvents(const ExpandedNetwork& Net, double output[]);
+
+#endif  // _PIPELINE_H_
@@ -42,23 +42,8 @@ int main () {
 	netplan.SolveIndividual(objective, events, true);
 	
 	// Report solutions if the problem is feasible
-	if (objective[0] < 1.0e29) {
-		vector<string> solstring(netplan.SolutionString());
-		WriteOutput("prepdata/post_emissions.csv", IdxEm, solstring, "% Emissions");
-		WriteOutput("prepdata/post_node_rm.csv", IdxRm, solstring, "% Reserve margins");
-		WriteOutput("prepdata/post_arc_inv.csv", IdxInv, solstring, "% Investments");
-		WriteOutput("prepdata/post_arc_cap.csv", IdxCap, solstring, "% Capacity");
-		WriteOutput("prepdata/post_arc_flow.csv", IdxArc, solstring, "% Arc flows");
-		WriteOutput("prepdata/post_node_ud.csv", IdxUd, solstring, "% Demand not served at nodes");
-		WriteOutput("prepdata/post_node_dc.csv", IdxDc, solstring, "% Node power flow angles"); // Feb 21 2013
-		WriteOutput("prepdata/post_node_ho.csv", IdxHo, solstring, "% Horizon objective end effects"); // Feb 21 2013
-		
-		for (int i=0; i <= Nevents; ++i) {
-			vector<string> dualstring(netplan.SolutionDualString(i));
-			string file_name = "prepdata/post_nodal_dual_e" + ToString<int>(i) + ".csv";
-			WriteOutput(file_name.c_str(), IdxNode, dualstring, "% Dual variable at demand nodes");
-		}
-	}
+	if (objective[0] < 1.0e29)
+		WritePostFiles(netplan);
 	
 	cout << "- Values returned:" << endl;
 	for (int k = 0; k < Nobj; ++k)
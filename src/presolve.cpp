@@ -0,0 +1,146 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    presolve.cpp -- Implementation of the reduction of the model files
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+using namespace std;
+#include <vector>
+#include <math.h>
+#include "presolve.h"
+
+// Tolerance to accept a right-hand side or a bound as met
+#define PRESOLVE_TOL 1e-9
+
+// Whether an empty row is met by its right-hand side
+static bool EmptyRowMet(const char type, const double rhs) {
+	if (type == 'E') return fabs(rhs) <= PRESOLVE_TOL;
+	if (type == 'L') return rhs >= -PRESOLVE_TOL;
+	return rhs <= PRESOLVE_TOL;
+}
+
+// Turn a row with only column 'c' (coefficient 'coef') into bounds of the
+// column (false if the row can't be met within the current bounds)
+static bool RowToBounds(ModelArrays& p, const char type, const double rhs, const double coef, const int c) {
+	double bound = rhs / coef, tol = PRESOLVE_TOL * (1 + fabs(bound));
+	bool upper = (type == 'E') || ((type == 'L') == (coef > 0));
+	bool lower = (type == 'E') || !upper;
+	if ((upper && (bound < p.lower[c] - tol)) || (lower && (bound > p.upper[c] + tol)))
+		return false;
+	if (upper && (bound < p.upper[c])) p.upper[c] = (bound < p.lower[c]) ? p.lower[c] : bound;
+	if (lower && (bound > p.lower[c])) p.lower[c] = (bound > p.upper[c]) ? p.upper[c] : bound;
+	return true;
+}
+
+// Value of a column without entries that doesn't change the objective
+// (NaN if there isn't one)
+static double EmptyColumnValue(const ModelArrays& p, const int c) {
+	double output = 0;
+	if (p.obj[c] > 0) output = p.lower[c];
+	else if (p.obj[c] < 0) output = p.upper[c];
+	else if (p.lower[c] > 0) output = p.lower[c];
+	else if (p.upper[c] < 0) output = p.upper[c];
+	return (isinf(output) || (p.obj[c] * output != 0)) ? NAN : output;
+}
+
+void ReduceModel(ModelArrays& problem, const vector<bool>& keeprow, const vector<bool>& keepcol, PostsolveMap& postsolve, const bool rowbounds) {
+	ModelArrays& p = problem;
+	int nrows = p.rowtype.size(), ncols = p.obj.size(), nnz = p.index.size();
+
+	// Column of each entry and entries by row (zeros are dropped), with the
+	// number of entries left in each row and column
+	vector<int> column(nnz), rowstart(nrows + 1, 0), rowentry(nnz), rowcount(nrows, 0), colcount(ncols, 0);
+	for (int c = 0; c < ncols; ++c) {
+		for (int e = p.start[c]; e < p.start[c+1]; ++e) {
+			column[e] = c;
+			if (p.value[e] == 0) continue;
+			++rowstart[p.index[e]+1];
+			++rowcount[p.index[e]];
+			++colcount[c];
+		}
+	}
+	for (int r = 0; r < nrows; ++r)
+		rowstart[r+1] += rowstart[r];
+	vector<int> next(rowstart.begin(), rowstart.end() - 1);
+	for (int e = 0; e < nnz; ++e)
+		if (p.value[e] != 0) rowentry[next[p.index[e]]++] = e;
+
+	// Rows and columns are checked again every time one of their entries is
+	// removed or their bounds change, until nothing else can be reduced
+	vector<bool> rowalive(nrows, true), colalive(ncols, true);
+	vector<int> rowqueue(0), colqueue(0);
+	for (int r = nrows - 1; r >= 0; --r) rowqueue.push_back(r);
+	for (int c = ncols - 1; c >= 0; --c) colqueue.push_back(c);
+	postsolve.fixed.assign(ncols, 0);
+	while (!rowqueue.empty() || !colqueue.empty()) {
+		if (!rowqueue.empty()) {
+			int r = rowqueue.back();
+			rowqueue.pop_back();
+			if (!rowalive[r] || keeprow[r] || (rowcount[r] > 1)) continue;
+			if (rowcount[r] == 0) {
+				if (!EmptyRowMet(p.rowtype[r], p.rhs[r])) continue;
+			} else {
+				int e = -1;
+				for (int k = rowstart[r]; e < 0; ++k)
+					if (colalive[column[rowentry[k]]]) e = rowentry[k];
+				int c = column[e];
+				if (!rowbounds || keepcol[c] || !RowToBounds(p, p.rowtype[r], p.rhs[r], p.value[e], c)) continue;
+			}
+			rowalive[r] = false;
+			for (int k = rowstart[r]; k < rowstart[r+1]; ++k) {
+				int c = column[rowentry[k]];
+				if (!colalive[c]) continue;
+				--colcount[c];
+				colqueue.push_back(c);
+			}
+			continue;
+		}
+
+		// Fixed columns that don't change the objective (without cost, or
+		// fixed at zero) and empty columns
+		int c = colqueue.back();
+		colqueue.pop_back();
+		if (!colalive[c] || keepcol[c]) continue;
+		double fixed;
+		if ((p.lower[c] == p.upper[c]) && ((p.obj[c] == 0) || (p.lower[c] == 0))) fixed = p.lower[c];
+		else if (colcount[c] == 0) fixed = EmptyColumnValue(p, c);
+		else continue;
+		if (isnan(fixed)) continue;
+		colalive[c] = false;
+		postsolve.fixed[c] = fixed;
+		for (int e = p.start[c]; e < p.start[c+1]; ++e) {
+			int r = p.index[e];
+			if ((p.value[e] == 0) || !rowalive[r]) continue;
+			p.rhs[r] -= p.value[e] * fixed;
+			--rowcount[r];
+			rowqueue.push_back(r);
+		}
+	}
+
+	// Reduced problem
+	ModelArrays output;
+	postsolve.rowmap.assign(nrows, -1);
+	for (int r = 0; r < nrows; ++r) {
+		if (!rowalive[r]) continue;
+		postsolve.rowmap[r] = output.rowtype.size();
+		output.rowtype.push_back(p.rowtype[r]);
+		output.rhs.push_back(p.rhs[r]);
+	}
+	postsolve.colmap.assign(ncols, -1);
+	output.start.push_back(0);
+	for (int c = 0; c < ncols; ++c) {
+		if (!colalive[c]) continue;
+		postsolve.colmap[c] = output.obj.size();
+		output.obj.push_back(p.obj[c]);
+		output.lower.push_back(p.lower[c]);
+		output.upper.push_back(p.upper[c]);
+		for (int e = p.start[c]; e < p.start[c+1]; ++e) {
+			if ((p.value[e] == 0) || !rowalive[p.index[e]]) continue;
+			output.index.push_back(postsolve.rowmap[p.index[e]]);
+			output.value.push_back(p.value[e]);
+		}
+		output.start.push_back(output.index.size());
+	}
+	problem = output;
+}
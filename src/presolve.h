@@ -0,0 +1,39 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    presolve.h -- Definition of the reduction of the model files
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+#ifndef _PRESOLVE_H_
+#define _PRESOLVE_H_
+
+// Declare structure to store a problem with the arrays of a binary model
+// file (see 'ModelFile'): rows of type 'E', 'L' or 'G' and the matrix
+// compressed by columns
+struct ModelArrays {
+	vector<char> rowtype;
+	vector<double> rhs;
+	vector<double> obj, lower, upper;
+	vector<int> start, index;
+	vector<double> value;
+};
+
+// Declare structure to map the solution of a reduced problem to the full
+// one: for each row and column of the full problem, its position in the
+// reduced one (-1 if it was removed), and the value of removed columns
+struct PostsolveMap {
+	vector<int> rowmap, colmap;
+	vector<double> fixed;
+};
+
+// Reduce a problem without changing its solution or its objective: rows with
+// a single column become bounds (if 'rowbounds'), columns fixed without cost
+// or at zero are moved to the right-hand side, and empty rows and columns are
+// removed. Rows and columns that are kept ('keeprow' and 'keepcol', the ones
+// the solver changes or reads by position) are never removed or turned into
+// bounds. Benders subproblems don't turn rows into bounds, since the duals
+// of all their rows are needed for the cuts.
+void ReduceModel(ModelArrays& problem, const vector<bool>& keeprow, const vector<bool>& keepcol, PostsolveMap& postsolve, const bool rowbounds = true);
+
+#endif  // _PRESOLVE_H_
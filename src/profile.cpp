@@ -0,0 +1,152 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    profile.cpp -- Implementation of the phase profiler
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+using namespace std;
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include "global.h"
+#include "profile.h"
+
+double WallTime() {
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return now.tv_sec + now.tv_usec * 1e-6;
+}
+
+double CpuTime() {
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+}
+
+double ThreadCpuTime() {
+	struct timespec now;
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0) return 0;
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+long PeakMemory() {
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+}
+
+
+// Contructor for the PhaseProfiler class (the program starts with it)
+PhaseProfiler::PhaseProfiler() :
+	detailed(false), programwall(WallTime()), programcpu(CpuTime()) {}
+
+void PhaseProfiler::Start(const string& name) {
+	running.push_back(Find(name));
+	startwall.push_back(WallTime());
+	startcpu.push_back(CpuTime());
+}
+
+void PhaseProfiler::Stop(const long items) {
+	if (running.empty()) return;
+	Phase& phase = phases[running.back()];
+	phase.wall += WallTime() - startwall.back();
+	phase.cpu += CpuTime() - startcpu.back();
+	phase.memory = PeakMemory();
+	phase.items += items;
+	++phase.calls;
+	running.pop_back();
+	startwall.pop_back();
+	startcpu.pop_back();
+}
+
+void PhaseProfiler::Add(const string& name, const double wall, const double cpu, const long items) {
+	Phase& phase = phases[Find(name)];
+	phase.wall += wall;
+	phase.cpu += cpu;
+	phase.memory = PeakMemory();
+	phase.items += items;
+	++phase.calls;
+}
+
+// Record of a phase inside the current one (a new one if there's none)
+int PhaseProfiler::Find(const string& name) {
+	int parent = running.empty() ? -1 : running.back();
+	for (unsigned int k = 0; k < phases.size(); ++k)
+		if ((phases[k].parent == parent) && (phases[k].name == name)) return k;
+
+	Phase phase;
+	phase.name = name;
+	phase.parent = parent;
+	phase.calls = 0;
+	phase.wall = phase.cpu = 0;
+	phase.memory = phase.items = 0;
+	phases.push_back(phase);
+	return phases.size() - 1;
+}
+
+// Text of a JSON string (quotes, backslashes and control characters escaped)
+static string JsonString(const string& input) {
+	string output = "\"";
+	for (unsigned int k = 0; k < input.size(); ++k) {
+		unsigned char c = input[k];
+		if ((c == '"') || (c == '\\')) {
+			output += '\\';
+			output += c;
+		} else if (c == '\n') {
+			output += "\\n";
+		} else if (c == '\t') {
+			output += "\\t";
+		} else if (c == '\r') {
+			output += "\\r";
+		} else if (c < 0x20) {
+			char code[8];
+			sprintf(code, "\\u%04x", c);
+			output += code;
+		} else {
+			output += c;
+		}
+	}
+	return output + "\"";
+}
+
+void PhaseProfiler::WritePhases(ostream& file, const int parent, const string& indent) const {
+	file << "[";
+	bool first = true;
+	for (unsigned int k = 0; k < phases.size(); ++k) {
+		if (phases[k].parent != parent) continue;
+		const Phase& phase = phases[k];
+		file << (first ? "\n" : ",\n") << indent << "  {\"name\": " << JsonString(phase.name);
+		file << ", \"calls\": " << phase.calls << ", \"wall\": " << phase.wall << ", \"cpu\": " << phase.cpu;
+		file << ", \"peak_rss_kb\": " << phase.memory << ", \"items\": " << phase.items << ", \"phases\": ";
+		WritePhases(file, k, indent + "  ");
+		file << "}";
+		first = false;
+	}
+	if (!first) file << "\n" << indent;
+	file << "]";
+}
+
+void PhaseProfiler::Write(const char* fileoutput) const {
+	ofstream file;
+	file.open(fileoutput);
+	if (!file.is_open()) {
+		printError("write", fileoutput);
+		return;
+	}
+	file << "{\n";
+	file << "  \"threads\": " << PrepThreads << ",\n";
+	file << "  \"detailed\": " << (detailed ? "true" : "false") << ",\n";
+	file << "  \"wall\": " << WallTime() - programwall << ",\n";
+	file << "  \"cpu\": " << CpuTime() - programcpu << ",\n";
+	file << "  \"peak_rss_kb\": " << PeakMemory() << ",\n";
+	file << "  \"phases\": ";
+	WritePhases(file, -1, "  ");
+	file << "\n}\n";
+	file.close();
+}
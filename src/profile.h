@@ -0,0 +1,59 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    profile.h -- Definition of the phase profiler
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+#ifndef _PROFILE_H_
+#define _PROFILE_H_
+
+// Wall time and CPU time (of the process or of the calling thread) in
+// seconds, and peak resident memory of the process in kB
+double WallTime();
+double CpuTime();
+double ThreadCpuTime();
+long PeakMemory();
+
+// Declare class type to measure the phases of a program: wall time, CPU
+// time, peak resident memory at the end and number of items processed.
+// Phases are nested in the ones that are running when they start, and a
+// phase started again in the same place adds to the same record. It's only
+// used from the main thread; work done in other threads is timed there and
+// added afterwards.
+class PhaseProfiler {
+	public:
+		PhaseProfiler();
+
+		void Start(const string& name);
+		void Stop(const long items = 0);
+
+		// Add a phase measured somewhere else inside the current one
+		void Add(const string& name, const double wall, const double cpu, const long items);
+
+		// Write the report in JSON, with the totals of the program and its phases
+		void Write(const char* fileoutput) const;
+
+		// Whether the details of each file are measured too (--profile)
+		bool detailed;
+
+	private:
+		struct Phase {
+			string name;
+			int parent, calls;
+			double wall, cpu;
+			long memory, items;
+		};
+
+		int Find(const string& name);
+		void WritePhases(ostream& file, const int parent, const string& indent) const;
+
+		vector<Phase> phases;
+
+		// Phases running, with the times when they started
+		vector<int> running;
+		vector<double> startwall, startcpu;
+		double programwall, programcpu;
+};
+
+#endif  // _PROFILE_H_
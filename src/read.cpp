@@ -10,12 +10,25 @@ using namespace std;
 #include <fstream>
 #include <string.h>
 #include <vector>
+#include <map>
+#include <set>
 #include <stdlib.h> // May 26 2013
+#include <math.h>
+#include <pthread.h>
 #include "global.h"
 #include "read.h"
+#include "csv.h"
 
 #define CHAR_LINE 15000
 
+// Fields of a line that are not empty (as they were read with 'strtok')
+static VectorStr Tokens(const CsvReader& file) {
+	VectorStr output(0);
+	for (int k = 0; k < file.size(); ++k)
+		if (file.Length(k) > 0) output.push_back(file.Get(k));
+	return output;
+}
+
 // Read global parameters
 void ReadParameters(const char* fileinput) {
 	char* t_read;
@@ -44,10 +57,30 @@ void ReadParameters(const char* fileinput) {
 				else if (prop == "StepHours") StepHours.push_back(value);
 				else if (prop == "UseDCFlow") useDCflow = (value == "true" || value == "True" || value == "TRUE");
 				else if (prop == "UseBenders") useBenders = (value == "true" || value == "True" || value == "TRUE");
+				else if (prop == "CompressMPS") useCompressMPS = (value == "true" || value == "True" || value == "TRUE");
+				else if (prop == "IncrementalPrep") useIncrementalPrep = (value == "true" || value == "True" || value == "TRUE");
+				else if (prop == "ReduceModel") useModelReduction = (value == "true" || value == "True" || value == "TRUE");
+				else if (prop == "PruneFleets") usePruneFleets = (value == "true" || value == "True" || value == "TRUE");
 				else if (prop == "Sobjeval") Sobjeval = atof(value.c_str()); // Venkat End effect May 3 2013 - real obj.
 				else if (prop == "cofire") cofire = atof(value.c_str()); // Venkat Biomass co-firing Feb 27 2014
 				else if (prop == "segmnt") segmnt = atoi(value.c_str()); // Venkat Biomass cost curve segments Mar 04 2014
 				else if (prop == "OutputLevel") outputLevel = atoi(value.c_str());
+				else if (prop == "PrepThreads") PrepThreads = atoi(value.c_str());
+				else if (prop == "SolverThreads") SolverThreads = atoi(value.c_str());
+				else if (prop == "SubproblemWorkers") SubproblemWorkers = atoi(value.c_str());
+				else if (prop == "CutPoolSize") CutPoolSize = atoi(value.c_str());
+				else if (prop == "CutPoolAge") CutPoolAge = atoi(value.c_str());
+				else if (prop == "BendersMode") BendersMode = value;
+				else if (prop == "BendersGap") BendersGap = atof(value.c_str());
+				else if (prop == "BendersTrustRadius") BendersTrustRadius = atof(value.c_str());
+				else if (prop == "BendersLevel") BendersLevel = atof(value.c_str());
+				else if (prop == "BendersInOutWeight") BendersInOutWeight = atof(value.c_str());
+				else if (prop == "BendersCore") BendersCore = value;
+				else if (prop == "BendersCuts") BendersCuts = value;
+				else if (prop == "BendersCutGroup") BendersCutGroup = atoi(value.c_str());
+				else if (prop == "BasisStore") BasisStore = atoi(value.c_str());
+				else if (prop == "ParetoCuts") useParetoCuts = (value == "true" || value == "True" || value == "TRUE");
+				else if (prop == "Scenarios") ScenarioFile = value;
 				else if (prop == "CodeDC") DCCode = value;
 				else if (prop == "DefStep") DefStep = value;
 				else if (prop == "DefDiscount") discount = value;
@@ -103,220 +136,266 @@ void ReadParameters(const char* fileinput) {
 		StepHours.insert(StepHours.begin(), ToString<int>(temp_hour));
 		temp_hour = temp_hour * SLength[j];
 	}
-	
+	InitStepTables();
+
 	// Number of objectives
 	Nobj = 1 + SustObj.size();
 	if (Nevents > 0)
 		++Nobj;
 	SustMet.insert(SustMet.begin(), SustObj.begin(), SustObj.end());
 	
-	// Declare a vector with the node property codes
-	NodeProp.push_back("Code"); NodeDefault.push_back("X");
-	NodeProp.push_back("ShortCode"); NodeDefault.push_back("X");
-	NodeProp.push_back("Step"); NodeDefault.push_back(DefStep);
-	NodeProp.push_back("StepLength"); NodeDefault.push_back("X");
-	NodeProp.push_back("Demand"); NodeDefault.push_back("0");
-	NodeProp.push_back("DemandPower"); NodeDefault.push_back("X");
-	NodeProp.push_back("DemandRate"); NodeDefault.push_back(demandrate);
-	NodeProp.push_back("PeakPower"); NodeDefault.push_back("X");
-	NodeProp.push_back("PeakPowerRate"); NodeDefault.push_back(peakdemandrate);
-	NodeProp.push_back("CostUD"); NodeDefault.push_back("X");
-	NodeProp.push_back("DiscountRate"); NodeDefault.push_back(discount);
-	NodeProp.push_back("InflationRate"); NodeDefault.push_back(inflation);
+	// Declare the node properties (code, default value and whether it's numeric)
+	NSlot.Code = NodeSchema.Add("Code", "X", false);
+	NSlot.ShortCode = NodeSchema.Add("ShortCode", "X", false);
+	NSlot.Step = NodeSchema.Add("Step", DefStep, false);
+	NSlot.StepLength = NodeSchema.Add("StepLength", "X", true);
+	NSlot.Demand = NodeSchema.Add("Demand", "0", true);
+	NSlot.DemandPower = NodeSchema.Add("DemandPower", "X", true);
+	NSlot.DemandRate = NodeSchema.Add("DemandRate", demandrate, true);
+	NSlot.PeakPower = NodeSchema.Add("PeakPower", "X", true);
+	NSlot.PeakPowerRate = NodeSchema.Add("PeakPowerRate", peakdemandrate, true);
+	NSlot.CostUD = NodeSchema.Add("CostUD", "X", true);
+	NSlot.DiscountRate = NodeSchema.Add("DiscountRate", discount, true);
+	NSlot.InflationRate = NodeSchema.Add("InflationRate", inflation, true);
 	NodePropOffset = 4;
 	
-	// Declare a vector with the arc property codes
+	// Declare the arc properties (code, default value and whether it's numeric)
 	string startzero = SName.substr(0,1) + "2";
-	ArcProp.push_back("Code"); ArcDefault.push_back("X");
-	ArcProp.push_back("From"); ArcDefault.push_back("X");
-	ArcProp.push_back("To"); ArcDefault.push_back("X");
-	ArcProp.push_back("FromStep"); ArcDefault.push_back(DefStep);
-	ArcProp.push_back("ToStep"); ArcDefault.push_back(DefStep);
-	ArcProp.push_back("StepLength"); ArcDefault.push_back("X");
-	ArcProp.push_back("InvStep"); ArcDefault.push_back(SName.substr(0,1));
-	ArcProp.push_back("TransInfr"); ArcDefault.push_back("");
-	ArcProp.push_back("OpCost"); ArcDefault.push_back("0");
-	ArcProp.push_back("InvCost"); ArcDefault.push_back("X");
-	ArcProp.push_back("DiscountRate"); ArcDefault.push_back(discount);
-	ArcProp.push_back("InflationRate"); ArcDefault.push_back(inflation);
-	ArcProp.push_back("Distance"); ArcDefault.push_back("X");
-	ArcProp.push_back("OpMin"); ArcDefault.push_back("0");
-	ArcProp.push_back("OpMax"); ArcDefault.push_back("Inf");
-	ArcProp.push_back("InvMin"); ArcDefault.push_back("0");
-	ArcProp.push_back("InvMax"); ArcDefault.push_back("Inf");
-	ArcProp.push_back("InvStart"); ArcDefault.push_back(startzero);
-	ArcProp.push_back("LifeSpan"); ArcDefault.push_back("X");
-	ArcProp.push_back("Eff"); ArcDefault.push_back("1");
-	ArcProp.push_back("InvertEff"); ArcDefault.push_back("N");
-	ArcProp.push_back("Suscep"); ArcDefault.push_back("X");
-	ArcProp.push_back("CapacityFactor"); ArcDefault.push_back("0");
+	ASlot.Code = ArcSchema.Add("Code", "X", false);
+	ASlot.From = ArcSchema.Add("From", "X", false);
+	ASlot.To = ArcSchema.Add("To", "X", false);
+	ASlot.FromStep = ArcSchema.Add("FromStep", DefStep, false);
+	ASlot.ToStep = ArcSchema.Add("ToStep", DefStep, false);
+	ASlot.StepLength = ArcSchema.Add("StepLength", "X", true);
+	ASlot.InvStep = ArcSchema.Add("InvStep", SName.substr(0,1), false);
+	ASlot.TransInfr = ArcSchema.Add("TransInfr", "", false);
+	ASlot.OpCost = ArcSchema.Add("OpCost", "0", true);
+	ASlot.InvCost = ArcSchema.Add("InvCost", "X", true);
+	ASlot.DiscountRate = ArcSchema.Add("DiscountRate", discount, true);
+	ASlot.InflationRate = ArcSchema.Add("InflationRate", inflation, true);
+	ASlot.Distance = ArcSchema.Add("Distance", "X", true);
+	ASlot.OpMin = ArcSchema.Add("OpMin", "0", true);
+	ASlot.OpMax = ArcSchema.Add("OpMax", "Inf", true);
+	ASlot.InvMin = ArcSchema.Add("InvMin", "0", true);
+	ASlot.InvMax = ArcSchema.Add("InvMax", "Inf", true);
+	ASlot.InvStart = ArcSchema.Add("InvStart", startzero, false);
+	ASlot.LifeSpan = ArcSchema.Add("LifeSpan", "X", false);
+	ASlot.Eff = ArcSchema.Add("Eff", "1", true);
+	ASlot.InvertEff = ArcSchema.Add("InvertEff", "N", false);
+	ASlot.Suscep = ArcSchema.Add("Suscep", "X", true);
+	ASlot.CapacityFactor = ArcSchema.Add("CapacityFactor", "0", true);
 	// June 26 2012 - Value of Travel Time for Passenger Transportation - Venkat Krishnan
-	ArcProp.push_back("VoTT"); ArcDefault.push_back("0");
-	ArcProp.push_back("Leadtime"); ArcDefault.push_back("y0"); // Venkat lead time May 25 2013
-	// Venkat cost-curve Feb 27 2014 - 15 segments (can be reduced)
-	ArcProp.push_back("OpMaxc1"); ArcDefault.push_back("Inf"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpCostc1"); ArcDefault.push_back("0"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpMaxc2"); ArcDefault.push_back("Inf"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpCostc2"); ArcDefault.push_back("0"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpMaxc3"); ArcDefault.push_back("Inf"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpCostc3"); ArcDefault.push_back("0"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpMaxc4"); ArcDefault.push_back("Inf"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpCostc4"); ArcDefault.push_back("0"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpMaxc5"); ArcDefault.push_back("Inf"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpCostc5"); ArcDefault.push_back("0"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpMaxc6"); ArcDefault.push_back("Inf"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpCostc6"); ArcDefault.push_back("0"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpMaxc7"); ArcDefault.push_back("Inf"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpCostc7"); ArcDefault.push_back("0"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpMaxc8"); ArcDefault.push_back("Inf"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpCostc8"); ArcDefault.push_back("0"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpMaxc9"); ArcDefault.push_back("Inf"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpCostc9"); ArcDefault.push_back("0"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpMaxc10"); ArcDefault.push_back("Inf"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpCostc10"); ArcDefault.push_back("0"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpMaxc11"); ArcDefault.push_back("Inf"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpCostc11"); ArcDefault.push_back("0"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpMaxc12"); ArcDefault.push_back("Inf"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpCostc12"); ArcDefault.push_back("0"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpMaxc13"); ArcDefault.push_back("Inf"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpCostc13"); ArcDefault.push_back("0"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpMaxc14"); ArcDefault.push_back("Inf"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpCostc14"); ArcDefault.push_back("0"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpMaxc15"); ArcDefault.push_back("Inf"); // Venkat Biomass cost-curve Feb 27 2014
-	ArcProp.push_back("OpCostc15"); ArcDefault.push_back("0"); // Venkat Biomass cost-curve Feb 27 2014
+	ASlot.VoTT = ArcSchema.Add("VoTT", "0", true);
+	ASlot.Leadtime = ArcSchema.Add("Leadtime", "y0", false); // Venkat lead time May 25 2013
 	// Sustainability
-	for (int j = 0; j < SustMet.size(); ++j) { ArcProp.push_back("Op" + SustMet[j]); ArcDefault.push_back("0"); }
+	for (int j = 0; j < SustMet.size(); ++j)
+		ASlot.Sust.push_back(ArcSchema.Add("Op" + SustMet[j], "0", true));
 	// Resiliency events
-	for (int j = 1; j <= Nevents; ++j) {
-		ArcProp.push_back("CapacityLoss" + ToString<int>(j)); ArcDefault.push_back("1");
-	}
+	for (int j = 1; j <= Nevents; ++j)
+		ASlot.Events.push_back(ArcSchema.Add("CapacityLoss" + ToString<int>(j), "1", true));
 	
 	ArcPropOffset = 8;
 }
 
-// Read properties file and store it in a matrix of strings.
-// The first 'num_fields' columns are copied and not touched.
-// The rest of the columns correspond to the different 'Steps' as determined by the function 'Step2Pos'
-MatrixStr ReadProperties(const char* fileinput, const string& defvalue, const int num_fields) {
-	VectorStr Values(Step2Pos(SLength) + num_fields + 1), Header(0);
-	MatrixStr output(0);
-	char* t_read;
-	string t2_read;
-	char line[CHAR_LINE];
-	int i = 0, j = 0;
+// Positions filled by a step of a properties file ('const', 'y1', 'm2', etc.),
+// from 'num_fields' (first step) to 'num_values' (excluded)
+vector<int> StepPositions(const string& mystep, const int num_fields, const int num_values) {
+	vector<int> output(0);
+	if (mystep == "const") {
+		for (int m = num_fields; m < num_values; m++) output.push_back(m);
+	} else {
+		Step Temp_Step = Str2Step(mystep);
+		if (Temp_Step[0] == 0) {
+			// Step is smaller than a year (to repeat monthly data, etc.)
+			Step Temp_Begin(SName.size(), 0);
+			bool zeros = true;
+			for (int l = 0; (l < SName.size()) & zeros; ++l) {
+				if (Temp_Step[l] == 0)
+					Temp_Begin[l] = 1;
+				else
+					zeros = false;
+			}
+			while (Temp_Begin < SLength) {
+				output.push_back(Step2Pos(StepSum(Temp_Step, Temp_Begin)) + num_fields);
+				Temp_Begin = NextStep(Temp_Begin);
+			}
+		} else if (Temp_Step[0] > 0) {
+			// Step with year
+			int a = Step2Pos(Temp_Step) + num_fields;
+			int b = Step2Pos(NextStep(Temp_Step)) + num_fields;
+			for (int m = a; (m < b) && (m < num_values); m++) output.push_back(m);
+		}
+	}
+	return output;
+}
+
+// Positions of a line of properties that are given by each column of the header.
+// The first 'num_fields' columns are skipped (as codes), the rest are steps.
+static vector< vector<int> > HeaderPositions(const CsvReader& file, const int num_fields, const int num_values) {
+	// Empty columns of the header are skipped
+	VectorStr Header = Tokens(file);
+	if (Header.size() > num_fields)
+		Header.erase(Header.begin(), Header.begin() + num_fields);
+	else
+		Header.clear();
 	
-	FILE *file = fopen(fileinput, "r");
-	if (file != NULL) {
-		for (;;) {
-			// Read a line from the file and finish if empty is read
-			if (fgets(line, sizeof line, file) == NULL)
-				break;
-			
-			// Remove comments and end of line characters
-			CleanLine(line);
-			
-			// Avoid line comments
-			if ((line[0]!='%') && (line[0]!='\0')) {
-				if (i==0) {
-					// Read column headers and store them
-					i++;
-					
-					// Skip first 'num_fields' columns
-					t_read = strtok(line,",");
-					for (int k=0; k < num_fields; k++) {
-						t_read = strtok(NULL, ",");
-						j++;
-					}
-					
-					while (t_read != NULL) {
-						Header.push_back(t_read);
-						t_read = strtok(NULL, ",");
-						j++;
-					}
+	vector< vector<int> > output(Header.size());
+	for (unsigned int h = 0; h < Header.size(); ++h)
+		output[h] = StepPositions(Header[h], num_fields, num_values);
+	return output;
+}
+
+// Read the lines of a properties file (see 'ReadProperties')
+static void ParseProperties(CsvReader& file, const string& defvalue, const int num_fields, MatrixStr& output, MatrixNum* numbers) {
+	int num_values = Step2Pos(SLength) + num_fields + 1;
+	VectorStr Values((numbers == NULL) ? num_values : num_fields);
+	VectorNum Numbers((numbers == NULL) ? 0 : num_values, NAN);
+	double defnumber = Str2Num(defvalue);
+	vector< vector<int> > Positions(0);
+	bool header = true;
+	
+	while (file.NextLine()) {
+		// Avoid line comments
+		if ((file.First() == '%') || (file.First() == '\0')) continue;
+		
+		if (header) {
+			// Read column headers and find the positions they fill
+			Positions = HeaderPositions(file, num_fields, num_values);
+			header = false;
+			continue;
+		}
+		
+		// A line of properties is stored here
+		if (numbers == NULL) {
+			for (unsigned int m = num_fields; m < Values.size(); m++) Values[m] = defvalue;
+		} else {
+			for (unsigned int m = num_fields; m < Numbers.size(); m++) Numbers[m] = defnumber;
+		}
+		
+		for (int k = 0; k < file.size(); k++) {
+			if (k < num_fields) {
+				Values[k] = file.Get(k);
+			} else if ((file.Length(k) != 0) && (k - num_fields < Positions.size())) {
+				const vector<int>& target = Positions[k-num_fields];
+				if (numbers == NULL) {
+					string value = file.Get(k);
+					for (unsigned int m = 0; m < target.size(); m++) Values[target[m]] = value;
 				} else {
-					// A line of properties is stored here
-					VectorStr temp_read(j);
-					const char *str = line;
-					const char *delims = ",";
-					int k = 0;
-					
-					for (unsigned int m = num_fields; m < Values.size(); m++) Values[m] = defvalue;
-					
-					size_t start = 0;
-					
-					while (str[start] != '\0') {
-						size_t end = strcspn(str + start, delims);
-						t2_read = string(line).substr(start,end);
-						
-						if (k < num_fields) {
-							Values[k] = t2_read;
-						} else if (end != 0) {
-							if (Header[k-num_fields] == "const") {
-								for (unsigned int m = num_fields; m < Values.size(); m++)  Values[m] = t2_read;
-							} else {
-								Step Temp_Step = Str2Step(Header[k-num_fields]);
-								if (Temp_Step[0] == 0) {
-									// Step is smaller than a year (to repeat monthly data, etc.)
-									Step Temp_Begin(SName.size(), 0);
-									bool zeros = true;
-									for (int l = 0; (l < SName.size()) & zeros; ++l) {
-										if (Temp_Step[l] == 0)
-											Temp_Begin[l] = 1;
-										else
-											zeros = false;
-									}
-									while (Temp_Begin < SLength) {
-										int m = Step2Pos(StepSum(Temp_Step, Temp_Begin)) + num_fields;
-										Values[m] = t2_read;
-										Temp_Begin = NextStep(Temp_Begin);
-									}
-								} else if (Temp_Step[0] > 0) {
-									// Step with year
-									int a = Step2Pos(Temp_Step) + num_fields;
-									int b = Step2Pos(NextStep(Temp_Step)) + num_fields;
-									for (int m = a; (m < b) && (m < Values.size()); m++)  Values[m] = t2_read;
-								}
-							}
-						}
-						start += (str[start + end] != '\0') ? end + 1 : end;
-						k++;
-					}
-					output.push_back(Values);
+					double value = Str2Num(file.Get(k));
+					for (unsigned int m = 0; m < target.size(); m++) Numbers[target[m]] = value;
 				}
 			}
 		}
-		fclose(file);
-	} else printError("warning", fileinput);
+		output.push_back(Values);
+		if (numbers != NULL) numbers->push_back(Numbers);
+	}
+}
+
+// Read properties file and store it in a matrix of strings.
+// The first 'num_fields' columns are copied and not touched.
+// The rest of the columns correspond to the different 'Steps' as determined by the function 'Step2Pos'
+// If 'matcher' is given, it's prepared to find rows in the matrix by code.
+// If 'numbers' is given, the values are stored there as numbers (see 'Str2Num')
+// and only the first 'num_fields' columns are kept in the matrix of strings.
+MatrixStr ReadProperties(const char* fileinput, const string& defvalue, const int num_fields, CodeMatcher* matcher, MatrixNum* numbers) {
+	MatrixStr output(0);
+	CsvReader file;
+	if (file.Open(fileinput))
+		ParseProperties(file, defvalue, num_fields, output, numbers);
+	else printError("warning", fileinput);
+	if (matcher != NULL) matcher->Build(output, num_fields);
 	return output;
 }
 
+// Files read at the same time by 'ReadPropertyFiles'
+struct PropertyJob {
+	const vector<PropertyFile>* files;
+	CsvReader* readers;
+	vector<bool>* opened;
+	vector<double> *wall, *cpu;
+	int next;
+	pthread_mutex_t lock;
+};
+
+void* ReadPropertyBlocks(void* arg) {
+	PropertyJob* job = (PropertyJob*) arg;
+	for (;;) {
+		pthread_mutex_lock(&job->lock);
+		int f = job->next++;
+		pthread_mutex_unlock(&job->lock);
+		if (f >= job->files->size()) break;
+		
+		const PropertyFile& myfile = (*job->files)[f];
+		double startwall = WallTime(), startcpu = ThreadCpuTime();
+		myfile.text->clear();
+		if (myfile.numbers != NULL) myfile.numbers->clear();
+		if ((*job->opened)[f])
+			ParseProperties(job->readers[f], myfile.defvalue, myfile.num_fields, *myfile.text, myfile.numbers);
+		if (myfile.matcher != NULL) myfile.matcher->Build(*myfile.text, myfile.num_fields);
+		job->readers[f].Close();
+		(*job->wall)[f] += WallTime() - startwall;
+		(*job->cpu)[f] += ThreadCpuTime() - startcpu;
+	}
+	return NULL;
+}
+
+// Read several properties files with 'nthreads' threads, one file at a time
+// for each thread. Files are opened in order first, so warnings keep their
+// order. With --profile, the time of each file is added to the current phase.
+void ReadPropertyFiles(const vector<PropertyFile>& files, const int nthreads) {
+	CsvReader* readers = new CsvReader[files.size()];
+	vector<bool> opened(files.size(), false);
+	vector<double> wall(files.size(), 0), cpu(files.size(), 0);
+	for (unsigned int f = 0; f < files.size(); ++f) {
+		double startwall = WallTime(), startcpu = ThreadCpuTime();
+		opened[f] = readers[f].Open(files[f].name.c_str());
+		if (!opened[f]) printError("warning", files[f].name.c_str());
+		wall[f] = WallTime() - startwall;
+		cpu[f] = ThreadCpuTime() - startcpu;
+	}
+	
+	PropertyJob job;
+	job.files = &files;
+	job.readers = readers;
+	job.opened = &opened;
+	job.wall = &wall;
+	job.cpu = &cpu;
+	job.next = 0;
+	pthread_mutex_init(&job.lock, NULL);
+	if (nthreads > 1) {
+		vector<pthread_t> threads(nthreads);
+		for (int i = 0; i < nthreads; ++i)
+			pthread_create(&threads[i], NULL, ReadPropertyBlocks, &job);
+		for (int i = 0; i < nthreads; ++i)
+			pthread_join(threads[i], NULL);
+	} else {
+		ReadPropertyBlocks(&job);
+	}
+	pthread_mutex_destroy(&job.lock);
+	delete[] readers;
+	
+	if (Profile.detailed)
+		for (unsigned int f = 0; f < files.size(); ++f)
+			Profile.Add(files[f].name, wall[f], cpu[f], files[f].text->size());
+}
+
 // Read Node list and store it in a vector of 'Nodes' (only 'ShortCode' is stored)
 vector<Node> ReadListNodes(const char* fileinput) {
 	vector<Node> output(0);
-	char* t_read;
-	char line[CHAR_LINE];
+	CsvReader file;
 	int i = 0;
 	
-	FILE *file = fopen(fileinput, "r");
-	if (file != NULL) {
-		for (;;) {
-			// Read a line from the file and finish if empty is read
-			if (fgets(line, sizeof line, file) == NULL)
-				break;
-			
-			// Remove comments and end of line characters
-			CleanLine(line);
-			
+	if (file.Open(fileinput)) {
+		while (file.NextLine()) {
 			// Skip first line
-			if ((i!=0 && line[0]!='%') && (line[0]!='\0')) {
+			if ((i!=0 && file.First()!='%') && (file.First()!='\0')) {
+				VectorStr t_read = Tokens(file);
 				Node Temp_Node;
-				t_read = strtok(line,",");
-				Temp_Node.Set("ShortCode", string(t_read));
+				Temp_Node.Set(NSlot.ShortCode, t_read[0]);
 				output.push_back(Temp_Node);
 			}
 			i++;
 		}
-		fclose(file);
 	} else printError("error", fileinput);
 	return output;
 }
@@ -325,39 +404,19 @@ vector<Node> ReadListNodes(const char* fileinput) {
 MatrixStr ReadStep(const char* fileinput) {
 	MatrixStr output(0);
 	VectorStr Temp_Vector(2);
-	//char* t_read;
-	char line[CHAR_LINE];
+	CsvReader file;
 	int i = 0;
 
-	FILE *file = fopen(fileinput, "r");
-	if (file != NULL) {
-		for (;;) {
-			// Read a line from the file and finish if empty is read
-			if (fgets(line, sizeof line, file) == NULL)
-				break;
-			
-			// Remove newline character
-			CleanLine(line);
-			
+	if (file.Open(fileinput)) {
+		while (file.NextLine()) {
 			// Skip first line, then read the rest
-			if ((i!=0) && (line[0]!='%') && (line[0]!='\0')) {
-				const char *str = line;
-				const char *delims = ",";
-				int k = 0;
-				size_t start = 0;
-				
-				while (k < 2) {
-					size_t end = strcspn(str + start, delims);
-					Temp_Vector[k] = string(line).substr(start,end);
-					start += (str[start + end] != '\0') ? end + 1 : end;
-					k++;
-				}
-				
+			if ((i!=0) && (file.First()!='%') && (file.First()!='\0')) {
+				for (int k = 0; k < 2; k++)
+					Temp_Vector[k] = (k < file.size()) ? file.Get(k) : "";
 				output.push_back(Temp_Vector);
 			}
 			i++;
 		}
-		fclose(file);
 	} else printError("warning", fileinput);
 	return output;
 }
@@ -365,27 +424,17 @@ MatrixStr ReadStep(const char* fileinput) {
 // Read Arc list and store in a vector of 'Arcs' (Only 'From' and 'To' codes are stored)
 vector<Arc> ReadListArcs(const char* fileinput) {
 	vector<Arc> output(0);
-	char* t_read;
-	char line[CHAR_LINE];
+	CsvReader file;
 	int i = 0;
 	
-	FILE *file = fopen(fileinput, "r");
-	if (file != NULL) {
-		for (;;) {
-			// Read a line from the file and finish if empty is read
-			if (fgets(line, sizeof line, file) == NULL)
-				break;
-			
-			// Remove comments and end of line characters
-			CleanLine(line);
-			
+	if (file.Open(fileinput)) {
+		while (file.NextLine()) {
 			// Skip first line, then read the rest
-			if ((i!=0) && (line[0]!='%') && (line[0]!='\0')) {
+			if ((i!=0) && (file.First()!='%') && (file.First()!='\0')) {
+				VectorStr t_read = Tokens(file);
 				Arc Temp_Arc;
-				t_read = strtok(line,",");
-				Temp_Arc.Set("From", string(t_read));
-				t_read = strtok(NULL,",");
-				Temp_Arc.Set("To", string(t_read));
+				Temp_Arc.Set(ASlot.From, t_read[0]);
+				Temp_Arc.Set(ASlot.To, (t_read.size() > 1) ? t_read[1] : "");
 				output.push_back(Temp_Arc);
 				if (Temp_Arc.isBidirect()) {
 					Arc Temp_Arc2(Temp_Arc, true);
@@ -394,168 +443,168 @@ vector<Arc> ReadListArcs(const char* fileinput) {
 			}
 			i++;
 		}
-		fclose(file);
 	} else { printError("error", fileinput); }
 	return output;
 }
 
-// Read and create transportation network
+// Fleets of the transportation network, as the bits of a mask (in the order
+// of 'TransInfra')
+typedef unsigned long long FleetMask;
+#define MAX_FLEETS 64
+
+// Read and create transportation network. Fleets that no commodity can use
+// (and infrastructures with only those fleets) can't have any flow, so their
+// capacity arcs are skipped if 'usePruneFleets' is set. That changes the
+// NSGA-II variables (idx_nsga.csv and param.in), so it's off by default.
 void ReadTrans(vector<Node>& Nodes, vector<Arc>& Arcs, const char* fileinput) {
-	// Create default nodes and arcs
+	// Nodes and arcs created for each line of the file: codes, and fleets
+	// that the line must allow for them to be created
 	vector<string> DefNodes(0), DefFrom(0), DefTo(0), DefInf(0);
+	vector<FleetMask> NodeFleets(0), ArcFleets(0);
 	Node TempNode;
 	Arc TempArc;
-	int NInfra = TransInfra.size(), NFleet = 0, NComm = TransComm.size(), k = 0;
-	string Infra = "", Fleet = "", FleetInf = "", Comm = "", Coal = "";
+	string Fleet = "", FleetInf = "";
 	
-	// Determine the number of fleet
-	for (unsigned int i = 0; i < NInfra; ++i)
-		NFleet += TransInfra[i].size()-1;
+	// Determine the fleets
+	for (unsigned int i = 0; i < TransInfra.size(); ++i) {
+		for (unsigned int j = 1; j < TransInfra[i].size(); ++j) {
+			Fleet.push_back(TransInfra[i][j]);
+			FleetInf.push_back(TransInfra[i][0]);
+		}
+	}
+	if (Fleet.size() > MAX_FLEETS) {
+		printError("parameter", "TransInfra");
+		return;
+	}
+	FleetMask AllFleets = 0;
+	vector<FleetMask> Letter(256, 0);
+	for (int k = Fleet.size() - 1; k >= 0; --k) {
+		Letter[(unsigned char) Fleet[k]] = ((FleetMask) 1) << k;
+		AllFleets |= ((FleetMask) 1) << k;
+	}
 	
-	vector< vector<bool> > NodeTable(0), ArcTable(0);
-	vector<bool> TableColumn(NFleet, false);
+	// Fleets that some commodity can use (the others can't have any flow)
+	FleetMask UsedFleets = usePruneFleets ? 0 : AllFleets;
+	for (unsigned int i = 0; i < TransComm.size(); ++i)
+		for (unsigned int j = 1; j < TransComm[i].size(); ++j)
+			UsedFleets |= Letter[(unsigned char) TransComm[i][j]];
+	for (unsigned int k = 0; k < Fleet.size(); ++k)
+		if (!(UsedFleets & (((FleetMask) 1) << k)) && (outputLevel < 3))
+			cout << "\tWarning: Fleet '" << Fleet[k] << "' isn't used by any commodity, so it's skipped\n";
 	
 	// For each line in the definition of infrastructures
-	for (unsigned int i = 0; i < NInfra; ++i) {
-		Infra.push_back(TransInfra[i][0]);
+	unsigned int k = 0;
+	for (unsigned int i = 0; i < TransInfra.size(); ++i) {
+		FleetMask InfraFleets = 0;
+		for (unsigned int j = 1; j < TransInfra[i].size(); ++j)
+			InfraFleets |= ((FleetMask) 1) << (k + j - 1);
 		
 		// Create an arc (for infrastructure capacity constraints)
-		DefFrom.push_back(TransInfra[i].substr(0,1) + TransInfra[i].substr(0,1));
-		DefTo.push_back("XX");
-		DefInf.push_back("");
-		ArcTable.push_back(TableColumn);
+		if (InfraFleets & UsedFleets) {
+			DefFrom.push_back(TransInfra[i].substr(0,1) + TransInfra[i].substr(0,1));
+			DefTo.push_back("XX");
+			DefInf.push_back("");
+			ArcFleets.push_back(InfraFleets & UsedFleets);
+		}
 		
 		// For each fleet within that infrastructure
-		for (unsigned int j = 1; j < TransInfra[i].size(); ++j) {
+		for (unsigned int j = 1; j < TransInfra[i].size(); ++j, ++k) {
 			// Create an arc (for fleet capacity constraints)
-			DefFrom.push_back(TransInfra[i].substr(j,1) + TransInfra[i].substr(j,1));
-			DefTo.push_back("XX");
-			DefInf.push_back("");
-			ArcTable.push_back(TableColumn);
-			
-			Fleet.push_back(TransInfra[i][j]);
-			FleetInf.push_back(TransInfra[i][0]);
-			
-			ArcTable[ArcTable.size()-1][k] = true;
-			ArcTable[ArcTable.size()-j-1][k] = true;
-			k++;
+			if (UsedFleets & (((FleetMask) 1) << k)) {
+				DefFrom.push_back(TransInfra[i].substr(j,1) + TransInfra[i].substr(j,1));
+				DefTo.push_back("XX");
+				DefInf.push_back("");
+				ArcFleets.push_back(((FleetMask) 1) << k);
+			}
 		}
 	}
 	
 	// For each commodity
-	for (unsigned int i = 0; i < NComm; ++i) {
-		Comm.push_back(TransComm[i][0]);
+	for (unsigned int i = 0; i < TransComm.size(); ++i) {
 		DefNodes.push_back(TransComm[i].substr(0,1) + "T");
-		NodeTable.push_back(TableColumn);
+		NodeFleets.push_back(0);
 		
 		for (unsigned int j = 1; j < TransComm[i].size(); ++j) {
 			// Find for each fleet that the commodity can use
-			k = Fleet.find(TransComm[i][j]);
-			if (k >= 0) {
+			int kk = Fleet.find(TransComm[i][j]);
+			if (kk >= 0) {
 				// Create arc
-				DefFrom.push_back(Fleet.substr(k,1) + Fleet.substr(k,1));
+				DefFrom.push_back(Fleet.substr(kk,1) + Fleet.substr(kk,1));
 				DefTo.push_back(TransComm[i].substr(0,1) + "T");
-				DefInf.push_back(FleetInf.substr(k,1) + FleetInf.substr(k,1));
-				ArcTable.push_back(TableColumn);
-				
-				ArcTable[ArcTable.size()-1][k] = true;
-				NodeTable[NodeTable.size()-1][k] = true;
+				DefInf.push_back(FleetInf.substr(kk,1) + FleetInf.substr(kk,1));
+				ArcFleets.push_back(((FleetMask) 1) << kk);
+				NodeFleets.back() |= ((FleetMask) 1) << kk;
 			}
 		}
 	}
 	
-	char* t_read;
-	char line[CHAR_LINE];
+	// Codes of the nodes, to find if the coal nodes exist
+	set<string> NodeCodes;
+	for (unsigned int k2 = 0; k2 < Nodes.size(); ++k2)
+		NodeCodes.insert(Nodes[k2].Get(NSlot.ShortCode));
+	
+	CsvReader file;
 	int i = 0;
 	
-	TempNode.Set("Step", TransStep);
-	TempArc.Set("FromStep", TransStep);
-	TempArc.Set("ToStep", TransStep);
+	TempNode.Set(NSlot.Step, TransStep);
+	TempArc.Set(ASlot.FromStep, TransStep);
+	TempArc.Set(ASlot.ToStep, TransStep);
 	
-	FILE *file = fopen(fileinput, "r");
-	if (file != NULL) {
-		for (;;) {
-			// Read a line from the file and finish if empty is read
-			if (fgets(line, sizeof line, file) == NULL)
-				break;
-			
-			// Remove comments and end of line characters
-			CleanLine(line);
+	if (file.Open(fileinput)) {
+		while (file.NextLine()) {
+			VectorStr t_read = Tokens(file);
 			
 			// Skip first line, then read the rest
-			if (i!=0) {
-				string from, to, fleetlist, swap;
-				vector<bool> ShowNode(NodeTable.size(), false), ShowArc(ArcTable.size(), false);
-				int kk, swapindex;
+			if ((i!=0) && (t_read.size() >= 3)) {
+				string from, to, swap;
+				int swapindex;
 				
 				// Read from and to codes
-				t_read = strtok(line,",");
-				from = string(t_read);
-				t_read = strtok(NULL,",");
-				to = string(t_read);
+				from = t_read[0];
+				to = t_read[1];
 				
 				// Distance
-				t_read = strtok(NULL,",");
-				TempArc.Set("Distance", string(t_read));
+				TempArc.SetDouble(ASlot.Distance, Str2Num(t_read[2]));
 				
-				// Read allowed fleet and determine what nodes and arcs will be appropriate
-				t_read = strtok(NULL,",");
-				if (t_read == '\0') {
-					fleetlist = "";
-					
-					for (unsigned int k1 = 0; k1 < ShowNode.size(); ++k1) ShowNode[k1] = true;
-					for (unsigned int k1 = 0; k1 < ShowArc.size(); ++k1) ShowArc[k1] = true;
-				} else {
-					fleetlist = string(t_read);
-					
-					for (unsigned int k1 = 0; k1 < ShowNode.size(); ++k1) ShowNode[k1] = false;
-					for (unsigned int k1 = 0; k1 < ShowArc.size(); ++k1) ShowArc[k1] = false;
-					for (unsigned int k2 = 0; k2 < fleetlist.size(); ++k2) {
-						kk = Fleet.find(fleetlist[k2]);
-						if (kk >=0) {
-							for (unsigned int k1 = 0; k1 < ShowNode.size(); ++k1) ShowNode[k1] = ShowNode[k1] || NodeTable[k1][kk];
-							for (unsigned int k1 = 0; k1 < ShowArc.size(); ++k1) ShowArc[k1] = ShowArc[k1] || ArcTable[k1][kk];
-						}
-					}
+				// Read allowed fleet (all of them if there's no list)
+				FleetMask LineFleets = AllFleets;
+				if (t_read.size() >= 4) {
+					LineFleets = 0;
+					for (unsigned int k2 = 0; k2 < t_read[3].size(); ++k2)
+						LineFleets |= Letter[(unsigned char) t_read[3][k2]];
 				}
 				
 				// To account for both directions and avoid repetitions
 				swapindex = 0;
 				
 				while ((swapindex==0) || ((swapindex==1) && (from!=to))) {
-					for (unsigned int k1 = 0; k1 < ShowNode.size(); ++k1) {
-						if (ShowNode[k1]) {
-							TempNode.Set("ShortCode", DefNodes[k1] + from + to);
+					for (unsigned int k1 = 0; k1 < DefNodes.size(); ++k1) {
+						if (NodeFleets[k1] & LineFleets) {
+							TempNode.Set(NSlot.ShortCode, DefNodes[k1] + from + to);
 							Nodes.push_back(TempNode);
+							NodeCodes.insert(DefNodes[k1] + from + to);
 							
 							//Coal to transportation
 							if ((swapindex==0) && (from!=to) && (DefNodes[k1]!=TransDummy) && (DefNodes[k1][1]=='T')) {
-								kk = TransCoal.find(DefNodes[k1][0]);
+								int kk = TransCoal.find(DefNodes[k1][0]);
 								if (kk >= 0) {
 									// Check if nodes exist, if not it creates it
-									bool fromexists = false, toexists = false;
-									for (unsigned int k2 = 0; k2 < Nodes.size(); ++k2) {
-										if (Nodes[k2].Get("ShortCode") == DefNodes[k1] + from)
-											fromexists = true;
-										else if (Nodes[k2].Get("ShortCode") == DefNodes[k1] + to)
-											toexists = true;
-									}
-									if (!fromexists) {
-										TempNode.Set("ShortCode", DefNodes[k1] + from);
+									if (NodeCodes.insert(DefNodes[k1] + from).second) {
+										TempNode.Set(NSlot.ShortCode, DefNodes[k1] + from);
 										Nodes.push_back(TempNode);
 									}
-									if (!toexists) {
-										TempNode.Set("ShortCode", DefNodes[k1] + to);
+									if (NodeCodes.insert(DefNodes[k1] + to).second) {
+										TempNode.Set(NSlot.ShortCode, DefNodes[k1] + to);
 										Nodes.push_back(TempNode);
 									}
 									
 									// Create arcs for coal transportation
 									TempArc.Set("Energy2Trans", true);
-									TempArc.Set("From", DefNodes[k1] + from);
-									TempArc.Set("To", DefNodes[k1] + to);
+									TempArc.Set(ASlot.From, DefNodes[k1] + from);
+									TempArc.Set(ASlot.To, DefNodes[k1] + to);
 									Arcs.push_back(TempArc);
-									TempArc.Set("From", DefNodes[k1] + to);
-									TempArc.Set("To", DefNodes[k1] + from);
+									TempArc.Set(ASlot.From, DefNodes[k1] + to);
+									TempArc.Set(ASlot.To, DefNodes[k1] + from);
 									Arcs.push_back(TempArc);
 									TempArc.Set("Energy2Trans", false);
 								}
@@ -563,11 +612,11 @@ void ReadTrans(vector<Node>& Nodes, vector<Arc>& Arcs, const char* fileinput) {
 						}
 					}
 					
-					for (unsigned int k1 = 0; k1 < ShowArc.size(); ++k1) {
-						if (ShowArc[k1]) {
-							TempArc.Set("From", DefFrom[k1] + from + to);
-							TempArc.Set("To", DefTo[k1] + from + to);
-							TempArc.Set("TransInfr", DefInf[k1]);
+					for (unsigned int k1 = 0; k1 < DefFrom.size(); ++k1) {
+						if (ArcFleets[k1] & LineFleets) {
+							TempArc.Set(ASlot.From, DefFrom[k1] + from + to);
+							TempArc.Set(ASlot.To, DefTo[k1] + from + to);
+							TempArc.Set(ASlot.TransInfr, DefInf[k1]);
 							Arcs.push_back(TempArc);
 						}
 					}
@@ -579,7 +628,6 @@ void ReadTrans(vector<Node>& Nodes, vector<Arc>& Arcs, const char* fileinput) {
 			}
 			i++;
 		}
-		fclose(file);
 	} else { printError("error", fileinput); }
 }
 
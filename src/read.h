@@ -10,12 +10,24 @@
 
 #include "node.h"
 #include "arc.h"
+#include "matcher.h"
+
+// Properties file to be read by 'ReadPropertyFiles' (the arguments of 'ReadProperties')
+struct PropertyFile {
+	string name, defvalue;
+	int num_fields;
+	MatrixStr* text;
+	MatrixNum* numbers;
+	CodeMatcher* matcher;
+};
 
 void ReadParameters(const char* fileinput);
 vector<Node> ReadListNodes(const char* fileinput);
 vector<Arc> ReadListArcs(const char* fileinput);
 MatrixStr ReadStep(const char* fileinput);
-MatrixStr ReadProperties(const char* fileinput, const string& defvalue, const int num_fields);
+vector<int> StepPositions(const string& mystep, const int num_fields, const int num_values);
+MatrixStr ReadProperties(const char* fileinput, const string& defvalue, const int num_fields, CodeMatcher* matcher = NULL, MatrixNum* numbers = NULL);
+void ReadPropertyFiles(const vector<PropertyFile>& files, const int nthreads);
 void ReadTrans(vector<Node>& Nodes, vector<Arc>& Arcs, const char* fileinput);
 void ReadEvents(double output[], const char* fileinput);
 
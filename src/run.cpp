@@ -0,0 +1,70 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    run.cpp - Preprocessing and optimizing a problem in one process
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+using namespace std;
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "netscore.h"
+#include "curve.h"
+#include "pipeline.h"
+#include "solver.h"
+#include <sys/stat.h>
+#include <ilcplex/ilocplex.h>
+ILOSTLBEGIN
+
+int main () {
+	printHeader("run");
+	
+	cout << "- Reading global parameters...\n";
+	ReadParameters("data/parameters.csv");
+	mkdir("./prepdata", 0777);
+	
+	// Only the solution is written to prepdata/, so there is nothing to
+	// reuse from a previous preprocessor run
+	useIncrementalPrep = false;
+	
+	// Set output level so that Benders steps are reported on screen
+	if (outputLevel == 2) outputLevel = 1;
+	
+	// Read the inputs and expand nodes and arcs through all the steps. The
+	// indices are filled here instead of imported from prepdata/idx_*.csv
+	PrepData Data;
+	ReadInputs(Data);
+	ExpandNetwork(Data);
+	
+	cout << endl << "- Building model..." << endl;
+	ModelBuilder model(SLength[0]+1);
+	BuildModel(Data, model);
+	IndexStarts();
+	
+	// Vector of capacity losses for events (prepdata/bend_events.csv)
+	vector<double> events((SLength[0] + IdxCap.size) * (Nevents+1), 0);
+	PrepEvents(Data.Net, &events[0]);
+	Data.Net = ExpandedNetwork();
+	
+	// Hand the master and subproblems to the solver, which keeps its own copy
+	CPLEX netplan;
+	netplan.LoadProblem(&model);
+	model = ModelBuilder(0);
+	
+	// Solve problem
+	double objective[Nobj];
+	netplan.SolveIndividual(objective, &events[0], true);
+	
+	// Report solutions if the problem is feasible
+	if (objective[0] < 1.0e29)
+		WritePostFiles(netplan);
+	
+	cout << "- Values returned:" << endl;
+	for (int k = 0; k < Nobj; ++k)
+		cout << "\t" << objective[k] << endl;
+	
+	printHeader("completed");
+	return 0;
+}
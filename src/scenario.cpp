@@ -0,0 +1,154 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    scenario.cpp -- Implementation of the scenario batch preprocessing
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+using namespace std;
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "global.h"
+#include "node.h"
+#include "arc.h"
+#include "network.h"
+#include "model.h"
+#include "index.h"
+#include "cache.h"
+#include "read.h"
+#include "write.h"
+#include "csv.h"
+#include "curve.h"
+#include "pipeline.h"
+#include "scenario.h"
+
+// Exit codes of the process of each scenario
+#define SCENARIO_DONE 0
+#define SCENARIO_ERROR 1
+
+// Read the scenarios file
+vector<Scenario> ReadScenarios(const char* fileinput) {
+	vector<Scenario> output(0);
+	CsvReader file;
+	if (!file.Open(fileinput)) {
+		printError("error", fileinput);
+		return output;
+	}
+
+	bool header = true;
+	while (file.NextLine()) {
+		if ((file.First() == '%') || (file.First() == '\0')) continue;
+		if (header) {
+			header = false;
+			continue;
+		}
+		if ((file.size() < 3) || (file.Length(0) == 0) || (file.Length(1) == 0) || (file.Length(2) == 0)) continue;
+
+		string name = file.Get(0);
+		unsigned int k = 0;
+		while ((k < output.size()) && (output[k].name != name)) ++k;
+		if (k == output.size()) {
+			output.push_back(Scenario());
+			output[k].name = name;
+		}
+		output[k].files["data/" + file.Get(1)] = "data/" + file.Get(2);
+	}
+	return output;
+}
+
+// Preprocess one scenario (in its own process, so the base data can be
+// changed). Its prepdata/ is complete, but the files with the same contents
+// as the ones of the base are hard links to them.
+static int RunScenario(PrepData& Base, const PrepManifest& BaseOutputs, const Scenario& Case) {
+	string folder = "scenarios/" + Case.name;
+	mkdir(folder.c_str(), 0777);
+	mkdir((folder + "/prepdata").c_str(), 0777);
+	symlink("../../data", (folder + "/data").c_str());
+	if (freopen((folder + "/prep.log").c_str(), "w", stdout) == NULL) return SCENARIO_ERROR;
+	cout << "- Scenario '" << Case.name << "'" << endl;
+
+	// Only replaced properties files can be read on top of the base network,
+	// other files need the whole expansion
+	bool global = false;
+	for (map<string, string>::const_iterator it = Case.files.begin(); it != Case.files.end(); ++it) {
+		cout << "- Replacing '" << it->first << "' with '" << it->second << "'" << endl;
+		if (it->first == "data/parameters.csv") {
+			printError("parameter", it->first);
+			return SCENARIO_ERROR;
+		}
+		bool property = false;
+		for (unsigned int f = 0; f < Base.PropFiles.size(); ++f)
+			property = property || (Base.PropFiles[f].name == it->first);
+		global = global || !property;
+	}
+	PrepData* Data = &Base;
+	if (global) {
+		Data = new PrepData();
+		Data->files = Case.files;
+		ReadInputs(*Data);
+		ExpandNetwork(*Data);
+	} else {
+		Base.files = Case.files;
+		ExpandScenario(Base);
+	}
+
+	cout << endl << "- Building model..." << endl;
+	ModelBuilder model(SLength[0]+1);
+	BuildModel(*Data, model);
+
+	// The solver and the post-processors load all the files of prepdata/.
+	// The scenario folder has no files of a previous run of its own to keep.
+	if (chdir(folder.c_str()) != 0) return SCENARIO_ERROR;
+	remove("prepdata/delta.csv");
+	Data->incremental = false;
+	Data->BaseOutputs = BaseOutputs;
+	Data->BaseFolder = "../..";
+	WritePrepFiles(*Data, model);
+	return SCENARIO_DONE;
+}
+
+// Preprocess all the scenarios, a few processes at a time
+void RunScenarios(PrepData& Base, const ModelBuilder& BaseModel, const vector<Scenario>& Cases) {
+	int nprocs = (PrepThreads > 1) ? PrepThreads : 1;
+	cout << "- Preprocessing " << Cases.size() << " scenarios (" << nprocs << " processes)..." << endl;
+	mkdir("./scenarios", 0777);
+	PrepManifest BaseOutputs;
+	PrepOutputHashes(BaseModel, BaseOutputs);
+
+	map<pid_t, int> running;
+	unsigned int next = 0;
+	while ((next < Cases.size()) || !running.empty()) {
+		if ((next < Cases.size()) && (running.size() < nprocs)) {
+			// Anything still buffered would be printed by the child too
+			cout.flush();
+			fflush(stdout);
+			pid_t pid = fork();
+			if (pid == 0) {
+				// The scenarios already run in parallel
+				PrepThreads = 1;
+				int code = RunScenario(Base, BaseOutputs, Cases[next]);
+				fflush(stdout);
+				_exit(code);
+			}
+			if (pid < 0) cout << "\tERROR: Scenario '" << Cases[next].name << "' couldn't be started\n";
+			else running[pid] = next;
+			++next;
+			continue;
+		}
+
+		int status;
+		pid_t pid = wait(&status);
+		if (pid < 0) break;
+		const Scenario& Case = Cases[running[pid]];
+		running.erase(pid);
+		int code = WIFEXITED(status) ? WEXITSTATUS(status) : SCENARIO_ERROR;
+		if (code == SCENARIO_DONE) cout << "\t" << Case.name << ": full model in scenarios/" << Case.name << "/prepdata/ (unchanged files are links to prepdata/)\n";
+		else cout << "\tERROR: Scenario '" << Case.name << "' failed (see scenarios/" << Case.name << "/prep.log)\n";
+	}
+}
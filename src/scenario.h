@@ -0,0 +1,32 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    scenario.h -- Definition of the scenario batch preprocessing
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+#ifndef _SCENARIO_H_
+#define _SCENARIO_H_
+
+// Declare class type to store a scenario: a name and the input files it
+// replaces (both with their path, e.g. 'data/arcs_OpMax.csv')
+class Scenario {
+	public:
+		string name;
+		map<string, string> files;
+};
+
+// Read the scenarios file (lines 'scenario,input file,replacement', with
+// names relative to data/; a scenario may have several lines)
+vector<Scenario> ReadScenarios(const char* fileinput);
+
+// Preprocess every scenario from the base data set, which must have been
+// expanded with 'recordUses', built in 'BaseModel' and written to prepdata/.
+// The scenarios run in separate processes (up to 'PrepThreads' at a time)
+// and write their files in scenarios/<name>/: prep.log and prepdata/, a full
+// model with all the files that the solver loads. The model and index files
+// with the same contents as the base ones are hard links to them, so only
+// the blocks that changed take space.
+void RunScenarios(PrepData& Base, const ModelBuilder& BaseModel, const vector<Scenario>& Cases);
+
+#endif  // _SCENARIO_H_
@@ -0,0 +1,70 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    schema.cpp -- Implementation of the property schema
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+using namespace std;
+#include <iostream>
+#include <string>
+#include <vector>
+#include "global.h"
+
+// Contructor for the Schema class
+Schema::Schema() :
+	names(0), defaults(0), defcodes(0), numeric(0), slots(0), defvalues(0) {}
+
+// Declare a new property and return its slot
+int Schema::Add(const string& name, const string& defvalue, const bool isnum) {
+	int slot;
+	if (isnum) {
+		slot = defvalues.size();
+		defvalues.push_back(Str2Num(defvalue));
+	} else {
+		slot = defcodes.size();
+		defcodes.push_back(defvalue);
+	}
+	lookup[name] = names.size();
+	names.push_back(name);
+	defaults.push_back(defvalue);
+	numeric.push_back(isnum);
+	slots.push_back(slot);
+	return slot;
+}
+
+// Find a property (position in declaration order, -1 if not found)
+int Schema::Find(const string& name) const {
+	map<string, int>::const_iterator it = lookup.find(name);
+	return (it != lookup.end()) ? it->second : -1;
+}
+
+// Information about the property in position 'k'
+int Schema::size() const {
+	return names.size();
+}
+
+const string& Schema::Name(const int k) const {
+	return names[k];
+}
+
+const string& Schema::Default(const int k) const {
+	return defaults[k];
+}
+
+bool Schema::isNumeric(const int k) const {
+	return numeric[k];
+}
+
+int Schema::Slot(const int k) const {
+	return slots[k];
+}
+
+// Default values to initialize a new node or arc
+const vector<string>& Schema::DefaultCodes() const {
+	return defcodes;
+}
+
+const vector<double>& Schema::DefaultValues() const {
+	return defvalues;
+}
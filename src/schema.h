@@ -0,0 +1,45 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    schema.h -- Definition of the property schema
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+#ifndef _SCHEMA_H_
+#define _SCHEMA_H_
+
+#include <map>
+
+// Declare class type to resolve property names into storage slots.
+// Numeric properties are stored as doubles and string codes as text, each
+// one in its own vector. The slot is the position within that vector.
+class Schema {
+	public:
+		Schema();
+
+		// Declare a new property and return its slot
+		int Add(const string& name, const string& defvalue, const bool numeric);
+
+		// Find a property (position in declaration order, -1 if not found)
+		int Find(const string& name) const;
+
+		// Information about the property in position 'k'
+		int size() const;
+		const string& Name(const int k) const;
+		const string& Default(const int k) const;
+		bool isNumeric(const int k) const;
+		int Slot(const int k) const;
+
+		// Default values to initialize a new node or arc
+		const vector<string>& DefaultCodes() const;
+		const vector<double>& DefaultValues() const;
+
+	private:
+		vector<string> names, defaults, defcodes;
+		vector<bool> numeric;
+		vector<int> slots;
+		vector<double> defvalues;
+		map<string, int> lookup;
+};
+
+#endif  // _SCHEMA_H_
@@ -10,51 +10,140 @@ using namespace std;
 #include <fstream>
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <stdlib.h> // May 26 2013
+#include <math.h>
+#include <pthread.h>
 #include "global.h"
 #include "index.h"
 #include "read.h"
+#include "network.h"
+#include "model.h"
 #include "write.h"
 #include "solver.h"
 
 #define MAX_ITER 1000
 
-// Loads the problem from MPS files into memory
-void CPLEX::LoadProblem() {
+// Smallest dual of a master cut that is binding
+#define CUT_ACTIVE 1e-9
+
+// Years that share an optimality cut: all of them ("single"), each one
+// ("year") or groups of 'BendersCutGroup' consecutive years ("group")
+static int CutGroupSize() {
+	if (BendersCuts == "single") return SLength[0];
+	if ((BendersCuts == "group") && (BendersCutGroup > 1)) return BendersCutGroup;
+	return 1;
+}
+
+// Subproblems solved at the same time ('SubproblemWorkers', or as many as
+// the solver threads if it's 0), at most one per year
+static int SubproblemWorkerCount() {
+	int workers = (SubproblemWorkers > 0) ? SubproblemWorkers : SolverThreads;
+	if (workers > SLength[0]) workers = SLength[0];
+	return (workers > 1) ? workers : 1;
+}
+
+// Builds a problem from a binary model file. Rows are created first and then
+// each column is added to the objective and the rows at once.
+void ImportModelFile(IloEnv& env, IloModel& model, const ModelFile& file, IloObjective& obj, IloNumVarArray& var, IloRangeArray& rng) {
+	obj.setName(file.ObjectiveName());
+	model.add(obj);
+	
+	for (int r = 0; r < file.nrows; ++r) {
+		IloNum lb = (file.rowtype[r] == 'L') ? -IloInfinity : file.rhs[r];
+		IloNum ub = (file.rowtype[r] == 'G') ? IloInfinity : file.rhs[r];
+		rng.add(IloRange(env, lb, ub, file.RowName(r)));
+	}
+	model.add(rng);
+	
+	for (int c = 0; c < file.ncols; ++c) {
+		IloNumColumn column = obj(file.obj[c]);
+		for (int e = file.start[c]; e < file.start[c+1]; ++e)
+			column += rng[file.index[e]](file.value[e]);
+		IloNum lb = (file.lower[c] < -IloInfinity) ? -IloInfinity : file.lower[c];
+		IloNum ub = (file.upper[c] > IloInfinity) ? IloInfinity : file.upper[c];
+		var.add(IloNumVar(column, lb, ub, ILOFLOAT, file.ColumnName(c)));
+		column.end();
+	}
+	model.add(var);
+}
+
+// Loads the problem into memory, from binary model files if they are
+// available and from MPS files otherwise. With a model builder, the binary
+// model files are built in memory instead of read.
+void CPLEX::LoadProblem(const ModelBuilder* builder) {
 	cout << "- Reading problem..." << endl;
 	
 	try {
 		int nyears = SLength[0];
+		rowmap.assign(nyears+1, vector<int>(0));
+		colmap.assign(nyears+1, vector<int>(0));
+		fixed.assign(nyears+1, vector<double>(0));
+		LastBasis.cols.assign(nyears+1, vector<char>(0));
+		LastBasis.rows.assign(nyears+1, vector<char>(0));
+		
+		// Threads of the master problem and of each subproblem: the budget is
+		// split between the subproblems solved at the same time. Without a
+		// budget CPLEX chooses, unless several subproblems are solved at the
+		// same time (one thread each).
+		int workers = SubproblemWorkerCount(), subthreads = 0;
+		if (SolverThreads > 0)
+			subthreads = (SolverThreads / workers > 1) ? SolverThreads / workers : 1;
+		else if (workers > 1)
+			subthreads = 1;
 		
+		envs.assign(1, env);
 		for (int i=0; i <= nyears; ++i) {
-			model.add(IloModel(env));
-			cplex.add (IloCplex(env));
-			obj.add(IloObjective(env));
-			var.add(IloNumVarArray(env));
-			rng.add(IloRangeArray(env));
-			dualsolution.add(IloNumArray(env));
-			TempNumArray.add(IloNumArray(env));
+			if (i > 0) envs.push_back(IloEnv());
+			model.add(IloModel(envs[i]));
+			cplex.add (IloCplex(envs[i]));
+			obj.add(IloObjective(envs[i]));
+			var.add(IloNumVarArray(envs[i]));
+			rng.add(IloRangeArray(envs[i]));
+			if ((i == 0) && (SolverThreads > 0))
+				cplex[i].setParam(IloCplex::Threads, SolverThreads);
+			else if ((i > 0) && (subthreads > 0))
+				cplex[i].setParam(IloCplex::Threads, subthreads);
 		}
+		dualsolution.assign(Nevents+1, vector<double>());
 		
-		// Read MPS files
+		// Read model files
 		for (int i=0; i <= nyears; ++i) {
 			string file_name = "";
 			if (!useBenders && (i == 0)) {
-				file_name = "prepdata/netscore.mps";
+				file_name = "prepdata/netscore";
 			} else {
-				file_name = "prepdata/bend_" + ToString<int>(i) + ".mps";
+				file_name = "prepdata/bend_" + ToString<int>(i);
 			}
 			if (i!=0) {
 				//cplex[i].setParam(IloCplex::PreInd, 0);
 				//cplex[i].setParam(IloCplex::ScaInd, -1);
 				cplex[i].setParam(IloCplex::RootAlg, IloCplex::Dual);
 			}
+			
+			ModelFile binary;
+			bool isbinary = true;
+			if (builder != NULL) {
+				binary.Build(*builder, (!useBenders && (i == 0)) ? -1 : i, useModelReduction);
+				file_name += " (memory)";
+			} else {
+				isbinary = binary.Open((file_name + ".bin").c_str());
+				file_name += isbinary ? ".bin" : (useCompressMPS ? ".mps.gz" : ".mps");
+			}
 			if (outputLevel > 0) {
-				cplex[i].setOut(env.getNullStream());
+				cplex[i].setOut(envs[i].getNullStream());
 			} else {
 				cout << "Reading " << file_name << endl;
 			}
-			cplex[i].importModel(model[i], file_name.c_str(), obj[i], var[i], rng[i]);
+			if (isbinary)
+				ImportModelFile(envs[i], model[i], binary, obj[i], var[i], rng[i]);
+			else
+				cplex[i].importModel(model[i], file_name.c_str(), obj[i], var[i], rng[i]);
+			if (isbinary && (binary.fullcols > 0)) {
+				rowmap[i].assign(binary.rowmap, binary.rowmap + binary.fullrows);
+				colmap[i].assign(binary.colmap, binary.colmap + binary.fullcols);
+				fixed[i].assign(binary.fixed, binary.fixed + binary.fullcols);
+			}
 			
 			// Extract models
 			cplex[i].extract(model[i]);
@@ -66,6 +155,25 @@ void CPLEX::LoadProblem() {
 	}
 }
 
+// Write the solution in prepdata/post_*.csv
+void WritePostFiles(CPLEX& netplan) {
+	vector<string> solstring(netplan.SolutionString());
+	WriteOutput("prepdata/post_emissions.csv", IdxEm, solstring, "% Emissions");
+	WriteOutput("prepdata/post_node_rm.csv", IdxRm, solstring, "% Reserve margins");
+	WriteOutput("prepdata/post_arc_inv.csv", IdxInv, solstring, "% Investments");
+	WriteOutput("prepdata/post_arc_cap.csv", IdxCap, solstring, "% Capacity");
+	WriteOutput("prepdata/post_arc_flow.csv", IdxArc, solstring, "% Arc flows");
+	WriteOutput("prepdata/post_node_ud.csv", IdxUd, solstring, "% Demand not served at nodes");
+	WriteOutput("prepdata/post_node_dc.csv", IdxDc, solstring, "% Node power flow angles"); // Feb 21 2013
+	WriteOutput("prepdata/post_node_ho.csv", IdxHo, solstring, "% Horizon objective end effects"); // Feb 21 2013
+	
+	for (int i=0; i <= Nevents; ++i) {
+		vector<string> dualstring(netplan.SolutionDualString(i));
+		string file_name = "prepdata/post_nodal_dual_e" + ToString<int>(i) + ".csv";
+		WriteOutput(file_name.c_str(), IdxNode, dualstring, "% Dual variable at demand nodes");
+	}
+}
+
 // Solves current model
 void CPLEX::SolveIndividual(double *objective, const double events[], const bool saveDual, string *returnString) {
 	int nyears = SLength[0];
@@ -75,6 +183,10 @@ void CPLEX::SolveIndividual(double *objective, const double events[], const bool
 		bool optimal = true;
 		int iter = 0;
 		
+		// Start from the bases of the closest individual solved before
+		if ((BasisStore > 0) && !BasisKey.empty())
+			RestoreBases();
+		
 		if (!useBenders) {
 			// Only one file
 			if (outputLevel < 2) cout << "- Solving problem" << endl;
@@ -90,16 +202,23 @@ void CPLEX::SolveIndividual(double *objective, const double events[], const bool
 				optimal = false;
 			}
 		} else {
-			// Use Benders decomposition
-			int OptCuts = 1, FeasCuts = 1;
+			// Use Benders decomposition. The subproblems are solved with the
+			// capacities of the master problem, or with capacities closer to
+			// the incumbent ones (stabilization) until the gap is closed.
+			int OptCuts = 1, FeasCuts = 1, ncap = IdxCap.size;
+			bool stabilize = StabilizedBenders();
+			IloNum lower = -IloInfinity, upper = IloInfinity, radius = BendersTrustRadius, incumbentcost = 0, corecost = 0;
+			vector<IloNum> incumbent, core, paretocore;
+			
+			// Years that share an optimality cut, and capacities of each year
+			int groupsize = CutGroupSize(), ngroups = (nyears + groupsize - 1) / groupsize;
+			vector< vector<int> > capacities(nyears);
+			for (int i=0; i < ncap; ++i)
+				capacities[IdxCap.year[i]-1].push_back(i);
 			
 			while ((OptCuts+FeasCuts > 0) && (iter <= MAX_ITER)) {
 				++iter; OptCuts = 0; FeasCuts = 0;
 				
-				// Keep track of necessary cuts
-				bool status[nyears];
-				IloExprArray expr_cut(env, nyears);
-				
 				// Save master problem with added cuts
 				// cplex[0].exportModel("master.lp");
 				
@@ -112,82 +231,153 @@ void CPLEX::SolveIndividual(double *objective, const double events[], const bool
 				// Recover variables (first nyears are estimated obj. val)
 				StoreSolution(true);
 				
+				// The master problem is a relaxation, so it gives a lower bound.
+				// Its capacities and their cost (without the estimated costs) are
+				// the point where the subproblems are solved, unless stabilized.
+				IloNum previous = lower;
+				lower = cplex[0].getObjValue();
+				vector<IloNum> point(ncap);
+				IloNum pointcost = MasterPoint(point, lower);
+				
+				if (stabilize && (BendersMode == "trust") && !incumbent.empty()) {
+					// Box around the incumbent capacities
+					TrustRegionPoint(point, pointcost, incumbent, radius);
+				} else if (stabilize && (BendersMode == "level") && !incumbent.empty()) {
+					// Closest capacities to the incumbent ones below the level
+					LevelPoint(point, pointcost, incumbent, lower + BendersLevel * (upper - lower));
+				} else if (stabilize && (BendersMode == "inout")) {
+					// Point between the core and the master capacities. If the
+					// lower bound didn't improve, the master capacities are used.
+					if ((BendersCore == "incumbent") && !incumbent.empty()) {
+						core = incumbent;
+						corecost = incumbentcost;
+					}
+					if (core.empty()) {
+						core = point;
+						corecost = pointcost;
+					} else if (lower > previous) {
+						for (int i=0; i < ncap; ++i)
+							point[i] = BendersInOutWeight * core[i] + (1 - BendersInOutWeight) * point[i];
+						pointcost = BendersInOutWeight * corecost + (1 - BendersInOutWeight) * pointcost;
+					}
+					if (BendersCore != "incumbent") {
+						core = point;
+						corecost = pointcost;
+					}
+				}
+				for (int i=0; i < ncap; ++i)
+					solution[nyears + i] = point[i];
+				
 				// Store capacities as constraints
 				CapacityConstraints(events, 0, nyears);
 				
-				// Start subproblems
-				if (outputLevel < 2) cout << "- Solving subproblems" << endl << "  ";
+				// Core point of the Pareto-optimal cuts: halfway between the
+				// previous one and the capacities of the subproblems
+				vector<IloNum> paretocaps;
+				if (useParetoCuts && !paretocore.empty()) {
+					paretocaps.resize(ncap);
+					for (int i=0; i < ncap; ++i)
+						paretocaps[i] = events[i * (Nevents+1)] * paretocore[i];
+				}
+				
+				// Solve subproblems. Away from the master capacities, or if
+				// their cuts are aggregated, every feasible subproblem gives a cut.
+				if (outputLevel < 2) cout << "- Solving subproblems (" << SubproblemWorkerCount() << " at a time)" << endl << "  ";
+				vector<BendersCut> cuts, paretocuts;
+				SolveSubproblems(cuts, stabilize || (groupsize > 1), paretocaps, paretocuts);
+				if (useParetoCuts) {
+					if (paretocore.empty()) paretocore = point;
+					for (int i=0; i < ncap; ++i)
+						paretocore[i] = (paretocore[i] + point[i]) / 2;
+				}
 				
+				// Feasibility cuts of each year
+				string iteration = "_iter" + ToString<int>(BendersIterations + iter);
 				for (int j=1; j <= nyears; ++j) {
-					// Solve subproblem
-					cplex[j].solve();
-					
-					if (cplex[j].getCplexStatus() != CPX_STAT_OPTIMAL) {
-						// If subproblem is infeasible, create feasibility cut
-						++FeasCuts; status[j-1] = true;
-						
-						// Change solver properties to find dual unbouded ray
-						cplex[j].setParam(IloCplex::PreInd,0);
-						cplex[j].setParam(IloCplex::ScaInd,-1);
-						cplex[j].setParam(IloCplex::RootAlg, IloCplex::Primal);
-						cplex[j].solve();
-						
-						IloExpr temp(env); expr_cut[j-1] = temp;
-						cplex[j].getDuals(TempArray, rng[j]);
-						for (int k=0; k < TempArray.getSize(); ++k)
-							expr_cut[j-1] += TempArray[k] * rng[j][k].getUB();
-						cplex[j].getReducedCosts(TempNumArray[j-1], var[j]);
-						
+					if (cuts[j-1].type == CUT_FEASIBILITY) {
+						++FeasCuts;
+						IloExpr expr(env);
+						AddCutTerms(expr, cuts[j-1], capacities[j-1]);
+						AddMasterCut(expr, "Cut_y" + ToString<int>(j) + iteration);
+						expr.end();
 						if (outputLevel < 2) cout << j << " ";
-					} else if (solution[j-1] <= cplex[j].getObjValue() * 0.999) {
-						// If cost is underestimated, create optimality cut
-						++OptCuts; status[j-1] = true;
-						expr_cut[j-1] = - var[0][j-1];
-						cplex[j].getDuals(TempArray, rng[j]);
-						for (int k=0; k < TempArray.getSize(); ++k)
-							expr_cut[j-1] += TempArray[k] * rng[j][k].getUB();
-						cplex[j].getReducedCosts(TempNumArray[j-1], var[j]);
-						
-						if (outputLevel < 2) cout << "o" << j << " ";
-					} else {
-						status[j-1] = false;
 					}
 				}
 				
-				if (OptCuts+FeasCuts > 0) {
-					// Finalize cuts
-					vector<int> copied(nyears, 0);
-					for (int i=0; i < IdxCap.size; ++i) {
-						int year = IdxCap.year[i];
-						if (status[year-1])
-							expr_cut[year-1] += TempNumArray[year-1][copied[year-1]] * var[0][nyears + i];
-						++copied[year-1];
+				// Optimality cuts of each group of years, if all of them are
+				// feasible and the group's cost is underestimated (and the
+				// Pareto-optimal ones if all of them have one)
+				for (int g=0; g < ngroups; ++g) {
+					int first = g * groupsize + 1, last = (first + groupsize - 1 < nyears) ? first + groupsize - 1 : nyears;
+					bool feasible = true, needed = false, pareto = true;
+					IloNum estimated = 0, cost = 0;
+					for (int j=first; j <= last; ++j) {
+						if (cuts[j-1].type == CUT_FEASIBILITY) feasible = false;
+						if (cuts[j-1].type == CUT_OPTIMALITY) needed = true;
+						if (paretocuts[j-1].type != CUT_OPTIMALITY) pareto = false;
+						estimated += solution[j-1];
+						cost += cuts[j-1].cost;
 					}
+					if (!feasible || !needed || (!stabilize && (estimated > cost * (1 - BendersGap))))
+						continue;
 					
-					// Apply cuts to master
-					for (int j=1; j <= nyears; ++j) {
-						if (status[j-1]) {
-							MasterCuts.add(expr_cut[j-1] <= 0);
-							string constraintName = "Cut_y" + ToString<int>(j) + "_iter" + ToString<int>(iter);
-							MasterCuts[MasterCuts.getSize()-1].setName(constraintName.c_str());
-							model[0].add(MasterCuts[MasterCuts.getSize()-1]);
-						}
-						// Reset solver properties
-						if (cplex[j].getCplexStatus() != CPX_STAT_OPTIMAL) {
-							cplex[j].setParam(IloCplex::PreInd,1);
-							cplex[j].setParam(IloCplex::ScaInd,0);
-							cplex[j].setParam(IloCplex::RootAlg, IloCplex::Dual);
+					++OptCuts;
+					string name = ToString<int>(first) + ((last > first) ? "-" + ToString<int>(last) : "") + iteration;
+					IloExpr expr(env), paretoexpr(env);
+					for (int j=first; j <= last; ++j) {
+						expr -= Column(0, j-1);
+						AddCutTerms(expr, cuts[j-1], capacities[j-1]);
+						if (pareto) {
+							paretoexpr -= Column(0, j-1);
+							AddCutTerms(paretoexpr, paretocuts[j-1], capacities[j-1]);
 						}
 					}
-				} else {
+					AddMasterCut(expr, "Cut_y" + name);
+					if (pareto) AddMasterCut(paretoexpr, "Cut_p" + name);
+					expr.end();
+					paretoexpr.end();
+					if (outputLevel < 2) cout << (pareto ? "p" : "o") << name.substr(0, name.find('_')) << " ";
+				}
+				
+				if (OptCuts+FeasCuts == 0) {
 					// Store solution if optimal solution found
 					StoreSolution();
 					if (saveDual)
 						StoreDualSolution();
 				}
 				
+				// Upper bound if all the subproblems are feasible. Better
+				// capacities become the incumbent (and the trust region grows,
+				// or shrinks otherwise).
+				if (FeasCuts == 0) {
+					IloNum cost = pointcost;
+					for (int j=1; j <= nyears; ++j)
+						cost += cuts[j-1].cost;
+					if (cost < upper) {
+						upper = cost;
+						incumbent = point;
+						incumbentcost = pointcost;
+						radius *= 2;
+					} else {
+						radius /= 2;
+					}
+				} else if (!incumbent.empty()) {
+					radius /= 2;
+				}
+				
+				// Plain cutting planes once the gap is closed (without the rows
+				// of the level method, if the master problem is solved again)
+				IloNum gap = (upper < IloInfinity) ? (upper - lower) / ((fabs(upper) > 1) ? fabs(upper) : 1) : IloInfinity;
+				if (stabilize && (gap <= BendersGap)) {
+					stabilize = false;
+					if (OptCuts+FeasCuts > 0) RemoveLevelRows();
+				}
+				
 				if (outputLevel < 2) {
 					if (OptCuts+FeasCuts == 0) cout << "No cuts - Optimal solution found!";
+					cout << endl << "  LB: " << lower;
+					if (upper < IloInfinity)
+						cout << "  UB: " << upper << "  Gap: " << 100 * gap << "%";
 					cout << endl;
 				}
 			}
@@ -198,8 +388,16 @@ void CPLEX::SolveIndividual(double *objective, const double events[], const bool
 			} else {
 				optimal = false;
 			}
+			
+			BendersIterations += iter;
+			++BendersSolves;
 		}
 		
+		// Keep the bases for the next individuals (before the events change
+		// the subproblems)
+		if (optimal && (BasisStore > 0) && !BasisKey.empty())
+			StoreBases();
+		
 		if (!optimal) {
 			// Solution not found, return very large values
 			if (iter > MAX_ITER)
@@ -335,10 +533,13 @@ void CPLEX::SolveIndividual(double *objective, const double events[], const bool
 			}
 		}
 		
-		// Erase cuts created with Benders
+		// Keep the cuts created with Benders for the next problem (or erase
+		// them), once the master solution isn't needed anymore
 		if (useBenders) {
-			model[0].remove(MasterCuts);
-			MasterCuts.endElements();
+			UpdateCutPool(optimal);
+			RemoveLevelRows();
+			if (outputLevel < 2)
+				cout << "\tIterations: " << iter << " (" << MasterCuts.getSize() << " cuts in the pool)" << endl;
 		}
 		
 	} catch (IloException& e) {
@@ -357,11 +558,12 @@ void CPLEX::StoreSolution(bool onlymaster) {
 		if (!useBenders || onlymaster) {
 			// Only one file
 			cplex[0].getValues(solution, var[0]);
+			ExpandColumns(0, solution);
 		} else {
 			// Multiple files (Benders decomposition)
-			for (int i=0; i <= nyears; ++i) {
-				cplex[i].getValues(TempNumArray[i], var[i]);
-			}
+			vector< vector<double> > values(nyears+1);
+			for (int i=0; i <= nyears; ++i)
+				CopyValues(i, values[i], false);
 			
 			// The following array keeps track of what has already been copied
 			vector<int> position(nyears+1, 0);
@@ -370,47 +572,47 @@ void CPLEX::StoreSolution(bool onlymaster) {
 			// Recover capacities
 			for (int j = 0; j < IdxCap.size; ++j) {
 				int tempYear = IdxCap.year[j];
-				solution.add(TempNumArray[0][position[0]]);
+				solution.add(values[0][position[0]]);
 				++position[0]; ++position[tempYear];
 			}
 			
 			// Recover investments
 			for (int j = 0; j < IdxInv.size; ++j) {
-				solution.add(TempNumArray[0][position[0]]);
+				solution.add(values[0][position[0]]);
 				++position[0];
 			}
 			
 			// Recover sustainability metrics
 			for (int j = 0; j < IdxEm.size; ++j) {
 				int tempYear = IdxArc.year[j];
-				solution.add(TempNumArray[tempYear][position[tempYear]]);
+				solution.add(values[tempYear][position[tempYear]]);
 				++position[tempYear];
 			}
 			
 			// Recover reserve margin
 			for (int j = 0; j < IdxRm.size; ++j) {
-				solution.add(TempNumArray[0][position[0]]);
+				solution.add(values[0][position[0]]);
 				++position[0];
 			}
 			
 			// Recover flows
 			for (int j = 0; j < IdxArc.size; ++j) {
 				int tempYear = IdxArc.year[j];
-				solution.add(TempNumArray[tempYear][position[tempYear]]);
+				solution.add(values[tempYear][position[tempYear]]);
 				++position[tempYear];
 			}
 			
 			// Recover unserved demand
 			for (int j = 0; j < IdxUd.size; ++j) {
 				int tempYear = IdxUd.year[j];
-				solution.add(TempNumArray[tempYear][position[tempYear]]);
+				solution.add(values[tempYear][position[tempYear]]);
 				++position[tempYear];
 			}
 			
 			// Recover DC angles
 			for (int j = 0; j < IdxDc.size; ++j) {
 				int tempYear = IdxDc.year[j];
-				solution.add(TempNumArray[tempYear][position[tempYear]]);
+				solution.add(values[tempYear][position[tempYear]]);
 				++position[tempYear];
 			}
 		}
@@ -424,20 +626,22 @@ void CPLEX::StoreSolution(bool onlymaster) {
 // Store dual solution vector
 void CPLEX::StoreDualSolution() {
 	int nyears = SLength[0];
-	for (int i=0; i<Nevents; ++i)
+	for (unsigned int i=0; i < dualsolution.size(); ++i)
 		dualsolution[i].clear();
 	
 	try {
 		if (!useBenders) {
 			// Only one file
 			cplex[0].getDuals(TempArray, rng[0]);
+			ExpandRows(0, TempArray);
 			int start = IdxEm.size + IdxRm.size;
 			for (int i=0; i < IdxNode.size; ++i)
-				dualsolution[0].add(TempArray[start +i]);
+				dualsolution[0].push_back(TempArray[start +i]);
 		} else {
 			// Multiple files (Benders decomposition)
+			vector< vector<double> > values(nyears+1);
 			for (int i=1; i <= nyears; ++i)
-				cplex[i].getDuals(TempNumArray[i-1], rng[i]);
+				CopyValues(i, values[i], true);
 			
 			// The following array keeps track of what has already been copied
 			vector<int> position(nyears, SustMet.size());
@@ -445,7 +649,7 @@ void CPLEX::StoreDualSolution() {
 			// Recover nodal duals
 			for (int j = 0; j < IdxNode.size; ++j) {
 				int tempYear = IdxNode.year[j];
-				dualsolution[0].add(TempNumArray[tempYear-1][position[tempYear-1]]);
+				dualsolution[0].push_back(values[tempYear][position[tempYear-1]]);
 				++position[tempYear-1];
 			}
 		}
@@ -459,13 +663,12 @@ void CPLEX::StoreDualSolution() {
 void CPLEX::StoreDualSolution(int event, double *years) {
 	int nyears = SLength[0];
 	
+	dualsolution[event].clear();
+	
 	try {
-		for (int i=1; i <= nyears; ++i) {
-			if (years[i-1] == 1)
-				cplex[i].getDuals(TempNumArray[i-1], rng[i]);
-			else
-				TempNumArray[i-1].clear();
-		}
+		vector< vector<double> > values(nyears+1);
+		for (int i=1; i <= nyears; ++i)
+			if (years[i-1] == 1) CopyValues(i, values[i], true);
 		
 		// The following array keeps track of what has already been copied
 		vector<int> position(nyears, SustMet.size());
@@ -475,9 +678,9 @@ void CPLEX::StoreDualSolution(int event, double *years) {
 		for (int j = 0; j < IdxNode.size; ++j) {
 			int tempYear = IdxNode.year[j];
 			if (years[tempYear-1] == 1) {
-				dualsolution[event].add(TempNumArray[tempYear-1][position[tempYear-1]]);
+				dualsolution[event].push_back(values[tempYear][position[tempYear-1]]);
 			} else {
-				dualsolution[event].add(dualsolution[0][globalposition]);
+				dualsolution[event].push_back(dualsolution[0][globalposition]);
 			}
 			++position[tempYear-1]; ++globalposition;
 		}
@@ -495,7 +698,8 @@ void CPLEX::SolveProblem(double *x, double *objective, const double events[]) {
 	if (useBenders) inv += SLength[0];
 	
 	for (int i = 0; i < IdxNsga.size; ++i)
-		var[0][inv + i].setLB(x[i]);
+		Column(0, inv + i).setLB(x[i]);
+	BasisKey.assign(x, x + IdxNsga.size);
 	
 	// Solve problem
 	SolveIndividual(objective, events);
@@ -508,8 +712,9 @@ void CPLEX::ApplyMinInv(double *x) {
 	if (useBenders) inv += SLength[0];
 	
 	for (int i = 0; i < IdxNsga.size; ++i) {
-		var[0][inv + i].setLB(x[i]);
+		Column(0, inv + i).setLB(x[i]);
 	}
+	BasisKey.assign(x, x + IdxNsga.size);
 }
 
 // Provide solution as a string vector
@@ -523,11 +728,352 @@ vector<string> CPLEX::SolutionString() {
 // Provide dual solution as a string vector
 vector<string> CPLEX::SolutionDualString(int event) {
 	vector<string> solstring(0);
-	for (int i=0; i < dualsolution[event].getSize(); ++i)
+	for (unsigned int i=0; i < dualsolution[event].size(); ++i)
 		solstring.push_back(ToString<IloNum>(dualsolution[event][i]));
 	return solstring;
 }
 
+// Keeps the master cuts for the next problems solved, since they're still
+// valid when only the bounds of the investments change. Cuts that aren't
+// binding in the last master solution get older, and the ones older than
+// 'CutPoolAge' are removed, as well as the oldest ones if there are more than
+// 'CutPoolSize'. Without a pool, all the cuts are removed.
+void CPLEX::UpdateCutPool(const bool optimal) {
+	int ncuts = MasterCuts.getSize();
+	
+	try {
+		vector<bool> keep(ncuts, false);
+		if ((CutPoolSize > 0) && (ncuts > 0)) {
+			// Age the cuts with the duals of the master solution
+			if (optimal) {
+				IloNumArray duals(env, ncuts);
+				cplex[0].getDuals(duals, MasterCuts);
+				for (int k = 0; k < ncuts; ++k)
+					CutAge[k] = (fabs(duals[k]) > CUT_ACTIVE) ? 0 : CutAge[k] + 1;
+				duals.end();
+			}
+			
+			// Purge the cuts slack for too long, and then the oldest ones
+			// (slack for longer, or added earlier) that don't fit
+			vector< pair<int, int> > order;
+			for (int k = 0; k < ncuts; ++k)
+				if (CutAge[k] <= CutPoolAge) order.push_back(make_pair(-CutAge[k], k));
+			sort(order.begin(), order.end());
+			int excess = (int) order.size() - CutPoolSize;
+			for (int k = (excess > 0) ? excess : 0; k < (int) order.size(); ++k)
+				keep[order[k].second] = true;
+		}
+		
+		IloRangeArray remaining(env, 0), removed(env, 0);
+		vector<int> ages, ids;
+		for (int k = 0; k < ncuts; ++k) {
+			if (keep[k]) {
+				remaining.add(MasterCuts[k]);
+				ages.push_back(CutAge[k]);
+				ids.push_back(CutId[k]);
+			} else {
+				removed.add(MasterCuts[k]);
+			}
+		}
+		if (removed.getSize() > 0)
+			model[0].remove(removed);
+		removed.endElements();
+		removed.end();
+		MasterCuts.end();
+		MasterCuts = remaining;
+		CutAge = ages;
+		CutId = ids;
+	} catch (IloException& e) {
+		cerr << "Concert exception caught: " << e << endl;
+	} catch (...) {
+		cerr << "Unknown exception caught" << endl;
+	}
+}
+
+// Statuses of the columns and rows of problem i in its last solution, and
+// basis to start its next solve from. The rows of the master problem are
+// followed by the cuts in the pool.
+void CPLEX::SaveBasis(const int i, vector<char>& cols, vector<char>& rows) {
+	IloCplex::BasisStatusArray cstat(envs[i]), rstat(envs[i]);
+	IloRangeArray ranges(envs[i]);
+	ranges.add(rng[i]);
+	if (i == 0) ranges.add(MasterCuts);
+	cplex[i].getBasisStatuses(cstat, var[i], rstat, ranges);
+	cols.resize(cstat.getSize());
+	for (int k=0; k < cstat.getSize(); ++k)
+		cols[k] = (char) cstat[k];
+	rows.resize(rstat.getSize());
+	for (int k=0; k < rstat.getSize(); ++k)
+		rows[k] = (char) rstat[k];
+	ranges.end();
+	cstat.end();
+	rstat.end();
+}
+
+void CPLEX::LoadBasis(const int i, const vector<char>& cols, const vector<char>& rows) {
+	IloCplex::BasisStatusArray cstat(envs[i]), rstat(envs[i]);
+	for (unsigned int k=0; k < cols.size(); ++k)
+		cstat.add((IloCplex::BasisStatus) cols[k]);
+	for (unsigned int k=0; k < rows.size(); ++k)
+		rstat.add((IloCplex::BasisStatus) rows[k]);
+	IloRangeArray ranges(envs[i]);
+	ranges.add(rng[i]);
+	if (i == 0) ranges.add(MasterCuts);
+	cplex[i].setBasisStatuses(cstat, var[i], rstat, ranges);
+	ranges.end();
+	cstat.end();
+	rstat.end();
+}
+
+// Statuses of the rows of the master problem and of the cuts now in the pool
+// in a stored basis. Cuts added since then start with their slack basic,
+// which keeps the basis valid, as does purging cuts whose slack was basic.
+// If a purged cut was binding, the basis isn't valid anymore (false).
+bool CPLEX::MasterBasisRows(const StoredBasis& basis, vector<char>& rows) {
+	int nrows = rng[0].getSize(), ncuts = basis.cuts.size();
+	if ((int) basis.rows[0].size() != nrows + ncuts) return false;
+	
+	vector<bool> kept(ncuts, false);
+	rows.assign(basis.rows[0].begin(), basis.rows[0].begin() + nrows);
+	for (unsigned int k = 0; k < CutId.size(); ++k) {
+		int position = lower_bound(basis.cuts.begin(), basis.cuts.end(), CutId[k]) - basis.cuts.begin();
+		if ((position < ncuts) && (basis.cuts[position] == CutId[k])) {
+			rows.push_back(basis.rows[0][nrows + position]);
+			kept[position] = true;
+		} else {
+			rows.push_back((char) IloCplex::Basic);
+		}
+	}
+	for (int k = 0; k < ncuts; ++k)
+		if (!kept[k] && (basis.rows[0][nrows + k] != (char) IloCplex::Basic)) return false;
+	return true;
+}
+
+// Bases of the individual with the fewest minimum investments different from
+// the current one ('BasisKey'). The problems start from them with the dual
+// simplex, since only bounds have changed.
+void CPLEX::RestoreBases() {
+	int nearest = -1, distance = 0;
+	for (unsigned int b = 0; b < Bases.size(); ++b) {
+		int different = 0;
+		for (unsigned int k = 0; k < BasisKey.size(); ++k)
+			if ((k >= Bases[b].key.size()) || (fabs(Bases[b].key[k] - BasisKey[k]) > 1e-9)) ++different;
+		if ((nearest < 0) || (different < distance)) {
+			nearest = b;
+			distance = different;
+		}
+	}
+	if (nearest < 0) return;
+	
+	if (outputLevel < 2) cout << "- Starting from a stored basis (" << distance << " different investments)" << endl;
+	const StoredBasis& basis = Bases[nearest];
+	for (unsigned int i = 0; i < basis.cols.size(); ++i) {
+		if (basis.cols[i].empty()) continue;
+		vector<char> rows(basis.rows[i]);
+		if ((i == 0) && !MasterBasisRows(basis, rows)) {
+			if (outputLevel < 2) cout << "\tThe cut pool changed, the master problem starts without a basis" << endl;
+			continue;
+		}
+		LoadBasis(i, basis.cols[i], rows);
+		cplex[i].setParam(IloCplex::RootAlg, IloCplex::Dual);
+		LastBasis.cols[i] = basis.cols[i];
+		LastBasis.rows[i] = rows;
+	}
+}
+
+// Keeps the bases of the optimal solutions of the current individual, in
+// place of the ones of the same individual or else of the oldest ones
+void CPLEX::StoreBases() {
+	int nproblems = useBenders ? SLength[0] + 1 : 1, slot = -1;
+	for (unsigned int b = 0; b < Bases.size(); ++b)
+		if (Bases[b].key == BasisKey) slot = b;
+	if ((slot < 0) && ((int) Bases.size() < BasisStore)) {
+		slot = Bases.size();
+		Bases.push_back(StoredBasis());
+	} else if (slot < 0) {
+		slot = NextBasis;
+		NextBasis = (NextBasis + 1) % BasisStore;
+	}
+	
+	// The rows and columns of the level method aren't part of the stored
+	// bases, so the master problem isn't kept while they're in it
+	StoredBasis& basis = Bases[slot];
+	basis.key = BasisKey;
+	basis.cols.assign(nproblems, vector<char>(0));
+	basis.rows.assign(nproblems, vector<char>(0));
+	basis.cuts = CutId;
+	for (int i = (LevelDev.getSize() > 0) ? 1 : 0; i < nproblems; ++i)
+		SaveBasis(i, basis.cols[i], basis.rows[i]);
+}
+
+// Adds the terms of the cut of a subproblem to a master cut: its constant
+// and the costs of its capacities ('caps', positions in IdxCap). Capacities
+// removed from the master problem are constant.
+void CPLEX::AddCutTerms(IloExpr& expr, const BendersCut& cut, const vector<int>& caps) {
+	int nyears = SLength[0];
+	expr += cut.constant;
+	for (unsigned int k = 0; k < caps.size(); ++k) {
+		int i = caps[k];
+		int c = colmap[0].empty() ? nyears + i : colmap[0][nyears + i];
+		if (c >= 0)
+			expr += cut.costs[k] * var[0][c];
+		else
+			expr += cut.costs[k] * fixed[0][nyears + i];
+	}
+}
+
+void CPLEX::AddMasterCut(const IloExpr& expr, const string& name) {
+	MasterCuts.add(expr <= 0);
+	CutAge.push_back(0);
+	CutId.push_back(NextCutId++);
+	MasterCuts[MasterCuts.getSize()-1].setName(name.c_str());
+	model[0].add(MasterCuts[MasterCuts.getSize()-1]);
+}
+
+// Whether Benders decomposition is stabilized: box around the incumbent
+// capacities ("trust"), level method ("level") or in-out separation
+// ("inout"), or plain cutting planes ("kelley")
+bool CPLEX::StabilizedBenders() {
+	static bool warned = false;
+	if ((BendersMode == "trust") || (BendersMode == "level") || (BendersMode == "inout"))
+		return true;
+	if ((BendersMode != "kelley") && !warned) {
+		cout << "\tWarning: Unknown Benders mode '" << BendersMode << "', plain cutting planes are used" << endl;
+		warned = true;
+	}
+	return false;
+}
+
+// Capacities of the master solution (stored in 'solution') and their cost,
+// the objective without the estimated costs of the subproblems
+IloNum CPLEX::MasterPoint(vector<IloNum>& point, const IloNum objective) {
+	int nyears = SLength[0];
+	IloNum cost = objective;
+	for (int j=1; j <= nyears; ++j)
+		cost -= solution[j-1];
+	for (int i=0; i < IdxCap.size; ++i)
+		point[i] = solution[nyears + i];
+	return cost;
+}
+
+// Master solution inside a box around the incumbent capacities ('radius'
+// times each one, at least one unit, on each side). The point doesn't change
+// if it's already inside the box or the box makes the master infeasible.
+void CPLEX::TrustRegionPoint(vector<IloNum>& point, IloNum& cost, const vector<IloNum>& incumbent, const IloNum radius) {
+	int nyears = SLength[0], ncap = IdxCap.size;
+	vector<IloNum> width(ncap);
+	bool inside = true;
+	for (int i=0; i < ncap; ++i) {
+		width[i] = radius * ((fabs(incumbent[i]) > 1) ? fabs(incumbent[i]) : 1);
+		if (fabs(point[i] - incumbent[i]) > width[i]) inside = false;
+	}
+	if (inside) return;
+	
+	try {
+		// Capacities removed from the master problem are constant
+		vector<IloNum> lb(ncap), ub(ncap);
+		for (int i=0; i < ncap; ++i) {
+			int c = colmap[0].empty() ? nyears + i : colmap[0][nyears + i];
+			if (c < 0) continue;
+			lb[i] = var[0][c].getLB();
+			ub[i] = var[0][c].getUB();
+			var[0][c].setLB((incumbent[i] - width[i] > lb[i]) ? incumbent[i] - width[i] : lb[i]);
+			var[0][c].setUB((incumbent[i] + width[i] < ub[i]) ? incumbent[i] + width[i] : ub[i]);
+		}
+		
+		if (cplex[0].solve()) {
+			StoreSolution(true);
+			cost = MasterPoint(point, cplex[0].getObjValue());
+		}
+		
+		for (int i=0; i < ncap; ++i) {
+			int c = colmap[0].empty() ? nyears + i : colmap[0][nyears + i];
+			if (c < 0) continue;
+			var[0][c].setLB(lb[i]);
+			var[0][c].setUB(ub[i]);
+		}
+	} catch (IloException& e) {
+		cerr << "Concert exception caught: " << e << endl;
+	} catch (...) {
+		cerr << "Unknown exception caught" << endl;
+	}
+}
+
+// Master solution closest to the incumbent capacities (sum of the absolute
+// differences) among the ones whose objective is at most 'level'. The rows
+// and columns it needs are added to the master problem the first time, and
+// they're free the rest of the time, until the stabilization ends.
+void CPLEX::LevelPoint(vector<IloNum>& point, IloNum& cost, const vector<IloNum>& incumbent, const IloNum level) {
+	int nyears = SLength[0], ncap = IdxCap.size;
+	
+	try {
+		if (LevelDev.getSize() == 0) {
+			IloExpr distance(env);
+			for (int i=0; i < ncap; ++i) {
+				int c = colmap[0].empty() ? nyears + i : colmap[0][nyears + i];
+				if (c < 0) continue;
+				IloNumVar plus(env, 0, IloInfinity), minus(env, 0, IloInfinity);
+				LevelDev.add(plus);
+				LevelDev.add(minus);
+				LevelRows.add(IloRange(env, 0, var[0][c] - plus + minus, 0));
+				distance += plus + minus;
+			}
+			LevelRow = IloRange(env, -IloInfinity, obj[0].getExpr(), IloInfinity, "Level");
+			LevelObj = IloMinimize(env, distance);
+			distance.end();
+			model[0].add(LevelDev);
+			model[0].add(LevelRows);
+			model[0].add(LevelRow);
+		}
+		
+		int k = 0;
+		for (int i=0; i < ncap; ++i) {
+			int c = colmap[0].empty() ? nyears + i : colmap[0][nyears + i];
+			if (c >= 0) LevelRows[k++].setBounds(incumbent[i], incumbent[i]);
+		}
+		LevelRow.setUB(level);
+		model[0].remove(obj[0]);
+		model[0].add(LevelObj);
+		
+		if (cplex[0].solve()) {
+			StoreSolution(true);
+			cost = MasterPoint(point, cplex[0].getValue(LevelRow.getExpr()));
+		}
+		
+		model[0].remove(LevelObj);
+		model[0].add(obj[0]);
+		LevelRow.setUB(IloInfinity);
+	} catch (IloException& e) {
+		cerr << "Concert exception caught: " << e << endl;
+	} catch (...) {
+		cerr << "Unknown exception caught" << endl;
+	}
+}
+
+// Removes the rows and columns of the level method from the master problem
+// (once the stabilization ends, and always before the next individual)
+void CPLEX::RemoveLevelRows() {
+	if (LevelDev.getSize() == 0) return;
+	
+	try {
+		model[0].remove(LevelRow);
+		model[0].remove(LevelRows);
+		model[0].remove(LevelDev);
+		LevelObj.end();
+		LevelRow.end();
+		LevelRows.endElements();
+		LevelRows.end();
+		LevelDev.endElements();
+		LevelDev.end();
+		LevelRows = IloRangeArray(env, 0);
+		LevelDev = IloNumVarArray(env, 0);
+	} catch (IloException& e) {
+		cerr << "Concert exception caught: " << e << endl;
+	} catch (...) {
+		cerr << "Unknown exception caught" << endl;
+	}
+}
+
 // Apply capacities from master to subproblems
 void CPLEX::CapacityConstraints(const double events[], const int event, const int offset) {
 	int nyears = SLength[0];
@@ -537,7 +1083,7 @@ void CPLEX::CapacityConstraints(const double events[], const int event, const in
 		for (int i=0; i < IdxCap.size; ++i) {
 			int year = IdxCap.year[i];
 			IloNum rhs = events[i * (Nevents+1) + event] * solution[offset + i];
-			var[year][copied[year-1]].setUB(rhs);
+			Column(year, copied[year-1]).setUB(rhs);
 			++copied[year-1];
 		}
 	} catch (IloException& e) {
@@ -547,6 +1093,208 @@ void CPLEX::CapacityConstraints(const double events[], const int event, const in
 	}
 }
 
+// Solve subproblem j and find its cut for the master problem, and the
+// Pareto-optimal one with the capacities of the core point if there's one.
+// It only uses the environment of the subproblem, so it can run in its own
+// thread.
+void CPLEX::SolveSubproblem(const int j, const IloNum estimate, BendersCut& cut, const vector<IloNum>& core, BendersCut& pareto) {
+	cut.type = CUT_NONE;
+	cut.constant = 0;
+	cut.cost = 0;
+	cut.costs.clear();
+	pareto = cut;
+	
+	try {
+		cplex[j].solve();
+		
+		if (cplex[j].getCplexStatus() != CPX_STAT_OPTIMAL) {
+			// If subproblem is infeasible, create feasibility cut
+			cut.type = CUT_FEASIBILITY;
+			
+			// Change solver properties to find dual unbouded ray
+			cplex[j].setParam(IloCplex::PreInd,0);
+			cplex[j].setParam(IloCplex::ScaInd,-1);
+			cplex[j].setParam(IloCplex::RootAlg, IloCplex::Primal);
+			cplex[j].solve();
+		} else {
+			cut.cost = cplex[j].getObjValue();
+			// If cost is underestimated, create optimality cut
+			if (estimate <= cut.cost * (1 - BendersGap)) cut.type = CUT_OPTIMALITY;
+			
+			// Keep the basis to start from it after a feasibility ray
+			if (BasisStore > 0)
+				SaveBasis(j, LastBasis.cols[j], LastBasis.rows[j]);
+		}
+		
+		if (cut.type != CUT_NONE)
+			SubproblemCut(j, cut);
+		
+		// Reset solver properties, and start the next solve from the last
+		// optimal basis instead of the one of the ray
+		if (cut.type == CUT_FEASIBILITY) {
+			cplex[j].setParam(IloCplex::PreInd,1);
+			cplex[j].setParam(IloCplex::ScaInd,0);
+			cplex[j].setParam(IloCplex::RootAlg, IloCplex::Dual);
+			if ((BasisStore > 0) && !LastBasis.cols[j].empty())
+				LoadBasis(j, LastBasis.cols[j], LastBasis.rows[j]);
+		}
+		
+		if ((cut.type == CUT_OPTIMALITY) && !core.empty())
+			ParetoCut(j, core, pareto);
+	} catch (IloException& e) {
+		cerr << "Concert exception caught: " << e << endl;
+	} catch (...) {
+		cerr << "Unknown exception caught" << endl;
+	}
+}
+
+// Constant and capacity costs of the cut of subproblem j, from the duals (or
+// the dual ray) of its last solution
+void CPLEX::SubproblemCut(const int j, BendersCut& cut) {
+	IloNumArray duals(envs[j]), costs(envs[j]);
+	cplex[j].getDuals(duals, rng[j]);
+	for (int k=0; k < duals.getSize(); ++k)
+		cut.constant += duals[k] * rng[j][k].getUB();
+	cplex[j].getReducedCosts(costs, var[j]);
+	ExpandColumns(j, costs, true);
+	cut.costs.resize(costs.getSize());
+	for (int k=0; k < costs.getSize(); ++k)
+		cut.costs[k] = costs[k];
+	duals.end();
+	costs.end();
+}
+
+// Pareto-optimal cut of subproblem j (Magnanti-Wong, with the independent
+// problem of Papadakos): the duals of the subproblem with the capacities of a
+// core point also give a valid cut, and a stronger one if the point is in
+// the interior. The capacities are restored and the subproblem is solved
+// again, so its solution is still the one of the master capacities.
+void CPLEX::ParetoCut(const int j, const vector<IloNum>& core, BendersCut& cut) {
+	vector<IloNum> bounds;
+	int copied = 0;
+	for (int i=0; i < IdxCap.size; ++i) {
+		if (IdxCap.year[i] != j) continue;
+		IloNumVar column = Column(j, copied++);
+		bounds.push_back(column.getUB());
+		column.setUB(core[i]);
+	}
+	
+	cplex[j].solve();
+	if (cplex[j].getCplexStatus() == CPX_STAT_OPTIMAL) {
+		cut.type = CUT_OPTIMALITY;
+		cut.cost = cplex[j].getObjValue();
+		SubproblemCut(j, cut);
+	}
+	
+	for (int k=0; k < copied; ++k)
+		Column(j, k).setUB(bounds[k]);
+	cplex[j].solve();
+}
+
+// Subproblems shared by the workers, taken in year order
+struct SubproblemJob {
+	CPLEX* problem;
+	vector<BendersCut>* cuts;
+	vector<BendersCut>* paretocuts;
+	const vector<IloNum>* estimates;
+	const vector<IloNum>* core;
+	int next;
+	pthread_mutex_t lock;
+};
+
+void* SolveSubproblemJobs(void* arg) {
+	SubproblemJob* job = (SubproblemJob*) arg;
+	for (;;) {
+		pthread_mutex_lock(&job->lock);
+		int j = ++job->next;
+		pthread_mutex_unlock(&job->lock);
+		if (j > (int) job->cuts->size()) break;
+		job->problem->SolveSubproblem(j, (*job->estimates)[j-1], (*job->cuts)[j-1], *job->core, (*job->paretocuts)[j-1]);
+	}
+	return NULL;
+}
+
+// Solve all the subproblems with the capacities in the solution. Each
+// worker solves one subproblem at a time; the cuts are kept by year, so
+// they're the same with any number of workers.
+void CPLEX::SolveSubproblems(vector<BendersCut>& cuts, const bool allcuts, const vector<IloNum>& core, vector<BendersCut>& paretocuts) {
+	int nyears = SLength[0];
+	vector<IloNum> estimates(nyears);
+	for (int j=1; j <= nyears; ++j)
+		estimates[j-1] = allcuts ? -IloInfinity : solution[j-1];
+	cuts.assign(nyears, BendersCut());
+	paretocuts.assign(nyears, BendersCut());
+	
+	SubproblemJob job;
+	job.problem = this;
+	job.cuts = &cuts;
+	job.paretocuts = &paretocuts;
+	job.estimates = &estimates;
+	job.core = &core;
+	job.next = 0;
+	pthread_mutex_init(&job.lock, NULL);
+	
+	int nthreads = SubproblemWorkerCount();
+	if (nthreads > 1) {
+		vector<pthread_t> threads(nthreads);
+		for (int i = 0; i < nthreads; ++i)
+			pthread_create(&threads[i], NULL, SolveSubproblemJobs, &job);
+		for (int i = 0; i < nthreads; ++i)
+			pthread_join(threads[i], NULL);
+	} else {
+		SolveSubproblemJobs(&job);
+	}
+	pthread_mutex_destroy(&job.lock);
+}
+
+// Values of the columns and rows of a reduced problem in the positions of the
+// full problem. Removed columns keep their fixed value (and no reduced cost),
+// and removed rows have no dual.
+void CPLEX::ExpandColumns(const int i, IloNumArray& values, const bool costs) {
+	if (colmap[i].empty()) return;
+	vector<IloNum> reduced(values.getSize());
+	for (unsigned int k = 0; k < reduced.size(); ++k)
+		reduced[k] = values[k];
+	values.clear();
+	for (unsigned int c = 0; c < colmap[i].size(); ++c) {
+		if (colmap[i][c] >= 0) values.add(reduced[colmap[i][c]]);
+		else values.add(costs ? 0 : fixed[i][c]);
+	}
+}
+
+void CPLEX::ExpandRows(const int i, IloNumArray& values) {
+	if (rowmap[i].empty()) return;
+	vector<IloNum> reduced(values.getSize());
+	for (unsigned int k = 0; k < reduced.size(); ++k)
+		reduced[k] = values[k];
+	values.clear();
+	for (unsigned int r = 0; r < rowmap[i].size(); ++r)
+		values.add((rowmap[i][r] >= 0) ? reduced[rowmap[i][r]] : 0);
+}
+
+// Values of the columns (or duals of the rows) of problem 'i' in the positions
+// of the full problem. They're read into an array of the environment of the
+// problem, which may be solved in another thread, and copied out of it.
+void CPLEX::CopyValues(const int i, vector<double>& values, const bool duals) {
+	IloNumArray temp(envs[i]);
+	if (duals) {
+		cplex[i].getDuals(temp, rng[i]);
+		ExpandRows(i, temp);
+	} else {
+		cplex[i].getValues(temp, var[i]);
+		ExpandColumns(i, temp);
+	}
+	values.resize(temp.getSize());
+	for (unsigned int k = 0; k < values.size(); ++k)
+		values[k] = temp[k];
+	temp.end();
+}
+
+// Columns changed by the solver are never removed from reduced problems
+IloNumVar CPLEX::Column(const int i, const int position) {
+	return colmap[i].empty() ? var[i][position] : var[i][colmap[i][position]];
+}
+
 double EmissionIndex(const IloNumArray& v, const int start) {
 	// This function calculates an emission index
 	double em_zero = v[start], max = v[start], min = v[start], reduction = 0.01 * v[start], increase = 0.01, sum = 0;
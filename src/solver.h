@@ -17,32 +17,100 @@ using namespace std;
 #include <stdlib.h> // May 26 2013
 #include <ilcplex/ilocplex.h>
 
+class ModelBuilder;
+
+// Types of cuts that a Benders subproblem can give
+#define CUT_NONE 0
+#define CUT_OPTIMALITY 1
+#define CUT_FEASIBILITY 2
+
+// Declares a structure with the cut that a Benders subproblem gives for the
+// master problem: its type, its constant (duals or dual ray times the
+// right-hand sides), the reduced costs of the subproblem columns (in the
+// positions of the full problem) and the cost of the subproblem
+struct BendersCut {
+	int type;
+	IloNum constant, cost;
+	vector<IloNum> costs;
+};
+
+// Declares a structure with a basis of each problem (statuses of their
+// columns and rows) and the minimum investments of the individual it belongs
+// to. The rows of the master problem are followed by the cuts in the pool,
+// whose ids are kept too.
+struct StoredBasis {
+	vector<double> key;
+	vector< vector<char> > cols, rows;
+	vector<int> cuts;
+};
+
 // Declares a structure to store and manipulate problem information
 struct CPLEX {
 	IloEnv env;
+	
+	// Environment of each problem: the master problem uses 'env' and each
+	// subproblem has its own, so they can be solved in different threads
+	vector<IloEnv> envs;
 	IloArray<IloModel> model;
 	IloArray<IloCplex> cplex;
 	IloArray<IloObjective> obj;
 	IloArray<IloNumVarArray> var;
 	IloArray<IloRangeArray> rng;
 	IloNumArray solution, TempArray;
-	IloArray<IloNumArray> dualsolution, TempNumArray;
 	
-	// Variable to store temporary master cuts
+	// Duals of the demand nodes without events (0) and in each event,
+	// copied out of the environments of the problems
+	vector< vector<double> > dualsolution;
+	
+	// Cuts added to the master problem. With a cut pool (CutPoolSize > 0)
+	// they're kept for the next problems, with the number of problems in a
+	// row in which each one wasn't binding, and an id (in the order they were
+	// added) to find them in the stored bases
 	IloRangeArray MasterCuts;
+	vector<int> CutAge, CutId;
+	int NextCutId;
+	
+	// Benders iterations and problems solved so far
+	int BendersIterations, BendersSolves;
+	
+	// Bases of the individuals solved before ('BasisStore' at most, the
+	// oldest one is replaced next), minimum investments of the current one
+	// and last optimal basis of each problem
+	vector<StoredBasis> Bases;
+	vector<double> BasisKey;
+	StoredBasis LastBasis;
+	int NextBasis;
 	
-	CPLEX(): env(), model(env, 0), cplex(env, 0), obj(env, 0), var(env, 0), rng(env, 0), solution(env, 0), dualsolution(env, 0),
-		MasterCuts(env, 0), TempArray(env, 0), TempNumArray(env, 0) {};
+	// Added to the master problem by the level method while the master is
+	// stabilized: deviations of the capacities from the incumbent ones (and
+	// the rows that define them), the master objective with a level as upper
+	// bound, and the distance to the incumbent capacities as objective
+	IloNumVarArray LevelDev;
+	IloRangeArray LevelRows;
+	IloRange LevelRow;
+	IloObjective LevelObj;
+	
+	// Postsolve maps of the problems read from reduced model files (empty if
+	// they weren't reduced), so solutions keep the positions of the full problems
+	vector< vector<int> > rowmap, colmap;
+	vector< vector<double> > fixed;
+	
+	CPLEX(): env(), model(env, 0), cplex(env, 0), obj(env, 0), var(env, 0), rng(env, 0), solution(env, 0),
+		MasterCuts(env, 0), TempArray(env, 0), NextCutId(0), BendersIterations(0), BendersSolves(0), NextBasis(0),
+		LevelDev(env, 0), LevelRows(env, 0) {};
 	
 	~CPLEX() {
 		// Remove optimization elements from memory
-		TempNumArray.end(); TempArray.end(); MasterCuts.end();
-		dualsolution.end(); solution.end(); rng.end(); var.end(); obj.end(); model.end(); cplex.end();
+		LevelRows.end(); LevelDev.end(); TempArray.end(); MasterCuts.end();
+		solution.end(); rng.end(); var.end(); obj.end(); model.end(); cplex.end();
+		for (unsigned int i = 1; i < envs.size(); ++i)
+			envs[i].end();
 		env.end();
 	};
 	
-	// Loads the problem from MPS files into memory
-	void LoadProblem();
+	// Loads the problem from binary model or MPS files into memory, or from
+	// the preprocessor model if one is given
+	void LoadProblem(const ModelBuilder* builder = NULL);
 	
 	// Solves current model
 	void SolveIndividual(double *objective, const double events[], const bool saveDual = false, string *returnString = NULL);
@@ -62,10 +130,63 @@ struct CPLEX {
 	vector<string> SolutionString();
 	vector<string> SolutionDualString(int event);
 	
+	// Save or load the basis of problem i (with the cuts in the pool for the
+	// master problem), and start from the bases of the closest individual
+	// solved before or keep the ones of the current one
+	void SaveBasis(const int i, vector<char>& cols, vector<char>& rows);
+	void LoadBasis(const int i, const vector<char>& cols, const vector<char>& rows);
+	bool MasterBasisRows(const StoredBasis& basis, vector<char>& rows);
+	void RestoreBases();
+	void StoreBases();
+	
+	// Age the master cuts with the last master solution (if it's optimal) and
+	// purge the ones that are slack for too long or don't fit in the pool
+	void UpdateCutPool(const bool optimal);
+	
 	// Apply capacities from master to subproblems
 	void CapacityConstraints(const double events[], const int event, const int offset);
+	
+	// Solve subproblem j and find its cut for the master problem (the
+	// estimated cost in the master is 'estimate'), and its Pareto-optimal
+	// cut with the capacities of a core point if there's one
+	void SolveSubproblem(const int j, const IloNum estimate, BendersCut& cut, const vector<IloNum>& core, BendersCut& pareto);
+	void SubproblemCut(const int j, BendersCut& cut);
+	void ParetoCut(const int j, const vector<IloNum>& core, BendersCut& cut);
+	
+	// Solve all the subproblems ('SubproblemWorkers' at the same time) and
+	// find their cuts, in year order (an optimality cut for every feasible
+	// one if 'allcuts')
+	void SolveSubproblems(vector<BendersCut>& cuts, const bool allcuts, const vector<IloNum>& core, vector<BendersCut>& paretocuts);
+	
+	// Add the terms of a subproblem cut (for the capacities in 'caps') to a
+	// master cut, and add a cut to the master problem
+	void AddCutTerms(IloExpr& expr, const BendersCut& cut, const vector<int>& caps);
+	void AddMasterCut(const IloExpr& expr, const string& name);
+	
+	// Stabilization of the master problem in Benders decomposition
+	// ('BendersMode'). The capacities of the master solution are the point
+	// where the subproblems are solved; with its cost without the estimated
+	// costs, the point can be moved inside a box around the incumbent
+	// capacities, or to the closest one to them whose objective is below a
+	// level.
+	bool StabilizedBenders();
+	IloNum MasterPoint(vector<IloNum>& point, const IloNum objective);
+	void TrustRegionPoint(vector<IloNum>& point, IloNum& cost, const vector<IloNum>& incumbent, const IloNum radius);
+	void LevelPoint(vector<IloNum>& point, IloNum& cost, const vector<IloNum>& incumbent, const IloNum level);
+	void RemoveLevelRows();
+	
+	// Values of the columns (or their reduced costs) and rows of problem i in
+	// the positions of the full problem (also copied out of its environment),
+	// and column in one of those positions
+	void ExpandColumns(const int i, IloNumArray& values, const bool costs = false);
+	void ExpandRows(const int i, IloNumArray& values);
+	void CopyValues(const int i, vector<double>& values, const bool duals);
+	IloNumVar Column(const int i, const int position);
 };
 
+// Write the solution in prepdata/post_*.csv
+void WritePostFiles(CPLEX& netplan);
+
 // Metrics
 double EmissionIndex(const IloNumArray& v, const int start);
 vector<double> SumByRow(const IloNumArray& v, Index Idx);
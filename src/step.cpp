@@ -10,20 +10,60 @@ using namespace std;
 #include <fstream>
 #include <string>
 #include <vector>
+#include <stdio.h>
 #include <stdlib.h> // May 26 2013
 #include "global.h"
 
-// Converts a string like 'y1m2' into the appropriate 'Step' (vector of integers)
-Step Str2Step(const string& mystep) {
-	Step output(0);
+// Tables derived from 'SLength' (see 'InitStepTables'):
+//   - PosSize[j]: number of positions taken by each value of level 'j' in 'Step2Pos'
+//   - ColBase[m] and ColNum[m]: first column and deepest level of the steps whose
+//     non-zero levels (after the first one) are given by the bits of 'm' in 'Step2Col'
+//   - ColStride[n][i]: columns taken by each value of level 'i' when the deepest is 'n'
+//   - StepNames: strings of all the steps up to 'SLength', by 'Step2Pos'
+//   - StepValues and StepHash: the same steps as parsed by 'Str2Step', and a
+//     hash table of their strings (open addressing, with the position of the
+//     step in each used bucket and -1 in the empty ones)
+static int PosSize[STEP_LEVELS];
+static int ColBase[1 << STEP_LEVELS], ColNum[1 << STEP_LEVELS];
+static int ColStride[STEP_LEVELS][STEP_LEVELS];
+static vector<string> StepNames;
+static vector<Step> StepValues;
+static vector<int> StepHash;
+
+// Largest number of steps whose strings are kept in 'StepNames'
+#define STEP_NAMES_MAX (1 << 20)
+
+// Builds the string of a 'Step' (such as 'y1m2')
+static string BuildStepStr(const Step& mystep) {
+	char output[16 * STEP_LEVELS];
+	int length = 0;
+	for (unsigned int k = 0; (k < SName.size()) && (k < STEP_LEVELS); k++) {
+		if (mystep[k] > 0) {
+			length += sprintf(output + length, "%c%d", SName[k], mystep[k]);
+		}
+	}
+	return string(output, length);
+}
+
+// Hash of the string of a step (FNV-1a)
+static unsigned int HashStepStr(const string& mystep) {
+	unsigned int output = 2166136261u;
+	for (unsigned int k = 0; k < mystep.size(); ++k)
+		output = (output ^ (unsigned char) mystep[k]) * 16777619u;
+	return output;
+}
+
+// Parses a string like 'y1m2' (levels that aren't found are 0, and the
+// first one is -1 if none is found)
+static Step ParseStep(const string& mystep) {
+	Step output(SName.size(), 0);
 	size_t found;
 	int zeros = 0;
-	for (unsigned int k = 0; k < SName.size(); k++) {
+	for (unsigned int k = 0; k < output.size(); k++) {
 		found = mystep.find(SName[k]);
 		if (found!=string::npos) {
-			output.push_back(atoi(mystep.substr(found+1).c_str()));
+			output[k] = atoi(mystep.c_str() + found + 1);
 		} else {
-			output.push_back(0);
 			++zeros;
 		}
 	}
@@ -33,16 +73,94 @@ Step Str2Step(const string& mystep) {
 	return output;
 }
 
-// Converts the appropriate 'Step' (vector of integers) into its corresponding string (such as 'y1m2')
-string Step2Str(const Step& mystep) {
-	string output = "";
-	char printstep[3];
-	for (unsigned int k=0; k < SName.size(); k++) {
-		if (mystep[k] > 0) {
-			output += SName.substr(k,1) + ToString<int>(mystep[k]);
+// Stores the strings of a step and all the steps that are below it
+static void NameSteps(Step& mystep, const unsigned int k) {
+	StepNames[Step2Pos(mystep)] = BuildStepStr(mystep);
+	if (k >= mystep.size()) return;
+	for (int i = 1; i <= SLength[k]; ++i) {
+		mystep[k] = i;
+		NameSteps(mystep, k+1);
+	}
+	mystep[k] = 0;
+}
+
+// Precompute the tables used by the step functions from 'SName' and 'SLength'
+void InitStepTables() {
+	int n = SLength.size();
+	if (SName.size() > STEP_LEVELS) printError("parameter", string("StepName"));
+
+	for (int j = 0; j < n; ++j) {
+		PosSize[j] = 1;
+		for (int k = n-1; k > j; k--)
+			PosSize[j] = PosSize[j] * SLength[k] + 1;
+	}
+
+	for (int mask = 0; mask < (1 << STEP_LEVELS); ++mask) {
+		int output = 1, num = 0;
+		for (int i = n-2; i >= 0; --i) {
+			if (mask & (1 << i)) {
+				output = 1 + output * SLength[i];
+				num++;
+			}
+		}
+		ColBase[mask] = output - 1;
+		ColNum[mask] = num;
+	}
+	for (int num = 0; num < n; ++num) {
+		for (int i = 0; i <= num; ++i) {
+			ColStride[num][i] = 1;
+			for (int k = i+1; k <= num; ++k) ColStride[num][i] *= SLength[k];
+		}
+	}
+
+	StepNames.clear();
+	if ((n > 0) && (Step2Pos(SLength) < STEP_NAMES_MAX)) {
+		StepNames.resize(Step2Pos(SLength) + 1);
+		Step temp(n, 0);
+		NameSteps(temp, 0);
+	}
+
+	// Strings of the steps back to steps: the table is only read afterwards,
+	// so threads can share it
+	StepValues.clear();
+	StepHash.clear();
+	if (!StepNames.empty()) {
+		StepValues.resize(StepNames.size());
+		unsigned int buckets = 1;
+		while (buckets < 2 * StepNames.size()) buckets *= 2;
+		StepHash.assign(buckets, -1);
+		for (unsigned int pos = 0; pos < StepNames.size(); ++pos) {
+			StepValues[pos] = ParseStep(StepNames[pos]);
+			unsigned int b = HashStepStr(StepNames[pos]) & (buckets - 1);
+			while (StepHash[b] >= 0) b = (b + 1) & (buckets - 1);
+			StepHash[b] = pos;
 		}
 	}
-	return output;
+}
+
+// Converts a string like 'y1m2' into the appropriate 'Step'.
+// Steps up to 'SLength' are found in the hash table, other strings are parsed.
+Step Str2Step(const string& mystep) {
+	if (!StepHash.empty()) {
+		unsigned int mask = StepHash.size() - 1, b = HashStepStr(mystep) & mask;
+		for (; StepHash[b] >= 0; b = (b + 1) & mask)
+			if (StepNames[StepHash[b]] == mystep) return StepValues[StepHash[b]];
+	}
+	return ParseStep(mystep);
+}
+
+// Converts the appropriate 'Step' into its corresponding string (such as 'y1m2').
+// Steps up to 'SLength' are taken from the table, other steps are built.
+string Step2Str(const Step& mystep) {
+	bool stored = !StepNames.empty() && (mystep.size() == SLength.size());
+	unsigned int j = 0;
+	for (; (j < mystep.size()) && (mystep[j] != 0); ++j)
+		stored = stored && (mystep[j] > 0) && (mystep[j] <= SLength[j]);
+	for (; j < mystep.size(); ++j)
+		stored = stored && (mystep[j] == 0);
+
+	if (stored) return StepNames[Step2Pos(mystep)];
+	return BuildStepStr(mystep);
 }
 
 // Given a 'Step', finds the next one
@@ -80,40 +198,27 @@ Step StepSum(const Step& a, const Step& b) {
 // Given a 'Step', it determines the column position (for reading properties).
 // It goes like this: 'const' 'y1' 'y1m1' 'y1m1h1' 'y1m1h2' ... 'y1m2' etc.
 int Step2Pos(const Step& mystep) {
-	int output = 0, temp_size;
-	unsigned int j = 0;
-	while ((j < mystep.size()) && (mystep[j] !=0)) {
-		temp_size = 1;
-		for (unsigned int k = mystep.size()-1; k > j; k--) {
-			temp_size = temp_size * SLength[k] + 1;
-		}
-		output += (mystep[j]-1) * temp_size + 1;
-		j++;
-	}
+	int output = 0;
+	for (unsigned int j = 0; (j < mystep.size()) && (mystep[j] != 0); j++)
+		output += (mystep[j]-1) * PosSize[j] + 1;
 	return output;
 }
 
 // Given a 'Step', it determines the column position (for writing output).
 // It goes like this: 'y1' 'y2' ... 'y1m1' 'y1m2' ... 'y1m1h1' 'y1m1h2' etc.
 int Step2Col(const Step& mystep) {
-	int output = 1, temp, num = 0;
-	for (int i = mystep.size()-2; i >= 0 ; --i) {
-		if (mystep[i+1] != 0) {
-			output = 1 + output * SLength[i];
-			num++;
-		}
-	}
-	output--;
-	for (unsigned int i = 0; i <= num; ++i) {
-		temp = 1;
-		for (unsigned int k = i+1; k <= num; ++k) temp = temp * SLength[k];
-		output += (mystep[i] - 1) * temp;
-	}
+	int mask = 0;
+	for (int i = mystep.size()-2; i >= 0 ; --i)
+		if (mystep[i+1] != 0) mask |= (1 << i);
+
+	int output = ColBase[mask], num = ColNum[mask];
+	for (int i = 0; i <= num; ++i)
+		output += (mystep[i] - 1) * ColStride[num][i];
 	return output;
 }
 
 // Given a 'Step', find its length in hours, which is stored in the global variable StepHours
-string Step2Hours(const Step& mystep) {
+const string& Step2Hours(const Step& mystep) {
 	int idx;
 	if (mystep[SName.size()-1] != 0) {
 		idx = (SName.size() -1) + (mystep[SName.size()-1] - 1);
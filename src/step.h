@@ -8,12 +8,50 @@
 #ifndef _STEP_H_
 #define _STEP_H_
 
-typedef vector<int> Step;
+// Maximum number of levels in a step (such as 'ymh' for years, months and hours)
+#define STEP_LEVELS 4
 
-// Converts a string like 'y1m2' into the appropriate 'Step' (vector of integers)
+// Declare class type to store a step such as 'y1m2' (one integer for each level).
+// The levels are kept in a fixed array, so steps are copied and compared
+// without allocating memory. Steps are compared level by level, like vectors.
+class Step {
+	public:
+		Step() : levels(0) {
+			for (int k = 0; k < STEP_LEVELS; ++k) level[k] = 0;
+		}
+		Step(const int mylevels, const int value = 0) : levels(mylevels < STEP_LEVELS ? mylevels : STEP_LEVELS) {
+			for (int k = 0; k < STEP_LEVELS; ++k) level[k] = (k < levels) ? value : 0;
+		}
+
+		int& operator[](const int k) { return level[k]; }
+		const int& operator[](const int k) const { return level[k]; }
+		unsigned int size() const { return levels; }
+
+		bool operator<(const Step& rhs) const {
+			int n = (levels < rhs.levels) ? levels : rhs.levels;
+			for (int k = 0; k < n; ++k)
+				if (level[k] != rhs.level[k]) return level[k] < rhs.level[k];
+			return levels < rhs.levels;
+		}
+		bool operator>(const Step& rhs) const { return rhs < *this; }
+		bool operator<=(const Step& rhs) const { return !(rhs < *this); }
+		bool operator>=(const Step& rhs) const { return !(*this < rhs); }
+		bool operator==(const Step& rhs) const { return !(*this < rhs) && !(rhs < *this); }
+		bool operator!=(const Step& rhs) const { return !(*this == rhs); }
+
+	private:
+		int level[STEP_LEVELS];
+		int levels;
+};
+
+// Precompute the tables used by the functions below from 'SName' and 'SLength'
+// (it must be called once the parameters are read, and before starting threads)
+void InitStepTables();
+
+// Converts a string like 'y1m2' into the appropriate 'Step'
 Step Str2Step(const string& mystep);
 
-// Converts the appropriate 'Step' (vector of integers) into its corresponding string (such as 'y1m2')
+// Converts the appropriate 'Step' into its corresponding string (such as 'y1m2')
 string Step2Str(const Step& mystep);
 
 // Given a 'Step', finds the next one
@@ -31,6 +69,6 @@ int Step2Pos(const Step& mystep);
 int Step2Col(const Step& mystep);
 
 // Given a 'Step', find its length in hours, which is stored in the global variable StepHours
-string Step2Hours(const Step& mystep);
+const string& Step2Hours(const Step& mystep);
 
 #endif  // _STEP_H_
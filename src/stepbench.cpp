@@ -0,0 +1,119 @@
+// --------------------------------------------------------------
+//    NETSCORE Version 2
+//    stepbench.cpp -- Microbenchmark of the step functions
+//    2009-2011 (c) Eduardo Ibanez
+//    2011-2014 (c) Venkat Krishnan
+// --------------------------------------------------------------
+
+// Walks all the steps of a horizon (y40m12h24 by default) several times and
+// measures the time of each step function per call. 'Str2Step' is measured
+// on the strings of the horizon, which are found in the hash table, and on
+// the strings of the steps of the next horizon ('y41' to 'y80'), which are
+// parsed, to show the gain of the table. The checksum must not change
+// between versions of the functions.
+//
+//    stepbench [--length y40m12h24] [--repeat N]
+
+using namespace std;
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include "netscore.h"
+#include "profile.h"
+
+// Time per call in nanoseconds
+static double PerCall(const double wall, const long calls) {
+	return (calls > 0) ? 1e9 * wall / calls : 0;
+}
+
+int main(int argc, char* argv[]) {
+	string length = "y40m12h24";
+	int repeat = 20;
+	for (int a = 1; a < argc; ++a) {
+		string option = argv[a];
+		if ((option == "--length") && (a + 1 < argc)) length = argv[++a];
+		else if ((option == "--repeat") && (a + 1 < argc)) repeat = atoi(argv[++a]);
+		else cout << "\tWarning: Unknown option '" << option << "' is ignored\n";
+	}
+
+	// Same step parameters as 'ReadParameters' (one hour per step)
+	SName = "ymh";
+	SLength = Str2Step(length);
+	if (SLength[0] <= 0) {
+		printError("parameter", string("StepLength"));
+		return 1;
+	}
+	int laststep = SLength[SName.size()-1], temp_hour = laststep;
+	for (int i = 0; i < laststep; ++i)
+		StepHours.push_back("1");
+	for (int j = SName.size()-2; j >= 0; --j) {
+		StepHours.insert(StepHours.begin(), ToString<int>(temp_hour));
+		temp_hour = temp_hour * SLength[j];
+	}
+	InitStepTables();
+
+	// Steps of the deepest level in the horizon, and strings of the same
+	// steps in the horizon and in the next one
+	vector<Step> steps;
+	vector<string> inside, outside;
+	Step first(SName.size(), 1), last = SLength;
+	for (Step s = first; s <= last; s = NextStep(s)) {
+		steps.push_back(s);
+		inside.push_back(Step2Str(s));
+		Step next = s;
+		next[0] += SLength[0];
+		outside.push_back(Step2Str(next));
+	}
+	long calls = (long) repeat * steps.size(), checksum = 0;
+	cout << "- " << steps.size() << " steps in '" << length << "', " << repeat << " times\n\n";
+	printf("function                ns/call\n");
+
+	double wall = WallTime();
+	for (int r = 0; r < repeat; ++r)
+		for (unsigned int k = 0; k < steps.size(); ++k) checksum += NextStep(steps[k])[SName.size()-1];
+	printf("NextStep             %10.1f\n", PerCall(WallTime() - wall, calls));
+
+	wall = WallTime();
+	for (int r = 0; r < repeat; ++r)
+		for (unsigned int k = 0; k < steps.size(); ++k) checksum += Step2Pos(steps[k]);
+	printf("Step2Pos             %10.1f\n", PerCall(WallTime() - wall, calls));
+
+	wall = WallTime();
+	for (int r = 0; r < repeat; ++r)
+		for (unsigned int k = 0; k < steps.size(); ++k) checksum += Step2Col(steps[k]);
+	printf("Step2Col             %10.1f\n", PerCall(WallTime() - wall, calls));
+
+	wall = WallTime();
+	for (int r = 0; r < repeat; ++r)
+		for (unsigned int k = 0; k < steps.size(); ++k) checksum += Step2Str(steps[k]).size();
+	printf("Step2Str             %10.1f\n", PerCall(WallTime() - wall, calls));
+
+	wall = WallTime();
+	for (int r = 0; r < repeat; ++r)
+		for (unsigned int k = 0; k < steps.size(); ++k) checksum += Step2Hours(steps[k]).size();
+	printf("Step2Hours           %10.1f\n", PerCall(WallTime() - wall, calls));
+
+	wall = WallTime();
+	for (int r = 0; r < repeat; ++r)
+		for (unsigned int k = 0; k < inside.size(); ++k) checksum += Str2Step(inside[k])[SName.size()-1];
+	printf("Str2Step (table)     %10.1f\n", PerCall(WallTime() - wall, calls));
+
+	wall = WallTime();
+	for (int r = 0; r < repeat; ++r)
+		for (unsigned int k = 0; k < outside.size(); ++k) checksum += Str2Step(outside[k])[SName.size()-1];
+	printf("Str2Step (parsed)    %10.1f\n", PerCall(WallTime() - wall, calls));
+
+	// Both ways of 'Str2Step' must give back the steps
+	for (unsigned int k = 0; k < steps.size(); ++k) {
+		Step next = steps[k];
+		next[0] += SLength[0];
+		if ((Str2Step(inside[k]) != steps[k]) || (Str2Step(outside[k]) != next)) {
+			cout << "\tERROR: Step '" << inside[k] << "' isn't read back\n";
+			return 1;
+		}
+	}
+	cout << "\n- Checksum " << checksum << "\n";
+	return 0;
+}
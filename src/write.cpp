@@ -10,10 +10,17 @@ using namespace std;
 #include <fstream>
 #include <string>
 #include <vector>
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
+#include <zlib.h>
 #include "global.h"
 #include "node.h"
 #include "arc.h"
+#include "network.h"
+#include "model.h"
 #include "index.h"
+#include "write.h"
 
 // Write data from an array of values
 void WriteOutput(const char* fileinput, Index& idx, vector<string>& values, const string& header) {
@@ -93,8 +100,8 @@ void WriteOutput(const char* fileinput, Index& idx, vector<string>& values, cons
 	myfile.close();
 }
 
-// Write data output for a collection of nodes
-void WriteOutput(const char* fileinput, Index& idx, vector<Node>& Nodes, const string& selector, const string& header) {
+// Write data output for a table of nodes
+void WriteOutput(const char* fileinput, Index& idx, const NodeTable& Nodes, const string& selector, const string& header) {
 	vector<string> values(0);
 	for (int i = 0; i < idx.size; ++i)
 		values.push_back(Nodes[i].Get(selector));
@@ -102,11 +109,201 @@ void WriteOutput(const char* fileinput, Index& idx, vector<Node>& Nodes, const s
 	WriteOutput(fileinput, idx, values, header);
 }
 
-// Write data output for a collection of arcs
-void WriteOutput(const char* fileinput, Index& idx, vector<Arc>& Arcs, const string& selector, const string& header) {
+// Write data output for a table of arcs
+void WriteOutput(const char* fileinput, Index& idx, const ArcTable& Arcs, const string& selector, const string& header) {
 	vector<string> values(0);
 	for (int i = 0; i < idx.size; ++i)
 		values.push_back(Arcs[i].Get(selector));
 	
 	WriteOutput(fileinput, idx, values, header);
 }
+
+// Size of the output buffer
+#define WRITE_BUFFER_SIZE (1 << 20)
+
+// Contructor and destructor for the FileWriter class
+FileWriter::FileWriter() :
+	plainfile(NULL),
+	gzipfile(NULL),
+	buffer(WRITE_BUFFER_SIZE),
+	used(0) {}
+
+FileWriter::~FileWriter() {
+	Close();
+}
+
+// Open a file for writing (compressed if the name ends with '.gz')
+bool FileWriter::Open(const string& fileinput) {
+	Close();
+	if ((fileinput.size() > 3) && (fileinput.compare(fileinput.size() - 3, 3, ".gz") == 0))
+		gzipfile = gzopen(fileinput.c_str(), "wb1");
+	else
+		plainfile = fopen(fileinput.c_str(), "wb");
+	return (plainfile != NULL) || (gzipfile != NULL);
+}
+
+// Write what is left in the buffer and close the file
+void FileWriter::Close() {
+	Flush();
+	if (plainfile != NULL) fclose(plainfile);
+	if (gzipfile != NULL) gzclose((gzFile) gzipfile);
+	plainfile = NULL;
+	gzipfile = NULL;
+}
+
+FileWriter& FileWriter::operator<<(const string& input) {
+	Append(input.data(), input.size());
+	return *this;
+}
+
+FileWriter& FileWriter::operator<<(const char* input) {
+	Append(input, strlen(input));
+	return *this;
+}
+
+FileWriter& FileWriter::operator<<(const char input) {
+	Append(&input, 1);
+	return *this;
+}
+
+// Numbers are written with the same format as 'Num2Str'
+FileWriter& FileWriter::operator<<(const double input) {
+	if (used + 32 > buffer.size()) Flush();
+	used += Num2Chars(&buffer[used], input);
+	return *this;
+}
+
+void FileWriter::Append(const char* input, const size_t length) {
+	if (used + length > buffer.size()) {
+		Flush();
+		if (length > buffer.size()) {
+			// Too long for the buffer, it goes straight to the file
+			if (plainfile != NULL) fwrite(input, 1, length, plainfile);
+			if (gzipfile != NULL) gzwrite((gzFile) gzipfile, input, length);
+			return;
+		}
+	}
+	memcpy(&buffer[used], input, length);
+	used += length;
+}
+
+void FileWriter::Flush() {
+	if (used == 0) return;
+	if (plainfile != NULL) fwrite(&buffer[0], 1, used, plainfile);
+	if (gzipfile != NULL) gzwrite((gzFile) gzipfile, &buffer[0], used);
+	used = 0;
+}
+
+
+// Functions to write one element of a block of the model and return the
+// number of lines ('dropped' rows aren't written, and neither are their
+// entries and right-hand sides)
+int WriteRow(FileWriter& myfile, const ModelBuilder& model, const int b, const int k, const vector<bool>& dropped) {
+	const ModelBlock& mb = model.blocks[b];
+	if (dropped[mb.row[k]]) return 0;
+	myfile << " " << mb.rowtype[k] << " " << model.rownames[mb.row[k]] << "\n";
+	return 1;
+}
+
+int WriteColumn(FileWriter& myfile, const ModelBuilder& model, const int b, const int k, const vector<bool>& dropped) {
+	const ModelBlock& mb = model.blocks[b];
+	const string& name = model.colnames[mb.col[k]];
+	int lines = 0;
+	for (int e = mb.start[k]; e < mb.start[k+1]; ++e) {
+		if (dropped[mb.entryrow[e]]) continue;
+		myfile << "    " << name << " " << model.rownames[mb.entryrow[e]] << " " << mb.entryvalue[e] << "\n";
+		++lines;
+	}
+	return lines;
+}
+
+int WriteRhs(FileWriter& myfile, const ModelBuilder& model, const int b, const int k, const vector<bool>& dropped) {
+	const ModelBlock& mb = model.blocks[b];
+	if (dropped[mb.rhsrow[k]]) return 0;
+	myfile << " rhs " << model.rownames[mb.rhsrow[k]] << " " << mb.rhsvalue[k] << "\n";
+	return 1;
+}
+
+int WriteBound(FileWriter& myfile, const ModelBuilder& model, const int b, const int k) {
+	const ModelBlock& mb = model.blocks[b];
+	myfile << ((mb.boundtype[k] == 'L') ? " LO bnd " : " UP bnd ") << model.colnames[mb.boundcol[k]] << " " << mb.boundvalue[k] << "\n";
+	return 1;
+}
+
+// Write the model in MPS format (one Benders block, or the full model if 'block' is -1).
+// The first free row is the objective and the other free rows are dropped,
+// since CPLEX would drop them when it reads the file. Each section is a
+// phase of the profiler, with the lines written.
+void WriteMPS(FileWriter& myfile, const ModelBuilder& model, const int block) {
+	vector< pair<int, int> > rows(model.fullrows);
+	if (block >= 0) {
+		rows.clear();
+		for (unsigned int k = 0; k < model.blocks[block].row.size(); ++k)
+			rows.push_back(make_pair(block, k));
+	}
+	vector<bool> dropped(model.rownames.size(), false);
+	bool objective = false;
+	for (unsigned int i = 0; i < rows.size(); ++i) {
+		const ModelBlock& mb = model.blocks[rows[i].first];
+		if (mb.rowtype[rows[i].second] != 'N') continue;
+		if (objective) dropped[mb.row[rows[i].second]] = true;
+		objective = true;
+	}
+	
+	myfile << "NAME\n";
+	myfile << "ROWS\n";
+	Profile.Start("mps rows");
+	int lines = 0;
+	for (unsigned int i = 0; i < rows.size(); ++i)
+		lines += WriteRow(myfile, model, rows[i].first, rows[i].second, dropped);
+	Profile.Stop(lines);
+	
+	myfile << "COLUMNS\n";
+	Profile.Start("mps columns");
+	lines = 0;
+	if (block < 0) {
+		for (unsigned int i = 0; i < model.fullcols.size(); ++i)
+			lines += WriteColumn(myfile, model, model.fullcols[i].first, model.fullcols[i].second, dropped);
+	} else {
+		for (unsigned int k = 0; k < model.blocks[block].col.size(); ++k)
+			lines += WriteColumn(myfile, model, block, k, dropped);
+	}
+	Profile.Stop(lines);
+	
+	myfile << "RHS\n";
+	Profile.Start("mps rhs");
+	lines = 0;
+	if (block < 0) {
+		for (unsigned int i = 0; i < model.fullrhs.size(); ++i)
+			lines += WriteRhs(myfile, model, model.fullrhs[i].first, model.fullrhs[i].second, dropped);
+	} else {
+		for (unsigned int k = 0; k < model.blocks[block].rhsrow.size(); ++k)
+			lines += WriteRhs(myfile, model, block, k, dropped);
+	}
+	Profile.Stop(lines);
+	
+	myfile << "BOUNDS\n";
+	Profile.Start("mps bounds");
+	lines = 0;
+	if (block < 0) {
+		for (unsigned int i = 0; i < model.fullbounds.size(); ++i)
+			lines += WriteBound(myfile, model, model.fullbounds[i].first, model.fullbounds[i].second);
+	} else {
+		for (unsigned int k = 0; k < model.blocks[block].boundcol.size(); ++k)
+			lines += WriteBound(myfile, model, block, k);
+	}
+	Profile.Stop(lines);
+	
+	myfile << "ENDATA";
+}
+
+// Write the model in binary format (one Benders block, or the full model if 'block' is -1)
+void WriteModelFile(const char* fileinput, const ModelBuilder& model, const int block) {
+	ModelFile binary;
+	binary.Build(model, block, useModelReduction);
+	
+	ofstream myfile;
+	myfile.open(fileinput, ios::out | ios::binary);
+	myfile.write(binary.Data(), binary.Size());
+	myfile.close();
+}
@@ -8,8 +8,42 @@
 #ifndef _WRITE_H_
 #define _WRITE_H_
 
+#include <stdio.h>
+
 void WriteOutput(const char* fileinput, Index& idx, vector<string>& values, const string& header);
-void WriteOutput(const char* fileinput, Index& idx, vector<Node>& Nodes, const string& selector, const string& header);
-void WriteOutput(const char* fileinput, Index& idx, vector<Arc>& Arcs, const string& selector, const string& header);
+void WriteOutput(const char* fileinput, Index& idx, const NodeTable& Nodes, const string& selector, const string& header);
+void WriteOutput(const char* fileinput, Index& idx, const ArcTable& Arcs, const string& selector, const string& header);
+
+// Declare class type to write large text files through one big buffer, so
+// lines are copied once and numbers are formatted in place. Files whose name
+// ends with '.gz' are compressed with gzip.
+class FileWriter {
+	public:
+		FileWriter();
+		~FileWriter();
+		
+		bool Open(const string& fileinput);
+		void Close();
+		FileWriter& operator<<(const string& input);
+		FileWriter& operator<<(const char* input);
+		FileWriter& operator<<(const char input);
+		FileWriter& operator<<(const double input);
+	
+	private:
+		FileWriter(const FileWriter& rhs);
+		FileWriter& operator=(const FileWriter& rhs);
+		
+		void Append(const char* input, const size_t length);
+		void Flush();
+		
+		FILE* plainfile;
+		void* gzipfile;
+		vector<char> buffer;
+		size_t used;
+};
+
+// Write the model in MPS or binary format (one Benders block, or the full model if 'block' is -1)
+void WriteMPS(FileWriter& myfile, const ModelBuilder& model, const int block);
+void WriteModelFile(const char* fileinput, const ModelBuilder& model, const int block);
 
 #endif  // _WRITE_H_